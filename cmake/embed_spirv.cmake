@@ -0,0 +1,37 @@
+# 把一个 SPIR-V 文件转换为 C++ 头文件，其中是一个 constexpr uint32_t 数组
+# 用法：cmake -DSPIRV_FILE=<.spv> -DHEADER_FILE=<.h> -DVARIABLE_NAME=<数组名> -DSOURCE_NAME=<源文件名> -P embed_spirv.cmake
+
+file(READ "${SPIRV_FILE}" SPIRV_HEX HEX)
+string(LENGTH "${SPIRV_HEX}" SPIRV_HEX_LENGTH)
+math(EXPR SPIRV_REMAINDER "${SPIRV_HEX_LENGTH} % 8")
+if(SPIRV_HEX_LENGTH EQUAL 0 OR NOT SPIRV_REMAINDER EQUAL 0)
+    message(FATAL_ERROR "${SPIRV_FILE} is not a valid SPIR-V module")
+endif()
+
+# SPIR-V 按小端的 32 位字存储，每 4 个字节（8 个十六进制字符）反转字节序后得到一个字
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1," SPIRV_WORDS "${SPIRV_HEX}")
+# 每 8 个字换一行（CMake 的正则不支持 {n}，这里把子模式重复 8 次）
+set(WORD_PATTERN "")
+foreach(i RANGE 1 8)
+    string(APPEND WORD_PATTERN "0x[0-9a-f]+,")
+endforeach()
+string(REGEX REPLACE "(${WORD_PATTERN})" "\\1\n    " SPIRV_WORDS "${SPIRV_WORDS}")
+string(STRIP "${SPIRV_WORDS}" SPIRV_WORDS)
+
+string(TOUPPER "${VARIABLE_NAME}" GUARD_NAME)
+file(WRITE "${HEADER_FILE}.tmp"
+"// 由 cmake/embed_spirv.cmake 从 shaders/${SOURCE_NAME} 生成，不要手动修改
+#ifndef EMBEDDED_${GUARD_NAME}_H
+#define EMBEDDED_${GUARD_NAME}_H
+
+#include <cstdint>
+
+constexpr uint32_t ${VARIABLE_NAME}[] = {
+    ${SPIRV_WORDS}
+};
+
+#endif
+")
+# 内容不变时不改动头文件，避免不必要的重新编译
+configure_file("${HEADER_FILE}.tmp" "${HEADER_FILE}" COPYONLY)
+file(REMOVE "${HEADER_FILE}.tmp")
@@ -0,0 +1,52 @@
+#ifndef ASSET_STREAMING_H
+#define ASSET_STREAMING_H
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <chrono>
+#include <future>
+#include <vector>
+#include <string>
+
+#include "vertex_buffer.h"
+#include "texture.h"
+#include "scene.h"
+
+/*
+    Introduction：
+    原来的 initVulkan() 会同步地导入模型（OBJ 解析/顶点去重/LOD 生成）、解码纹理（stbi_load），再上传到 GPU，
+这期间窗口一直是黑的。这里把资源加载拆成两部分：
+    1、CPU 部分（解析、解码、生成 mip 链与块压缩）在 initVulkan() 一开始就交给后台线程执行，与实例/设备/管线的创建并行；
+    2、渲染循环先使用占位资源（立方体网格 + 1x1 白色纹理）绘制，每帧开始前检查后台任务，某项资源就绪后在渲染线程
+    中完成上传（Vulkan 的队列提交需要外部同步，上传统一放在渲染线程），然后替换掉对应的占位资源。
+    程序分别输出“首帧时间”（启动到第一帧呈现）和“完整画质时间”（启动到所有真实资源都参与绘制的第一帧呈现）。
+
+    替换资源前使用 vkDeviceWaitIdle() 等待 GPU 空闲，每项资源只会替换一次，这一次的停顿可以接受。
+*/
+
+extern const bool enableAssetStreaming;
+
+/**
+ *  启动后台加载任务（解析场景中的模型、解码并压缩纹理）
+ * */
+void startAssetStreaming();
+
+/**
+ *  检查后台任务，已就绪的资源上传到 GPU 并替换占位资源，每帧绘制前调用
+ * */
+void pollAssetStreaming();
+
+/**
+ *  阻塞等待所有后台任务完成并替换占位资源
+ * */
+void finishAssetStreaming();
+
+/**
+ *  每帧呈现后调用，用于统计首帧时间与完整画质时间
+ * */
+void onFramePresented();
+
+#endif
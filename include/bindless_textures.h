@@ -0,0 +1,76 @@
+#ifndef BINDLESS_TEXTURES_H
+#define BINDLESS_TEXTURES_H
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <cstdint>
+
+#include "logical_device_queue.h"
+
+/*
+    Introduction：
+    createDescriptorSets() 中每个描述符集只绑定一张纹理（textureImageView / textureSampler），场景中有多种材质、
+多张纹理之后，每种材质都要有自己的描述符集，绘制时在它们之间切换。开启 enableBindlessTextures 后：
+    1、所有纹理放在一个很大的纹理数组中（set 1，binding 0），整个程序只有一个这样的描述符集，每帧只绑定一次；
+    2、数组使用 PARTIALLY_BOUND（未写入的槽位只要不被访问就是合法的）与 UPDATE_AFTER_BIND（绑定之后仍然可以写入
+    新的纹理，只要写入时引用它的命令缓冲区不在执行中），新增纹理不需要重建描述符集或重新录制命令；
+    3、材质只记录它使用的纹理在数组中的下标，绘制时通过 push constants（DrawPushConstants::textureIndex）传给
+    片段着色器（fragment_shader.frag 以 -DBINDLESS_TEXTURES 编译的版本），切换材质不再需要绑定描述符集。
+
+    这依赖 1.2 核心中的描述符索引特性（原 VK_EXT_descriptor_indexing）：runtimeDescriptorArray、
+descriptorBindingPartiallyBound 与 descriptorBindingSampledImageUpdateAfterBind，以及 1.0 的
+shaderSampledImageArrayDynamicIndexing，设备不支持时仍然使用 set 0 中的单张纹理。数组大小为 BINDLESS_TEXTURE_CAPACITY
+与设备 update-after-bind 描述符上限中较小的一个。
+*/
+
+extern const bool enableBindlessTextures;       // 是否使用 bindless 纹理数组
+extern const uint32_t BINDLESS_TEXTURE_CAPACITY; // 纹理数组的最大大小
+extern const uint32_t BINDLESS_MAIN_TEXTURE;     // textureImageView / textureSampler 在纹理数组中的下标
+extern bool bindlessTexturesActive;              // 设备支持时为 true
+extern uint32_t bindlessTextureCapacity;         // 实际的纹理数组大小（受设备上限约束）
+
+extern VkDescriptorSetLayout bindlessDescriptorSetLayout; // 纹理数组的描述符布局（set 1）
+extern VkDescriptorSet bindlessDescriptorSet;             // 纹理数组的描述符集
+
+/**
+ *  创建纹理数组的描述符布局（需要在 createGraphicsPipeline() 之前调用）
+ * */
+void createBindlessTextureLayout();
+
+/**
+ *  创建纹理数组的描述符集，并写入当前的纹理（需要在 createTextureSampler() 之后调用）
+ * */
+void createBindlessTextureSet();
+
+/**
+ *  把一张纹理加入纹理数组，返回它的下标
+ * */
+uint32_t registerBindlessTexture(VkImageView imageView, VkSampler sampler);
+
+/**
+ *  写入纹理数组中的一个槽位（替换纹理时调用，调用前需要保证 GPU 不再使用这个槽位）
+ * */
+void writeBindlessTexture(uint32_t index, VkImageView imageView, VkSampler sampler);
+
+/**
+ *  新增一种材质，返回材质编号（ModelMesh::material）
+ * */
+uint32_t createBindlessMaterial(uint32_t textureIndex);
+
+/**
+ *  材质使用的纹理在纹理数组中的下标
+ * */
+uint32_t getMaterialTextureIndex(uint32_t material);
+
+/**
+ *  注销纹理数组的描述符池与描述符布局
+ * */
+void cleanupBindlessTextures();
+
+#endif
@@ -24,6 +24,9 @@
 #include <set>
 
 
+// 分配器只依赖 Vulkan 头文件，放在最前面，保证经由 command_buffer.h 循环包含回来的头文件中也能使用 MemoryAllocation
+#include "buffers/memory_allocator.h"
+
 #include "physical_device_queue.h"
 #include "logical_device_queue.h"
 
@@ -33,19 +36,19 @@
 
 
 /**
- *  在device上创建一个特定功用的buffer，并为其分配合适类型的内存空间
+ *  在device上创建一个特定功用的buffer，并从内存分配器中为其分配合适类型的内存空间
  * */
-void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &bufferMemory);
+void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, MemoryAllocation &bufferMemory);
 
 
 /**
- *  GPU上的buffer数据拷贝（device to device）
+ *  GPU上的buffer数据拷贝（device to device），提交后不等待完成
  * */
 void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
 
 
 /**
- *  找出当前buffer最合适的分配内存类型
+ *  找出当前buffer最合适的分配内存类型（使用缓存的内存属性）
  * */
 uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
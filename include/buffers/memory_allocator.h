@@ -0,0 +1,262 @@
+#ifndef MEMORY_ALLOCATOR_H
+#define MEMORY_ALLOCATOR_H
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Introduction：
+    之前 createBuffer()/createImage() 为每个资源单独调用一次 vkAllocateMemory。驱动对分配次数有上限
+（maxMemoryAllocationCount，很多设备只有 4096），单次分配本身也很慢，资源数量上来之后两者都会成为问题。
+
+    这里改为按内存类型一次申请较大的内存块（DEVICE_MEMORY_BLOCK_SIZE），资源在块内做子分配：
+    1、块内的空闲区间用 TLSF（Two-Level Segregated Fit）管理：一级按大小的二进制位数分类，二级把每一级再等分为
+    2^SL_BITS 份，两级各用一个位图记录哪些类别非空，查找/释放都是 O(1)；相邻的空闲区间在释放时立即合并；
+    2、bufferImageGranularity 大于 1 时，线性资源（buffer）与 optimal 图像放在不同的内存块中，二者永远不会在同一个
+    “页”内相邻，不需要额外的填充；
+    3、超过块大小一半的资源单独分配一块（dedicated），避免一个大资源撑出大量碎片；
+    4、HOST_VISIBLE 的块在创建时常驻映射，分配结果直接给出 CPU 地址（同一块 VkDeviceMemory 不能被映射两次）；
+    5、内存属性只在第一次使用时查询一次并缓存。
+
+    块的申请/释放/映射通过 DeviceMemoryCallbacks 注入，传入伪造的内存属性表与回调时不需要 Vulkan 设备即可单独验证
+分配逻辑。渲染器本身通过下面的全局函数使用同一个分配器，只能在渲染线程中调用。
+*/
+
+extern const VkDeviceSize DEVICE_MEMORY_BLOCK_SIZE; // 默认的内存块大小（小于 1GB 的堆使用堆大小的 1/8）
+extern const bool enableDeviceMemoryStats;          // 初始化完成后打印各内存类型的使用情况与碎片率
+
+/**
+ *  资源的排布方式：buffer 与线性图像为 Linear，optimal 图像为 Optimal（bufferImageGranularity 只约束二者相邻）
+ * */
+enum class ResourceTiling : uint32_t
+{
+    Linear = 0,
+    Optimal = 1,
+};
+
+/**
+ *  一次子分配的结果
+ * */
+struct MemoryAllocation
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE; // 所在的内存块
+    VkDeviceSize offset = 0;                // 在内存块中的偏移（bind 时使用）
+    VkDeviceSize size = 0;
+    void *mapped = nullptr;                 // HOST_VISIBLE 内存对应的 CPU 地址，否则为 nullptr
+    uint32_t pool = UINT32_MAX;             // 内部使用：所在的内存池、内存块与块内节点
+    uint32_t block = UINT32_MAX;
+    uint32_t node = UINT32_MAX;
+};
+
+/**
+ *  使用情况统计
+ * */
+struct MemoryStats
+{
+    uint32_t blockCount = 0;        // 内存块数（即 vkAllocateMemory 次数，包括 dedicated）
+    uint32_t dedicatedCount = 0;    // 其中 dedicated 分配的数量
+    uint32_t allocationCount = 0;   // 子分配数量
+    VkDeviceSize blockBytes = 0;    // 所有内存块的总大小
+    VkDeviceSize usedBytes = 0;     // 子分配占用的字节数
+    uint32_t freeRangeCount = 0;    // 空闲区间数
+    VkDeviceSize largestFreeRange = 0;
+
+    /**
+     *  碎片率：1 - 最大空闲区间 / 总空闲字节数（0 表示所有空闲空间连续）
+     * */
+    double fragmentation() const
+    {
+        VkDeviceSize freeBytes = blockBytes - usedBytes;
+        return freeBytes == 0 ? 0.0 : 1.0 - static_cast<double>(largestFreeRange) / static_cast<double>(freeBytes);
+    }
+};
+
+/**
+ *  单个内存块内的 TLSF 放置器，只记录区间，不涉及 Vulkan 对象
+ * */
+class TlsfBlock
+{
+public:
+    explicit TlsfBlock(VkDeviceSize size);
+
+    /**
+     *  分配 size 字节，起始位置按 alignment（2 的幂）对齐，空间不足时返回 false
+     * */
+    bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset, uint32_t &node);
+
+    /**
+     *  释放 allocate 返回的节点，并与相邻的空闲区间合并
+     * */
+    void free(uint32_t node);
+
+    VkDeviceSize size() const { return blockSize; }
+    VkDeviceSize usedBytes() const { return usedSize; }
+    uint32_t allocationCount() const { return usedCount; }
+    bool empty() const { return usedCount == 0; }
+
+    /**
+     *  把本块的空闲区间信息累加到 stats
+     * */
+    void addStats(MemoryStats &stats) const;
+
+private:
+    static const uint32_t SL_BITS = 5; // 二级分类数 2^5 = 32
+    static const uint32_t SL_COUNT = 1u << SL_BITS;
+    static const uint32_t FL_COUNT = 64;
+    static const uint32_t INVALID_NODE = UINT32_MAX;
+
+    struct Node
+    {
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        uint32_t prevPhysical = INVALID_NODE; // 地址上相邻的节点
+        uint32_t nextPhysical = INVALID_NODE;
+        uint32_t prevFree = INVALID_NODE;     // 同一类别的空闲链表
+        uint32_t nextFree = INVALID_NODE;
+        bool free = false;
+    };
+
+    static void mapping(VkDeviceSize size, uint32_t &fl, uint32_t &sl);
+    uint32_t findFree(VkDeviceSize size) const;
+    uint32_t findFreeInClass(VkDeviceSize size, VkDeviceSize alignment) const;
+    void insertFree(uint32_t node);
+    void removeFree(uint32_t node);
+    uint32_t createNode();
+    void releaseNode(uint32_t node);
+
+    VkDeviceSize blockSize;
+    VkDeviceSize usedSize = 0;
+    uint32_t usedCount = 0;
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> unusedNodes; // 可以复用的节点下标
+    uint64_t flBitmap = 0;
+    uint32_t slBitmap[FL_COUNT] = {};
+    uint32_t freeHeads[FL_COUNT][SL_COUNT];
+};
+
+/**
+ *  内存块的申请/释放/映射回调，默认实现直接调用 vkAllocateMemory/vkFreeMemory/vkMapMemory
+ * */
+struct DeviceMemoryCallbacks
+{
+    std::function<VkResult(uint32_t memoryTypeIndex, VkDeviceSize size, VkDeviceMemory &memory)> allocate;
+    std::function<void(VkDeviceMemory memory)> free;
+    std::function<void *(VkDeviceMemory memory, VkDeviceSize size)> map; // 失败时返回 nullptr
+};
+
+/**
+ *  按内存类型管理内存块并在块内子分配
+ * */
+class DeviceMemoryAllocator
+{
+public:
+    DeviceMemoryAllocator(const VkPhysicalDeviceMemoryProperties &memoryProperties,
+                          VkDeviceSize bufferImageGranularity,
+                          const DeviceMemoryCallbacks &callbacks,
+                          VkDeviceSize preferredBlockSize = DEVICE_MEMORY_BLOCK_SIZE);
+    ~DeviceMemoryAllocator();
+
+    DeviceMemoryAllocator(const DeviceMemoryAllocator &) = delete;
+    DeviceMemoryAllocator &operator=(const DeviceMemoryAllocator &) = delete;
+
+    /**
+     *  在 typeFilter 允许的内存类型中找出第一个满足 properties 的，找不到时抛出 std::runtime_error
+     * */
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+    /**
+     *  按内存需求分配，失败时抛出 std::runtime_error
+     * */
+    MemoryAllocation allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties, ResourceTiling tiling);
+
+    /**
+     *  释放分配（之后 allocation 被重置为空）
+     * */
+    void free(MemoryAllocation &allocation);
+
+    /**
+     *  某个内存类型（memoryTypeIndex 为 UINT32_MAX 时为全部）的统计信息
+     * */
+    MemoryStats getStats(uint32_t memoryTypeIndex = UINT32_MAX) const;
+
+    const VkPhysicalDeviceMemoryProperties &getMemoryProperties() const { return memoryProperties; }
+
+private:
+    struct MemoryBlock
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint8_t *mapped = nullptr;
+        bool dedicated = false;
+        TlsfBlock placement;
+
+        explicit MemoryBlock(VkDeviceSize size) : placement(size) {}
+    };
+
+    struct MemoryPool
+    {
+        uint32_t memoryTypeIndex = 0;
+        VkDeviceSize blockSize = 0;
+        std::vector<std::unique_ptr<MemoryBlock>> blocks; // 释放的块留下空位，之后复用下标
+    };
+
+    uint32_t createBlock(uint32_t poolIndex, VkDeviceSize size, bool dedicated);
+    void destroyBlock(uint32_t poolIndex, uint32_t blockIndex);
+
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    bool separateTiling; // bufferImageGranularity > 1 时线性资源与 optimal 图像使用不同的内存池
+    DeviceMemoryCallbacks callbacks;
+    std::vector<MemoryPool> pools; // 下标为 memoryTypeIndex * 2 + tiling
+};
+
+/**
+ *  在内存属性表中找出 typeFilter 允许且满足 properties 的第一个内存类型，找不到时抛出 std::runtime_error
+ * */
+uint32_t findMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties &memoryProperties, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+/**
+ *  当前物理设备的内存属性（第一次调用时查询并缓存）
+ * */
+const VkPhysicalDeviceMemoryProperties &getPhysicalDeviceMemoryProperties();
+
+/**
+ *  创建渲染器使用的全局分配器（需要在 createLogicalDevice() 之后调用）
+ * */
+void createMemoryAllocator();
+
+/**
+ *  为 buffer 分配内存并绑定
+ * */
+void allocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties, MemoryAllocation &allocation);
+
+/**
+ *  为图像分配内存并绑定
+ * */
+void allocateImageMemory(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags properties, MemoryAllocation &allocation);
+
+/**
+ *  释放 allocateBufferMemory/allocateImageMemory 得到的内存（对应的资源需要先注销）
+ * */
+void freeMemoryAllocation(MemoryAllocation &allocation);
+
+/**
+ *  打印各内存类型的使用情况与碎片率
+ * */
+void printMemoryAllocatorStats();
+
+/**
+ *  注销全局分配器，释放所有内存块
+ * */
+void cleanupMemoryAllocator();
+
+#endif
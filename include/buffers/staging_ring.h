@@ -0,0 +1,167 @@
+#ifndef STAGING_RING_H
+#define STAGING_RING_H
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#include "image/mipmap.h"
+
+/*
+    Introduction：
+    之前每次上传（顶点、索引、实例、纹理）都要新建一个 HOST_VISIBLE 的 staging buffer、分配内存、map/unmap，拷贝完成后
+再 vkQueueWaitIdle 并释放，内存分配与整条队列的同步都是不必要的开销。
+
+    这里改为启动时创建一个常驻映射（persistently mapped）的环形暂存缓冲区，所有上传路径都从中顺序分配：
+    | ...已完成，可复用... | tail -> 已提交、GPU 仍在读取的区间 | 当前批次（尚未提交） | head -> 空闲 ... |
+    1、分配只移动 head（超过末尾时回绕到 0），数据直接写入映射好的地址；
+    2、拷贝命令录制到当前批次的命令缓冲中，提交时附带一个 VkFence，并记录该批次占用的区间；
+    3、空间不够时先提交当前批次，再从最早的批次开始等待 fence，回收其区间（tail 前移），不需要等待整条队列。
+    超过单次分配上限（STAGING_RING_MAX_ALLOCATION）的上传会被拆分为多段，必要时跨多次提交。
+
+    设备有专用传输队列（transferQueue）时，批次提交到传输队列而不是图形队列，图形队列不会因为上传而停顿：
+    1、资源以 VK_SHARING_MODE_EXCLUSIVE 创建，传输队列写入后需要把所有权转移给图形队列族：批次末尾录制 release 屏障，
+    对应的 acquire 屏障暂存起来，由之后第一个图形队列的命令缓冲（每帧的命令缓冲或单次指令）通过 recordUploadAcquires()
+    录制；
+    2、每个批次在传输队列上 signal 一个递增的 timeline semaphore 值，录制了 acquire 的图形提交等待这个值。
+    没有专用传输队列（或设备不支持 timeline semaphore）时批次仍提交到图形队列，release 退化为普通的屏障，不需要 acquire。
+
+    启动与资源替换时有多项上传（纹理、顶点、索引、实例），每项上传结束时的 submitStagingCommands() 各自提交一次。在
+beginUploadBatch()/endUploadBatch() 之间这些提交被推迟，所有拷贝、布局转换与 mipmap 生成（上传走图形队列时）录制在同一个
+命令缓冲中，各资源的 release 屏障合并为一次 vkCmdPipelineBarrier，最后只提交一次、只有一个 fence。
+
+    所有函数都只能在渲染线程中调用。
+*/
+
+extern const VkDeviceSize STAGING_RING_SIZE;           // 环形暂存缓冲区大小
+extern const VkDeviceSize STAGING_RING_MAX_ALLOCATION; // 单次分配的上限，更大的上传会被拆分
+
+/**
+ *  从环形缓冲区中分配到的一段暂存空间
+ * */
+struct StagingAllocation
+{
+    VkBuffer buffer = VK_NULL_HANDLE;                // 环形缓冲区（拷贝命令的 srcBuffer）
+    VkDeviceSize offset = 0;                         // 在环形缓冲区中的偏移
+    void *mapped = nullptr;                          // 对应的 CPU 映射地址
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE; // 当前批次的命令缓冲，拷贝命令需要录制到这里
+};
+
+/**
+ *  图形队列提交时需要等待的上传：value 为 0 表示没有需要等待的上传
+ * */
+struct UploadWait
+{
+    uint64_t value = 0;              // 等待上传 timeline semaphore 达到的值
+    VkPipelineStageFlags stages = 0; // 在哪些阶段等待（即 acquire 屏障之后使用资源的阶段）
+};
+
+/**
+ *  创建环形暂存缓冲区（需要在 createCommandPool() 之后调用）
+ * */
+void createStagingRing();
+
+/**
+ *  分配 size 字节（按 alignment 对齐），空间不足时提交当前批次并等待最早的批次完成。size 超过 STAGING_RING_SIZE 时
+ * 抛出 std::runtime_error
+ * */
+StagingAllocation allocateStaging(VkDeviceSize size, VkDeviceSize alignment);
+
+/**
+ *  当前批次的命令缓冲（没有时开始一个新批次），用于录制布局转换等不需要暂存空间的命令
+ * */
+VkCommandBuffer getStagingCommandBuffer();
+
+/**
+ *  一次上传结束时调用：提交当前批次（不等待完成）；在上传批次中时推迟到 endUploadBatch()
+ * */
+void submitStagingCommands();
+
+/**
+ *  开始一个上传批次（可以嵌套），之后的上传合并到同一次提交
+ * */
+void beginUploadBatch();
+
+/**
+ *  结束上传批次，最外层结束时提交所有推迟的上传
+ * */
+void endUploadBatch();
+
+/**
+ *  上传是否在专用传输队列上执行（否则在图形队列上，上传批次的命令缓冲也可以录制图形命令）
+ * */
+bool usesTransferQueue();
+
+/**
+ *  在当前批次中把 buffer 的 [offset, offset + size) 交给图形队列，之后在 dstStage 以 dstAccess 访问（屏障在批次提交前合并录制）
+ * */
+void releaseBufferToGraphics(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+                             VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+/**
+ *  在当前批次中把图像的 range 交给图形队列，同时完成 oldLayout -> newLayout 的布局转换（屏障在批次提交前合并录制）
+ * */
+void releaseImageToGraphics(VkImage image, const VkImageSubresourceRange &range,
+                            VkImageLayout oldLayout, VkImageLayout newLayout,
+                            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+/**
+ *  在图形队列的命令缓冲中录制所有待处理的 acquire 屏障（需要在 render pass 之外），当前批次有未提交的命令时先提交
+ * （即使在上传批次中）。返回该命令缓冲提交时需要等待的上传
+ * */
+UploadWait recordUploadAcquires(VkCommandBuffer commandBuffer);
+
+/**
+ *  是否有尚未在图形队列上 acquire 的上传
+ * */
+bool hasPendingUploadAcquires();
+
+/**
+ *  上传的 timeline semaphore（只在使用专用传输队列时存在）
+ * */
+VkSemaphore getUploadTimelineSemaphore();
+
+/**
+ *  提交当前批次，等待所有批次完成并回收全部空间
+ * */
+void waitStagingRingIdle();
+
+/**
+ *  上传 elementCount 个大小为 elementSize 的元素到 dstBuffer 的 dstOffset 处，由 fill 把第 [first, first + count)
+ * 个元素直接写入暂存空间；超过单次分配上限时按元素拆分为多段。写入的区间最后交给图形队列，在 dstStage 以 dstAccess 读取
+ * */
+void uploadElementsToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, size_t elementCount, VkDeviceSize elementSize,
+                            const std::function<void(void *destination, size_t first, size_t count)> &fill,
+                            VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                            VkAccessFlags dstAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT);
+
+/**
+ *  上传一段连续的数据到 dstBuffer 的 dstOffset 处
+ * */
+void uploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void *data, VkDeviceSize size,
+                    VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                    VkAccessFlags dstAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT);
+
+/**
+ *  把 mip 链的各级拷贝到图像（图像需要已处于 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL）：能放进一次分配的相邻级别合并为
+ * 一次多 region 的 vkCmdCopyBufferToImage，超过上限的级别按块行拆分（拆分的行数满足上传队列的 minImageTransferGranularity）。
+ * levels[i] 对应第 i 级，offset 相对于 data
+ * */
+void uploadMipLevelsToImage(VkImage image, const uint8_t *data, const std::vector<MipLevel> &levels,
+                            uint32_t blockWidth, uint32_t blockHeight, uint32_t blockBytes);
+
+/**
+ *  注销环形暂存缓冲区（等待所有批次完成）
+ * */
+void cleanupStagingRing();
+
+#endif
@@ -15,6 +15,7 @@
 #include <limits>
 #include <optional>
 #include <set>
+#include <chrono>
 
 #include "logical_device_queue.h"
 #include "swapchain.h"
@@ -23,6 +24,8 @@
 #include "frame_buffer.h"
 
 #include "vertex_buffer.h"
+#include "buffers/staging_ring.h" // vertex_buffer.h 与本文件互相包含，UploadWait 需要在这里直接引入
+#include "utils/thread_pool.h"
 
 /*
     Introduction：
@@ -30,12 +33,37 @@
 “命令缓冲区”（command buffer）的地方，一次性执行这些所有的命令。好处就是，一旦我们确定了要执行哪些操作，
 这些操作会一次性被提交并执行，内部的优化会带来很好的效率提升
     这时你之前所配置的指令集队列就派上用场了？
+
+    场景中的绘制数量上千之后，单线程录制命令会成为 CPU 端的瓶颈。开启 enableParallelRecording 后，绘制列表被
+切成若干连续的区间，交给线程池并行录制到各自的次级命令缓冲区（VK_COMMAND_BUFFER_LEVEL_SECONDARY）中，主命令
+缓冲区在 render pass 内用 vkCmdExecuteCommands 按区间顺序执行它们：
+    1、命令池不是线程安全的，每个录制区间在每一帧都有自己的命令池（MAX_FRAMES_IN_FLIGHT × 线程池并发度个），
+    同一时刻只有一个线程使用它；
+    2、次级命令缓冲区不继承主命令缓冲区的状态，每个区间都要重新绑定管线、顶点/索引缓冲与描述符；
+    3、等待某一帧的 fence 之后，该帧的命令池整体 vkResetCommandPool，比逐个重置命令缓冲区更便宜；
+    4、绘制数量较少时并行的固定开销大于收益，仍然直接录制在主命令缓冲区中。
+
+    对于基本静止的场景，每帧真正变化的只有 uniform buffer 的内容。开启 enablePrerecordedCommandBuffers 后，
+为每个（帧，交换链图像）组合各录制一个主命令缓冲区并反复提交，只有以下情况才重新录制：
+    1、invalidateCommandBuffers() 被调用（替换了缓冲区/纹理描述符、重建了管线等），或者交换链重建；
+    2、本帧的绘制列表（LOD 选择、簇剔除结果）与录制时不同。
+    绘制列表与上一帧不同时说明场景正在变化，这一帧不重新录制预录制的命令缓冲区，而是与关闭预录制时一样录制
+commandBuffers[currentFrame]（可以使用并行录制），绘制列表连续两帧相同后才重新录制并复用。
+    组合 (f, i) 的命令缓冲区只会随 inFlightFences[f] 提交，drawFrame() 等待该 fence 之后重新录制是安全的。
+预录制的命令缓冲区会被多次提交，所以不使用 ONE_TIME_SUBMIT，也不使用按帧重置命令池的并行录制。
 */
 
 extern VkCommandPool commandPool; // 声明 命令池实例，用于管理命令缓冲区的内容
 
 extern std::vector<VkCommandBuffer> commandBuffers; // 声明 命令缓冲区实例
 
+extern const bool enableParallelRecording;               // 是否把绘制分给多个线程录制到次级命令缓冲区
+extern const uint32_t PARALLEL_RECORDING_MIN_DRAWS;      // 每个录制区间至少包含的绘制数量
+extern const bool enableCommandRecordingBenchmark;       // 进入主循环前测试不同线程数下的录制耗时
+extern const uint32_t COMMAND_RECORDING_BENCHMARK_DRAWS; // 测试使用的绘制数量
+extern const uint32_t COMMAND_RECORDING_BENCHMARK_FRAMES;
+extern const bool enablePrerecordedCommandBuffers;       // 是否复用预录制的命令缓冲区
+
 /**
  *  创建命令池
  * */
@@ -45,8 +73,31 @@ void createCommandPool();
  *  创建命令缓冲区
  * */
 void createCommandBuffer();
-void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, uint32_t currentFrame);
+/**
+ *  录制一帧的命令，返回提交时需要等待的上传（传输队列上传的资源在这一帧取得所有权时）
+ * */
+UploadWait recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, uint32_t currentFrame);
 
+/**
+ *  取得本帧要提交的命令缓冲区：预录制模式下复用（需要时重新录制）对应 (currentFrame, imageIndex) 的命令缓冲区，
+ *  否则重置并录制 commandBuffers[currentFrame]。uploadWait 为提交时需要等待的上传
+ * */
+VkCommandBuffer prepareFrameCommandBuffer(uint32_t imageIndex, uint32_t currentFrame, UploadWait &uploadWait);
+
+/**
+ *  标记所有预录制的命令缓冲区需要重新录制（录制时引用的缓冲区、描述符或管线发生变化后调用）
+ * */
+void invalidateCommandBuffers();
+
+/**
+ *  释放所有预录制的命令缓冲区（交换链重建时图像数量可能变化，需要在 GPU 空闲时调用）
+ * */
+void freePrerecordedCommandBuffers();
+
+/**
+ *  场景绘制展开为逐实例的大量绘制，测试 1 个线程到线程池并发度个线程时的命令录制耗时（只录制不提交）
+ * */
+void benchmarkCommandRecording();
 
 
 /**
@@ -55,10 +106,20 @@ void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, uin
 VkCommandBuffer beginSingleTimeCommands();
 
 /**
- *  结束一个 用于提交单次指令的 command buffer 的填充，并将其送入 graphic queue 进行执行
+ *  结束一个 用于提交单次指令的 command buffer 的填充，并将其送入 graphic queue 进行执行（不等待完成）
  * */
 void endSingleTimeCommands(VkCommandBuffer commandBuffer);
 
+/**
+ *  在图形队列上 acquire 所有待处理的上传（注销可能还没有被任何一帧使用过的资源之前调用，避免留下指向已注销资源的屏障）
+ * */
+void flushUploadAcquires();
+
+/**
+ *  等待所有已提交的单次指令完成
+ * */
+void waitSingleTimeCommandsIdle();
+
 
 void cleanupCommandPool();
 
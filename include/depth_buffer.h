@@ -34,13 +34,18 @@
 #include "image_view.h"
 
 extern VkImage depthImage;
-extern VkDeviceMemory depthImageMemory;
+extern MemoryAllocation depthImageMemory;
 extern VkImageView depthImageView;
 
 
 void createDepthResources();
 VkFormat findDepthFormat();
 
+/**
+ *  注销深度图及其 ImageView，释放对应的内存
+ * */
+void cleanupDepthResources();
+
 
 
 #endif
@@ -0,0 +1,127 @@
+#ifndef GPU_CULLING_H
+#define GPU_CULLING_H
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <cstring>
+#include <cstdint>
+
+#include "logical_device_queue.h"
+#include "graphic_pipeline.h"
+#include "uniform_buffer.h"
+#include "scene.h"
+#include "render_queue.h"
+#include "buffers/staging_ring.h"
+
+/*
+    Introduction：
+    CPU 端的 updateSceneDraws() 每帧都要遍历所有实例选择 LOD，再由 recordCommandBuffer() 逐个发出绘制，物体数量
+上去之后 CPU 的开销随之线性增长。开启 enableGpuCulling 后改为 GPU 驱动的绘制：
+    1、场景中的每个实例是一个物体，其场景空间下的包围球、LOD 链的位置与 vertexOffset 存放在一个 storage buffer 中
+    （随 instance buffer 一起创建，场景不变时不需要更新）；
+    2、每帧 CPU 只把视锥平面与 LOD 参数写入一个很小的 uniform buffer；
+    3、render pass 之前的 compute pass（shaders/cull_objects.comp）对每个物体做视锥剔除与 LOD 选择，把可见物体的
+    VkDrawIndexedIndirectCommand 紧凑地写入本帧的间接绘制缓冲，同时原子累加绘制数量；物体按网格的图形管线（顶点格式）
+    分组，每组在缓冲中占一段连续的命令，并在缓冲开头有各自的绘制数量；
+    4、render pass 中每组只需要绑定管线后发出一次 vkCmdDrawIndexedIndirectCount；设备不支持 drawIndirectCount 时退化为
+    vkCmdDrawIndexedIndirect，按组内物体总数绘制，间接绘制缓冲每帧先清零，未写入的命令 instanceCount 为 0。
+    这样每帧的 CPU 开销与物体数量无关，录制的命令也不再变化，可以直接复用预录制的命令缓冲区。
+
+    间接绘制需要 multiDrawIndirect 与 drawIndirectFirstInstance 特性（lavapipe 等软件实现同样支持），设备不支持时
+仍然使用 CPU 端的绘制列表。
+*/
+
+extern const bool enableGpuCulling; // 是否使用 GPU 剔除与间接绘制
+extern bool gpuCullingActive;       // 设备支持时为 true，此时不再生成 CPU 端的绘制列表
+
+/**
+ *  storage buffer 中每个物体的数据（std430，与 cull_objects.comp 中的 CullObject 一致）
+ * */
+struct GpuCullObject
+{
+    glm::vec4 sphere;       // 场景空间下的包围球（xyz 为球心，w 为半径）
+    float scale;            // 实例的统一缩放
+    uint32_t firstLod;      // 在 LOD 缓冲中的起始位置
+    uint32_t lodCount;
+    int32_t vertexOffset;
+    uint32_t instanceIndex; // 间接绘制命令的 firstInstance
+    uint32_t drawGroup;     // 所属的绘制分组（每条图形管线一组），对应间接绘制缓冲开头的计数
+    uint32_t firstDraw;     // 分组在间接绘制命令中的起始位置
+    uint32_t reserved;
+};
+
+/**
+ *  LOD 缓冲中的一项（std430），firstIndex 为在 index buffer 中的绝对位置
+ * */
+struct GpuCullLod
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error;
+    uint32_t reserved;
+};
+
+/**
+ *  每帧的剔除参数（std140，与 cull_objects.comp 中的 CullParams 一致）
+ * */
+struct GpuCullParams
+{
+    alignas(16) glm::mat4 sceneView;
+    alignas(16) glm::vec4 frustumPlanes[6];
+    float pixelsPerUnit;
+    float pixelThreshold;
+    uint32_t objectCount;
+    uint32_t lodEnabled;
+};
+
+/**
+ *  创建剔除用的 compute pipeline、描述符与每帧的参数缓冲（需要在 createPipelineCache() 之后、createInstanceBuffer() 之前调用）
+ * */
+void createGpuCullingPipeline();
+
+/**
+ *  按当前场景创建物体/LOD 缓冲与每帧的间接绘制缓冲，并更新描述符集（由 createInstanceBuffer() 调用）
+ * */
+void createGpuCullingBuffers();
+
+/**
+ *  注销物体/LOD/间接绘制缓冲（由 cleanupInstanceBuffer() 调用）
+ * */
+void cleanupGpuCullingBuffers();
+
+/**
+ *  写入本帧的剔除参数（需要在 updateUniformBuffer() 之后调用）
+ * */
+void updateGpuCulling(uint32_t currentFrame);
+
+/**
+ *  录制剔除的 compute pass（需要在 render pass 之外）
+ * */
+void recordGpuCulling(VkCommandBuffer commandBuffer, uint32_t currentFrame);
+
+/**
+ *  在 render pass 中录制间接绘制：每个分组通过 cache 绑定各自的管线（需要已经绑定物体 0 的描述符与顶点/索引缓冲）
+ * */
+void recordGpuDraws(RenderStateCache &cache);
+
+/**
+ *  当前场景的物体数量
+ * */
+uint32_t getGpuCullObjectCount();
+
+/**
+ *  注销剔除用的管线、描述符与参数缓冲
+ * */
+void cleanupGpuCulling();
+
+#endif
@@ -8,6 +8,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <vector>
+#include <array>
 #include <cstring>
 #include <cstdlib>
 #include <cstdint>
@@ -17,9 +18,12 @@
 
 // 引入shader文件所必须
 #include <fstream>
+#include <chrono>
 
 #include "logical_device_queue.h"
 
+#include "model/vertex_format.h"
+
 #include "swapchain.h"
 
 #include "graphic_pipeline/vertex_shader.h"
@@ -33,11 +37,13 @@
 #include "graphic_pipeline/depth_stencil.h"
 #include "graphic_pipeline/multi_sampling.h"
 #include "graphic_pipeline/color_blending.h"
+#include "graphic_pipeline/pipeline_cache.h"
 
 #include "render_passes.h"
 
 
 #include "uniform_buffer.h"
+#include "bindless_textures.h"
 
 
 extern const int MAX_FRAMES_IN_FLIGHT;
@@ -78,10 +84,10 @@ extern const int MAX_FRAMES_IN_FLIGHT;
 
 
 extern VkPipelineLayout pipelineLayout; // 声明运行时对管线进行修改/参数传入的接口实例
-extern VkPipeline graphicsPipeline; // 声明渲染管线实例
+extern std::array<VkPipeline, VERTEX_FORMAT_COUNT> graphicsPipelines; // 声明渲染管线实例，下标为管线使用的顶点格式
 
 /**
- *  创建图形渲染管线
+ *  创建图形渲染管线（每种顶点格式一条）
  * */
 void createGraphicsPipeline();
 
@@ -23,7 +23,7 @@
 extern VkSampleCountFlagBits msaaSamples;
 
 extern VkImage colorImage;
-extern VkDeviceMemory colorImageMemory;
+extern MemoryAllocation colorImageMemory;
 extern VkImageView colorImageView;
 
 
@@ -0,0 +1,57 @@
+#ifndef PIPELINE_CACHE_H
+#define PIPELINE_CACHE_H
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+
+#include "logical_device_queue.h"
+
+/*
+    Introduction：
+    vkCreateGraphicsPipelines 在没有管线缓存时每次都要由驱动把 SPIR-V 编译为 GPU 指令，这是启动时间中很大的一部分，
+而同一台机器、同一个驱动下每次编译的结果都是一样的。
+
+    这里创建一个所有管线共用的 VkPipelineCache（主渲染管线与 ImGui 的管线），启动时从磁盘读取上次保存的缓存数据，
+退出时把驱动积累的数据写回磁盘：
+    1、文件由一个很小的文件头（magic、数据大小、内容哈希）加驱动返回的缓存数据组成，截断或损坏的文件直接丢弃；
+    2、缓存数据开头是 Vulkan 规定的 VkPipelineCacheHeaderVersionOne，其中的 vendorID、deviceID 与 pipelineCacheUUID
+    需要与当前物理设备一致（更换显卡或升级驱动后 UUID 会变化），不一致时从空缓存开始；
+    3、写入时先写临时文件再 rename，进程在写入过程中退出也不会留下半个缓存文件。
+*/
+
+extern const std::string PIPELINE_CACHE_PATH; // 管线缓存文件路径
+extern const bool enablePipelineCache;        // 关闭时不读写磁盘缓存（仍然创建一个空的 VkPipelineCache）
+
+extern VkPipelineCache pipelineCache; // 所有管线共用的管线缓存
+extern bool pipelineCacheWarm;        // 是否成功载入了磁盘上的缓存数据
+
+/**
+ *  创建管线缓存，并尝试载入磁盘上的缓存数据（需要在 createLogicalDevice() 之后、创建任何管线之前调用）
+ * */
+void createPipelineCache();
+
+/**
+ *  校验驱动缓存数据的 VkPipelineCacheHeaderVersionOne 是否与 properties 描述的设备一致
+ * */
+bool validatePipelineCacheData(const uint8_t *data, size_t size, const VkPhysicalDeviceProperties &properties);
+
+/**
+ *  把当前的缓存数据写回磁盘（先写临时文件再 rename）
+ * */
+void savePipelineCache();
+
+/**
+ *  保存并注销管线缓存
+ * */
+void cleanupPipelineCache();
+
+#endif
@@ -20,47 +20,20 @@
 #include "logical_device_queue.h"
 
 
-// 第三步，将编译好的文件导入到当前渲染管线中，首先我们需要一个加载文件的函数
-static std::vector<char> readFile(const std::string &filename)
-{
-    /*
-        设置读文件模式：
-        ate：从文件末尾开始读，
-        binary：以二进制文件读取
-    */
-    std::ifstream file(filename, std::ios::ate | std::ios::binary);
-
-    // 文件打开失败则抛出错误
-    if (!file.is_open())
-    {
-        throw std::runtime_error("failed to open file!");
-    }
-
-    // 从文件末尾开始读取的好处是，我们可以使用读取位置来确定文件的大小并分配缓冲区：
-    size_t fileSize = (size_t)file.tellg();
-    std::vector<char> buffer(fileSize);
-    // 而后我们再回到文件开头，一次读完所有字节：
-    file.seekg(0);
-    file.read(buffer.data(), fileSize);
-
-    file.close();
-
-    return buffer;
-}
-
-
 /*
+    第三步，将编译好的着色器导入到当前渲染管线中。
+    着色器在构建时由 glslc 编译并通过 cmake/embed_spirv.cmake 嵌入为 constexpr uint32_t 数组
+（build/generated/shaders/*.spv.h），运行时不再读取 .spv 文件，也不会误用过期的编译结果。
     在进行渲染前，我们应该以同样的方式创建一个 shader module，创建方式大同小异：
 都是引入一个参数结构体，进行配置并传入。
-    这里传入的参数只有一个，就是刚刚我们从预编译文件中读入的二进制文件，由于是以二进制
-方式读入，这里传入的参数类型就给定为char类型数组，刚好每个元素代表一个字节长度。
+    这里传入的参数就是嵌入的 SPIR-V 数组，codeSize 以字节为单位。
 */
-static VkShaderModule createShaderModule(const std::vector<char> &code)
+static VkShaderModule createShaderModule(const uint32_t *code, size_t codeSize)
 {
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = code.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+    createInfo.codeSize = codeSize;
+    createInfo.pCode = code;
     // 创建一个 Shader
     VkShaderModule shaderModule;
     if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
@@ -71,4 +44,13 @@ static VkShaderModule createShaderModule(const std::vector<char> &code)
     return shaderModule;
 }
 
+/**
+ *  直接由嵌入的数组创建 shader module，大小由数组类型推导
+ * */
+template <size_t N>
+static VkShaderModule createShaderModule(const uint32_t (&code)[N])
+{
+    return createShaderModule(code, sizeof(code));
+}
+
 #endif
\ No newline at end of file
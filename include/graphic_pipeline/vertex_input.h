@@ -17,11 +17,12 @@
 #include <set>
 
 #include "vertex_buffer.h"
+#include "model/vertex_format.h"
 
 /**
- *  配置顶点数据的传入规则
+ *  配置顶点数据的传入规则（binding 0 按 format 排布）
  * */
-void configure_vertex_input(VkPipelineVertexInputStateCreateInfo &vertexInputInfo);
+void configure_vertex_input(VkPipelineVertexInputStateCreateInfo &vertexInputInfo, VertexFormat format);
 
 
 #endif
\ No newline at end of file
@@ -17,11 +17,12 @@
 #include <set>
 
 #include "graphic_pipeline/utils.h"
+#include "model/vertex_format.h"
 
 /**
- *  自定义 vertex shader 配置变量
+ *  自定义 vertex shader 配置变量（按顶点格式选择对应的顶点着色器）
  * */ 
-VkShaderModule configure_vertex_shader(VkPipelineShaderStageCreateInfo &vertShaderStageInfo);
+VkShaderModule configure_vertex_shader(VkPipelineShaderStageCreateInfo &vertShaderStageInfo, VertexFormat format);
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef BC_ENCODER_H
+#define BC_ENCODER_H
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "image/mipmap.h"
+
+/*
+    Introduction：
+    纹理以未压缩的 RGBA8 上传时，每个像素占 4 字节。块压缩格式（BC，即 DXT/BPTC）把每个 4x4 的像素块编码为固定
+大小的数据块，GPU 在采样时直接解码，显存占用与采样带宽都只有原来的 1/8 ～ 1/4：
+    BC1：8 字节/块（4 bpp），两个 RGB565 端点 + 16 个 2 位索引，只用于不透明纹理；
+    BC3：16 字节/块（8 bpp），BC4 格式的 alpha 块（两个 8 位端点 + 3 位索引）+ BC1 颜色块；
+    BC7：16 字节/块（8 bpp），8 种模式，质量最好。这里只使用模式 6（单分区，RGBA 7.7.7.7 端点 + 每端点一个
+    p-bit，4 位索引），它可以直接处理带 alpha 的块，编码简单且质量明显优于 BC3。
+
+    每个块的编码流程都是一样的：
+    1、对块内像素做主成分分析（协方差矩阵 + 幂迭代），取主轴方向上投影的最小/最大点作为初始端点；
+    2、把端点量化到目标格式的精度，对每个像素在调色板中选择误差最小的索引；
+    3、固定索引，用最小二乘重新拟合两个端点，再量化一次，误差更小时采用新的结果。
+    编码在 sRGB 编码后的数值上进行（与 VK_FORMAT_*_SRGB_BLOCK 解码时在 sRGB 空间插值的行为一致）。
+
+    块行之间互不依赖，整幅图像按块行切分后交给线程池并行处理。同时提供对应的 CPU 解码器，用于计算 PSNR 以及
+在设备不支持 BC 格式时退回未压缩格式。
+*/
+
+/**
+ *  块压缩格式
+ * */
+enum class BlockFormat : uint32_t
+{
+    BC1 = 1,
+    BC3 = 3,
+    BC7 = 7,
+};
+
+/**
+ *  每个 4x4 块的字节数
+ * */
+uint32_t getBlockBytes(BlockFormat format);
+
+/**
+ *  格式名称，用于日志
+ * */
+const char *getBlockFormatName(BlockFormat format);
+
+/**
+ *  RGBA8 图像中是否存在非 255 的 alpha
+ * */
+bool imageHasAlpha(const uint8_t *pixels, uint32_t width, uint32_t height);
+
+/**
+ *  根据 alpha 的使用情况选择格式：不透明纹理使用 BC1，带 alpha 的纹理使用 BC7（preferBc7 为 false 时使用 BC3）
+ * */
+BlockFormat selectBlockFormat(bool hasAlpha, bool preferBc7);
+
+/**
+ *  编码/解码单个块，pixels 为 4x4 个 RGBA8 像素（按行排列，共 64 字节）
+ *  解码器只支持本编码器输出的内容（BC7 只支持模式 6）
+ * */
+void encodeBlock(BlockFormat format, const uint8_t *pixels, uint8_t *block);
+void decodeBlock(BlockFormat format, const uint8_t *block, uint8_t *pixels);
+
+/**
+ *  压缩整幅 RGBA8 图像，尺寸不是 4 的倍数时边缘块用最近的像素填充，输出按块行排列
+ * */
+void compressImage(BlockFormat format, const uint8_t *pixels, uint32_t width, uint32_t height, uint8_t *blocks);
+
+/**
+ *  把压缩数据解码回 RGBA8 图像
+ * */
+void decompressImage(BlockFormat format, const uint8_t *blocks, uint32_t width, uint32_t height, uint8_t *pixels);
+
+/**
+ *  压缩后图像占用的字节数
+ * */
+size_t getCompressedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+/**
+ *  压缩完成的 mip 链，levels 中的偏移指向 data 中每一级的第一个块
+ * */
+struct CompressedMipChain
+{
+    BlockFormat format = BlockFormat::BC1;
+    std::vector<uint8_t> data;
+    std::vector<MipLevel> levels;
+};
+
+/**
+ *  逐级压缩 CPU 生成的 mip 链
+ * */
+void compressMipChain(BlockFormat format, const MipChain &chain, CompressedMipChain &compressed);
+
+/**
+ *  把压缩的 mip 链解码回 RGBA8 mip 链
+ * */
+void decompressMipChain(const CompressedMipChain &compressed, MipChain &chain);
+
+/**
+ *  计算两幅 RGBA8 图像的峰值信噪比（dB），channels 为 3 时只比较 RGB
+ * */
+double computePsnr(const uint8_t *a, const uint8_t *b, size_t pixelCount, uint32_t channels);
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef KTX2_H
+#define KTX2_H
+
+#include <vulkan/vulkan.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "utils/mapped_file.h"
+#include "image/mipmap.h"
+
+/*
+    Introduction：
+    PNG 每次启动都需要完整地 inflate 解码，mip 链也需要重新生成。KTX2（Khronos Texture 2.0）是为 GPU 纹理设计的
+容器格式，直接保存 VkFormat 以及每一级 mip 的原始数据（可以是未压缩的 RGBA8，也可以是 BC 等块压缩格式）：
+    | 标识符(12) | 文件头(36) | 索引(32) | 级别索引(24 * levelCount) | DFD | 键值数据 | 各级别数据（从最小级别到第 0 级） |
+    级别索引记录每一级在文件中的偏移与长度，所以加载时只需要 mmap 整个文件、校验文件头与级别索引，就可以把所有级别
+原样拷贝到 staging buffer，用一次多 region 的 vkCmdCopyBufferToImage 上传，不需要解码，也不需要 generateMipmaps()。
+
+    这里只支持渲染器实际会用到的情况：二维纹理、无数组层/立方体面、无超压缩（supercompressionScheme = 0），
+格式为 RGBA8 sRGB 或 BC1/BC3/BC7 sRGB。levelCount 为 0 表示文件只包含第 0 级，其余级别由加载方生成（块压缩格式无法生成，按只有一级处理）。
+写出时附带最基本的数据格式描述符（DFD）与 KTXwriter 键值，可以被 ktx 工具链正常识别。
+*/
+
+/**
+ *  纹理格式的块信息（未压缩格式视为 1x1 的块）
+ * */
+struct FormatBlockInfo
+{
+    uint32_t blockWidth;
+    uint32_t blockHeight;
+    uint32_t blockBytes;
+};
+
+/**
+ *  获取 KTX2 读写支持的格式的块信息，不支持的格式返回 false
+ * */
+bool getFormatBlockInfo(VkFormat format, FormatBlockInfo &info);
+
+/**
+ *  已映射并校验过的 KTX2 文件
+ * */
+struct Ktx2Texture
+{
+    MappedFile file;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;       // 图像应有的 mip 级数（文件中 levelCount 为 0 时：RGBA8 为完整 mip 链的级数，块压缩格式为 1）
+    std::vector<MipLevel> levels; // 文件中已有的级别，offset 相对于 dataOffset
+    size_t dataOffset = 0;        // 覆盖所有级别数据的连续区间在文件中的起始位置
+    size_t dataSize = 0;
+
+    const uint8_t *levelData() const { return reinterpret_cast<const uint8_t *>(file.data()) + dataOffset; }
+};
+
+/**
+ *  path 是否为 .ktx2 文件（按扩展名判断）
+ * */
+bool isKtx2Path(const std::string &path);
+
+/**
+ *  映射并校验 KTX2 文件（标识符、文件头、级别索引），不支持或损坏的文件抛出 std::runtime_error
+ * */
+void loadKtx2(const std::string &path, Ktx2Texture &texture);
+
+/**
+ *  写出 KTX2 文件，levels 为各级别在 data 中的位置（从第 0 级开始），失败时抛出 std::runtime_error
+ * */
+void writeKtx2(const std::string &path, VkFormat format, uint32_t width, uint32_t height,
+               const uint8_t *data, const std::vector<MipLevel> &levels);
+
+#endif
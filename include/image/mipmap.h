@@ -0,0 +1,63 @@
+#ifndef MIPMAP_H
+#define MIPMAP_H
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Introduction：
+    原本的 mipmap 由 generateMipmaps 在 GPU 上用一串 vkCmdBlitImage 逐级生成，存在以下问题：
+    1、blit 的线性过滤直接作用在 sRGB 编码后的数值上（是否先转换到线性空间取决于驱动实现），缩小后的图像会
+    偏暗；
+    2、需要格式支持 VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT，不支持时程序直接抛出异常；
+    3、每一级都需要一对 barrier，逐级串行执行。
+
+    这里在 CPU 端一次生成完整的 mip 链：
+    1、第 0 级的 RGB 通过查找表从 sRGB 解码到线性空间（float），alpha 本身就是线性的，直接归一化；
+    2、每一级都由上一级的线性数据做 2x2 盒式滤波得到（奇数尺寸与 vkCmdBlitImage 一样向下取整），中间结果始终
+    保持 float 精度，不会因为逐级量化累积误差；
+    3、每一行滤波完成后立即通过查找表编码回 sRGB8，所有级别按顺序紧密排列在同一块内存中，可以用一次
+    vkCmdCopyBufferToImage（每一级一个 region）上传到 GPU；
+    4、滤波核按平台选择：x86 上默认使用 SSE2（x86-64 的基线指令集），运行时检测到 AVX2 则切换为 AVX2 版本
+    （一次处理两个输出像素）；ARM 上使用 NEON；其余平台使用标量实现。每一级的行在线程池中并行处理，
+    级别之间存在依赖只能顺序执行，但越往后的级别越小，耗时主要集中在前两级。
+*/
+
+/**
+ *  mip 链中的一级
+ * */
+struct MipLevel
+{
+    size_t offset;   // 在 MipChain::data 中的字节偏移
+    uint32_t width;  // 宽度（像素）
+    uint32_t height; // 高度（像素）
+};
+
+/**
+ *  CPU 端生成的完整 mip 链（RGBA8，sRGB 编码）
+ * */
+struct MipChain
+{
+    std::vector<uint8_t> data;
+    std::vector<MipLevel> levels;
+};
+
+/**
+ *  计算完整 mip 链的级数：floor(log2(max(width, height))) + 1
+ * */
+uint32_t computeMipLevelCount(uint32_t width, uint32_t height);
+
+/**
+ *  由 RGBA8 sRGB 像素生成完整的 mip 链（第 0 级为原图的拷贝），在 sRGB 解码后的线性空间中进行 2x2 盒式滤波
+ * */
+void buildMipChain(const uint8_t *pixels, uint32_t width, uint32_t height, MipChain &chain);
+
+/**
+ *  当前平台实际使用的滤波核名称（"avx2" / "sse2" / "neon" / "scalar"），用于日志与性能测试
+ * */
+const char *getMipmapKernelName();
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "utils/mapped_file.h"
+#include "model/mesh_cache.h"
+#include "image/bc_encoder.h"
+
+/*
+    Introduction：
+    块压缩的编码比解码慢得多（BC7 每秒只有几百万像素），而同一张纹理每次得到的结果都是一样的。这里仿照模型的
+.vmesh 缓存，把压缩完成的整条 mip 链保存到 .vtex 缓存文件中，之后启动时直接读取。
+
+    .vtex 文件布局（小端）：
+    | TextureCacheHeader | 源文件路径 | 对齐填充 | 级别表（TextureCacheLevel） | 对齐填充 | 压缩数据 |
+    缓存的校验方式与 .vmesh 相同（源文件路径、大小、修改时间、内容哈希，复用 MeshSourceKey），另外编码选项
+（例如带 alpha 的纹理是否使用 BC7）记录在 options 中，选项不同的缓存互相不能复用。
+*/
+
+// 修改缓存布局或者编码器（会改变输出结果）时需要递增这个版本号，使旧缓存失效
+const uint32_t TEXTURE_CACHE_VERSION = 1;
+
+// 影响缓存内容的编码选项
+const uint32_t TEXTURE_CACHE_OPTION_BC7 = 1u << 0;
+
+/**
+ *  缓存文件头
+ * */
+struct TextureCacheHeader
+{
+    char magic[4];       // "VTEX"
+    uint32_t version;    // TEXTURE_CACHE_VERSION
+    uint32_t pathLength; // 源文件路径长度（紧跟在文件头之后，不含结尾 '\0'）
+    uint32_t options;    // TEXTURE_CACHE_OPTION_* 组合
+    uint32_t format;     // BlockFormat
+    uint32_t levelCount;
+    uint64_t sourceSize; // 源文件大小
+    int64_t sourceMtime; // 源文件修改时间（纳秒）
+    uint64_t sourceHash; // 源文件内容哈希
+    uint64_t levelOffset; // 级别表在文件中的偏移
+    uint64_t dataOffset;  // 压缩数据在文件中的偏移
+    uint64_t dataSize;
+};
+
+/**
+ *  级别表中的一项（不直接保存 MipLevel，避免 size_t 的大小随平台变化）
+ * */
+struct TextureCacheLevel
+{
+    uint64_t offset; // 相对压缩数据起始位置的偏移
+    uint32_t width;
+    uint32_t height;
+};
+
+/**
+ *  缓存文件路径：源文件路径 + ".vtex"
+ * */
+std::string getTextureCachePath(const std::string &sourcePath);
+
+/**
+ *  读取并校验缓存文件，缓存不存在或已失效时返回 false
+ * */
+bool readTextureCache(const std::string &cachePath, const MeshSourceKey &key, CompressedMipChain &chain);
+
+/**
+ *  将压缩完成的 mip 链写入缓存文件（先写临时文件再重命名，避免留下不完整的缓存），失败时抛出 std::runtime_error
+ * */
+void writeTextureCache(const std::string &cachePath, const MeshSourceKey &key, const CompressedMipChain &chain);
+
+#endif
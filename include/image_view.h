@@ -45,7 +45,7 @@ void createImage(uint32_t width,
                  VkImageUsageFlags usage,
                  VkMemoryPropertyFlags properties,
                  VkImage &image,
-                 VkDeviceMemory &imageMemory);
+                 MemoryAllocation &imageMemory);
 
 /**
  *  创建单一ImageView实例
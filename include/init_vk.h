@@ -25,9 +25,14 @@
 
 #include "frame_buffer.h"
 #include "command_buffer.h"
+#include "buffers/staging_ring.h"
 #include "render_loop.h"
 
 #include "vertex_buffer.h"
+#include "scene.h"
+#include "gpu_culling.h"
+#include "bindless_textures.h"
+#include "asset_streaming.h"
 
 #include "uniform_buffer.h"
 
@@ -22,6 +22,12 @@
 
 extern VkDevice device; // 逻辑设备，物理设备的映射
 
+extern const bool enableTransferQueue; // 存在专用传输队列族时在其上异步上传
+extern bool timelineSemaphoreEnabled;  // 逻辑设备是否开启了 timelineSemaphore 特性
+extern bool multiDrawIndirectEnabled;  // 逻辑设备是否开启了 multiDrawIndirect 与 drawIndirectFirstInstance 特性
+extern bool drawIndirectCountEnabled;  // 逻辑设备是否开启了 drawIndirectCount 特性（1.2）
+extern bool descriptorIndexingEnabled; // 逻辑设备是否开启了 runtimeDescriptorArray 等描述符索引特性（1.2）
+
 /**
  *  逻辑设备是物理设备的映射，
  * 
@@ -0,0 +1,117 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "utils/mapped_file.h"
+#include "utils/hash.h"
+#include "model/simplifier.h"
+
+/*
+    Introduction：
+    每次启动时 loadModel() 都会重新解析 OBJ 并做一遍顶点去重，而对同一个模型文件，得到的 vertices/indices
+永远是一样的。这里把处理完成的顶点/索引数组以二进制形式保存到 .vmesh 缓存文件中，之后启动时直接 mmap 该文件，
+顶点/索引数据可以不经过任何解析，直接 memcpy 到暂存缓冲区中。
+
+    .vmesh 文件布局（小端）：
+    | MeshCacheHeader | 源文件路径 | 对齐填充 | 顶点数据 | 索引数据 | LOD 表 |
+    索引数据包含所有 LOD 级别（依次存放），LOD 表记录每个级别在索引数据中的区间。
+    缓存通过以下信息判断是否仍然有效：格式版本、顶点结构体大小、处理选项、源文件路径、大小、修改时间以及内容哈希。
+其中任意一项不一致都视为缓存失效，重新从 OBJ 导入并覆盖缓存。
+*/
+
+// 修改缓存布局或者顶点处理流程（去重/重排等）时需要递增这个版本号，使旧缓存失效
+const uint32_t MESH_CACHE_VERSION = 4;
+
+// 影响缓存内容的处理选项（例如是否做过顶点缓存优化），选项不同的缓存互相不能复用
+const uint32_t MESH_CACHE_OPTION_OPTIMIZED = 1u << 0;
+const uint32_t MESH_CACHE_OPTION_LOD = 1u << 1;
+
+/**
+ *  缓存文件头
+ * */
+struct MeshCacheHeader
+{
+    char magic[4];         // "VMSH"
+    uint32_t version;      // MESH_CACHE_VERSION
+    uint32_t vertexStride; // sizeof(Vertex)，结构体布局变化时缓存同样失效
+    uint32_t pathLength;   // 源文件路径长度（紧跟在文件头之后，不含结尾 '\0'）
+    uint32_t options;      // MESH_CACHE_OPTION_* 组合
+    uint32_t reserved;
+    uint64_t sourceSize;   // 源文件大小
+    int64_t sourceMtime;   // 源文件修改时间（纳秒）
+    uint64_t sourceHash;   // 源文件内容哈希
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint64_t vertexOffset; // 顶点数据在文件中的偏移
+    uint64_t indexOffset;  // 索引数据在文件中的偏移
+    uint64_t lodCount;
+    uint64_t lodOffset;    // LOD 表在文件中的偏移
+};
+
+/**
+ *  用于校验缓存的源文件信息
+ * */
+struct MeshSourceKey
+{
+    std::string path;
+    uint64_t size;
+    int64_t mtime;
+    uint64_t hash;
+    uint32_t options; // MESH_CACHE_OPTION_* 组合
+};
+
+/**
+ *  读取源文件的大小/修改时间，并计算内容哈希，失败时抛出 std::runtime_error
+ * */
+MeshSourceKey makeMeshSourceKey(const std::string &path);
+
+/**
+ *  缓存文件路径：源文件路径 + ".vmesh"
+ * */
+std::string getMeshCachePath(const std::string &sourcePath);
+
+/**
+ *  已映射的 .vmesh 缓存文件
+ * */
+class MeshCache
+{
+public:
+    /**
+     *  映射并校验缓存文件，缓存不存在或已失效时返回 false
+     * */
+    bool open(const std::string &cachePath, const MeshSourceKey &key, uint32_t vertexStride);
+
+    /**
+     *  将处理完成的顶点/索引数据以及 LOD 表写入缓存文件（先写临时文件再重命名，避免留下不完整的缓存）
+     * */
+    static void write(const std::string &cachePath, const MeshSourceKey &key,
+                      const void *vertexData, size_t vertexCount, uint32_t vertexStride,
+                      const uint32_t *indexData, size_t indexCount,
+                      const MeshLod *lodData, size_t lodCount);
+
+    const void *vertexData() const { return file.data() + header.vertexOffset; }
+    const uint32_t *indexData() const { return reinterpret_cast<const uint32_t *>(file.data() + header.indexOffset); }
+    size_t vertexCount() const { return header.vertexCount; }
+    size_t indexCount() const { return header.indexCount; }
+    const MeshLod *lodData() const { return reinterpret_cast<const MeshLod *>(file.data() + header.lodOffset); }
+    size_t lodCount() const { return header.lodCount; }
+
+    bool isOpen() const { return file.isOpen(); }
+
+    /**
+     *  解除缓存文件映射
+     * */
+    void close() { file.close(); }
+
+private:
+    MappedFile file;
+    MeshCacheHeader header{};
+};
+
+#endif
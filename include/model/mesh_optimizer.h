@@ -0,0 +1,75 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Introduction：
+    loadModel() 输出的索引保持着 OBJ 文件中面的原始顺序，这个顺序通常与 GPU 的顶点后变换缓存（post-transform
+cache）毫无关系：同一个顶点会在相隔很远的三角形中再次出现，此时它早已被挤出缓存，只能重新执行一遍顶点着色器。
+同样顶点数组按去重时“首次出现”的顺序排列，绘制时的顶点读取也比较分散。
+
+    这里提供一个与 GPU 无关的网格优化流程：
+    1、optimizeVertexCache：使用 Tipsify 算法（Sander et al. 2007，"Fast Triangle Reordering for Vertex
+Locality and Reduced Overdraw"）重排三角形顺序，使相邻三角形尽量复用缓存中的顶点，复杂度为线性；
+    2、optimizeVertexFetch：按照新的索引顺序中顶点首次被引用的顺序重排顶点数组，使顶点读取尽量连续；
+    3、analyzeVertexCache：使用 FIFO 缓存模拟器统计 ACMR（平均每个三角形的缓存未命中次数，理想值约 0.5）与
+ATVR（平均每个顶点被变换的次数，理想值为 1.0），用于对比优化前后的效果。
+*/
+
+// 优化与统计时使用的缓存大小，大多数 GPU 的后变换缓存等效大小在 16~32 之间
+const uint32_t VERTEX_CACHE_SIZE = 16;
+
+/**
+ *  顶点缓存模拟统计结果
+ * */
+struct VertexCacheStatistics
+{
+    size_t transformedVertices; // 缓存未命中（需要执行顶点着色器）的次数
+    double acmr;                // average cache miss ratio = 未命中次数 / 三角形数量
+    double atvr;                // average transformed vertex ratio = 未命中次数 / 被引用的顶点数量
+};
+
+/**
+ *  使用 FIFO 缓存模拟器统计索引序列的 ACMR/ATVR
+ * */
+VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount,
+                                         uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+/**
+ *  使用 Tipsify 算法重排三角形顺序，提高顶点后变换缓存命中率（只修改 indices 中三角形的顺序）
+ * */
+void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount,
+                         uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+/**
+ *  计算按索引中首次引用顺序重排顶点的映射表，并改写 indices
+ *  remap[旧顶点下标] = 新顶点下标，未被引用的顶点映射为 0xFFFFFFFF，返回被引用的顶点数量
+ * */
+size_t optimizeVertexFetchRemap(std::vector<uint32_t> &indices, size_t vertexCount, std::vector<uint32_t> &remap);
+
+/**
+ *  按照顶点获取顺序重排顶点数组（未被引用的顶点会被删除）
+ * */
+template <typename T>
+void optimizeVertexFetch(std::vector<T> &vertices, std::vector<uint32_t> &indices)
+{
+    std::vector<uint32_t> remap;
+    size_t newCount = optimizeVertexFetchRemap(indices, vertices.size(), remap);
+
+    std::vector<T> reordered(newCount);
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        if (remap[i] != 0xFFFFFFFFu)
+        {
+            reordered[remap[i]] = vertices[i];
+        }
+    }
+    vertices.swap(reordered);
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Introduction：
+    recordCommandBuffer() 中整个模型只有一次 vkCmdDrawIndexed，屏幕外的部分与背对相机的部分都会完整地走一遍
+顶点着色器与光栅化。这里把索引缓冲划分为若干“簇”（meshlet/cluster），每个簇最多包含 64 个不同的顶点、124
+个三角形，并为每个簇计算：
+    1、包围球：用于视锥剔除；
+    2、法线锥（锥轴 + 截止值）：簇中所有三角形的法线都落在这个锥内，当相机位于锥的背面时整个簇都是背面，可以剔除。
+
+    簇按照索引缓冲中三角形的顺序贪心划分，每个簇对应索引缓冲中的一段连续区间，所以不需要重排索引，也不需要
+mesh shader：每帧在CPU上剔除之后，把相邻的可见簇合并成一段区间，每段区间发出一次 vkCmdDrawIndexed 即可。
+索引顺序在此之前已经经过顶点缓存优化（Tipsify），相邻三角形在空间上本来就比较集中，贪心划分得到的簇也比较紧凑。
+*/
+
+const uint32_t MESHLET_MAX_VERTICES = 64;
+const uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+/**
+ *  簇的描述信息（包围体均位于模型空间）
+ * */
+struct Meshlet
+{
+    uint32_t indexOffset; // 在索引缓冲中的起始位置
+    uint32_t indexCount;  // 索引数量（三角形数量 * 3）
+    uint32_t vertexCount; // 引用的不同顶点数量
+
+    glm::vec3 center; // 包围球球心
+    float radius;     // 包围球半径
+
+    glm::vec3 coneAxis; // 法线锥轴
+    float coneCutoff;   // sin(锥半角)，为 1 时表示法线过于分散，不做背面剔除
+};
+
+/**
+ *  一次绘制的索引区间
+ * */
+struct MeshletDrawRange
+{
+    uint32_t indexOffset;
+    uint32_t indexCount;
+};
+
+/**
+ *  剔除统计
+ * */
+struct MeshletCullStatistics
+{
+    uint32_t totalMeshlets;
+    uint32_t visibleMeshlets;
+    uint32_t frustumCulled;
+    uint32_t backfaceCulled;
+    uint32_t drawCount;       // 合并相邻区间后的绘制次数
+    uint32_t visibleIndices;  // 实际提交的索引数量
+};
+
+/**
+ *  将索引缓冲划分为簇，positions 指向第一个顶点的位置，positionStride 为相邻顶点之间的字节数
+ * */
+void buildMeshlets(const float *positions, size_t positionStride, size_t vertexCount,
+                   const uint32_t *indices, size_t indexCount, std::vector<Meshlet> &meshlets);
+
+/**
+ *  视锥 + 法线锥剔除
+ *  modelViewProj 为 proj * view * model（model 为簇包围体所在的模型空间到世界空间的变换），
+ *  cameraPosition 为模型空间中的相机位置。可见簇对应的索引区间按顺序合并后写入 draws
+ *  meshlets 可以是某个 LOD 级别对应的一段簇
+ * */
+void cullMeshlets(const Meshlet *meshlets, size_t meshletCount, const glm::mat4 &modelViewProj, const glm::vec3 &cameraPosition,
+                  std::vector<MeshletDrawRange> &draws, MeshletCullStatistics &statistics);
+
+#endif
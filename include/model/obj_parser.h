@@ -0,0 +1,59 @@
+#ifndef OBJ_PARSER_H
+#define OBJ_PARSER_H
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "utils/thread_pool.h"
+#include "utils/mapped_file.h"
+
+/*
+    Introduction：
+    tinyobj 使用 ifstream 逐行读入整个文件并在单线程上解析，对于扫描得到的大模型，启动阶段会在这里卡上好几秒。
+    这里实现一个只关心 v/vt/vn/f 字段的 OBJ 解析器：
+    1、使用 mmap 映射整个文件；
+    2、按照行边界将文件切分成若干块，每块在线程池上独立解析；
+    3、所有块解析完毕后，根据每块的 v/vt/vn 数量做前缀和，得到全局偏移，再并行地把各块结果拷贝/修正到最终数组。
+    OBJ 中的负数（相对）索引依赖于“到目前为止出现了多少个顶点”，所以块内只记录相对于块起点的位置，到合并阶段
+再加上全局偏移。
+    其他字段（o/g/s/usemtl/mtllib等）目前都直接跳过，所有面按文件顺序合并，这与原先 loadModel() 中把所有
+shape 依次拼接的结果一致。
+*/
+
+/**
+ *  面上某个角点引用的 v/vt/vn 下标（从 0 开始，不存在时为 -1），与 tinyobj::index_t 含义一致
+ * */
+struct ObjIndex
+{
+    int vertex_index;
+    int texcoord_index;
+    int normal_index;
+};
+
+/**
+ *  OBJ 文件解析结果
+ * */
+struct ObjMesh
+{
+    std::vector<float> vertices;   // v  字段，每个顶点 3 个 float
+    std::vector<float> texcoords;  // vt 字段，每个纹理坐标 2 个 float
+    std::vector<float> normals;    // vn 字段，每个法线 3 个 float
+    std::vector<ObjIndex> indices; // f  字段，已经按扇形三角化，每 3 个为一个三角形
+};
+
+/**
+ *  使用 mmap + 线程池并行解析 OBJ 文件，失败时抛出 std::runtime_error
+ *  chunkCount 为 0 时根据文件大小与线程池并发度自动决定切块数量
+ * */
+void parseObjFile(const std::string &path, ObjMesh &mesh, size_t chunkCount = 0);
+
+/**
+ *  并行解析一段内存中的 OBJ 文本
+ * */
+void parseObjBuffer(const char *data, size_t size, ObjMesh &mesh, size_t chunkCount = 0);
+
+#endif
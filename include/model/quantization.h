@@ -0,0 +1,34 @@
+#ifndef QUANTIZATION_H
+#define QUANTIZATION_H
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+/*
+    Introduction：
+    顶点属性量化相关的工具函数。量化值与 Vulkan 中 *_UNORM 格式的解码规则一致：
+    UNORM8  : float = q / 255.0
+    UNORM16 : float = q / 65535.0
+    所以量化后的数据可以直接交给顶点输入阶段，由硬件在读取时自动转换为 [0, 1] 之间的浮点数。
+*/
+
+/**
+ *  将 [0, 1] 范围内的浮点数量化为 UNORM16（超出范围的值会被截断）
+ * */
+inline uint16_t quantizeUnorm16(float value)
+{
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint16_t>(value * 65535.0f + 0.5f);
+}
+
+/**
+ *  将 [0, 1] 范围内的浮点数量化为 UNORM8（超出范围的值会被截断）
+ * */
+inline uint8_t quantizeUnorm8(float value)
+{
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint8_t>(value * 255.0f + 0.5f);
+}
+
+#endif
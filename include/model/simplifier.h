@@ -0,0 +1,73 @@
+#ifndef SIMPLIFIER_H
+#define SIMPLIFIER_H
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Introduction：
+    models 目录下同时有 bunny.obj 与手工制作的 bunny_low_resolution.obj，说明我们是需要 LOD 的，但程序中既不会
+生成也不会选择 LOD。这里实现一个基于二次误差度量（QEM，Garland & Heckbert 1997，"Surface Simplification Using
+Quadric Error Metrics"）的网格简化器：
+    1、每个顶点累积其相邻三角形所在平面的二次误差矩阵（按面积加权）；
+    2、每轮对所有边计算折叠代价，按代价从小到大执行“半边折叠”（把一个顶点并入相邻的另一个顶点），并拒绝会导致
+    三角形翻转的折叠；每个顶点每轮最多参与一次折叠，重复若干轮直到达到目标三角形数量或误差上限；
+    3、折叠总是并入已有顶点，不会产生新顶点，所以所有 LOD 级别共用同一个顶点缓冲，只需要各自的索引区间。
+
+    为了不破坏纹理，位置相同但 UV 不同的顶点（UV 接缝）以及网格边界、非流形边上的顶点都会被锁定，只能作为折叠的
+目标而不能被移走。折叠的代价以折叠后顶点到其累积平面的面积加权均方根距离估计（与模型坐标同单位），这只是
+一个平均意义下的估计，不能作为误差上界。LOD 选择需要的上界由 boundSimplificationError 给出：简化时记录每个原始
+顶点被折叠到了哪个顶点，原始顶点到这个顶点周围三角形的最近距离不小于它到整个简化网格表面的距离。
+    measureSimplificationError 给出一个与实现无关的误差度量（原始网格顶点到简化网格表面的最大距离），
+可以在CPU上直接验证上界是否成立。
+*/
+
+/**
+ *  一个 LOD 级别在索引缓冲中的区间
+ * */
+struct MeshLod
+{
+    uint32_t indexOffset; // 在索引缓冲中的起始位置
+    uint32_t indexCount;  // 索引数量
+    float error;          // 相对原始网格的误差上界（模型坐标单位）
+    uint32_t reserved;
+};
+
+/**
+ *  使用 QEM 简化网格
+ *  positions 指向第一个顶点的位置，positionStride 为相邻顶点之间的字节数；
+ *  简化在索引数量不大于 targetIndexCount 或下一次折叠的误差估计超过 targetError 时停止。
+ *  结果写入 result，返回最大的折叠代价（均方根距离估计，不是上界）；remap 不为空时写入每个顶点最终被折叠到的顶点
+ * （未被移走的顶点映射到自身）
+ * */
+float simplifyMesh(const float *positions, size_t positionStride, size_t vertexCount,
+                   const uint32_t *indices, size_t indexCount,
+                   size_t targetIndexCount, float targetError, std::vector<uint32_t> &result,
+                   std::vector<uint32_t> *remap = nullptr);
+
+/**
+ *  由 simplifyMesh 输出的 remap（多次简化时为逐级复合后的映射）计算原始网格中被引用的每个顶点到简化网格表面
+ *  距离的上界，复杂度与索引数量成线性
+ * */
+float boundSimplificationError(const float *positions, size_t positionStride, size_t vertexCount,
+                               const uint32_t *originalIndices, size_t originalIndexCount,
+                               const uint32_t *simplifiedIndices, size_t simplifiedIndexCount,
+                               const std::vector<uint32_t> &remap);
+
+/**
+ *  计算原始网格中被引用的每个顶点到简化网格表面的最大距离（暴力计算，复杂度 O(顶点数 * 三角形数)，用于验证/测试）
+ * */
+float measureSimplificationError(const float *positions, size_t positionStride, size_t vertexCount,
+                                 const uint32_t *originalIndices, size_t originalIndexCount,
+                                 const uint32_t *simplifiedIndices, size_t simplifiedIndexCount);
+
+/**
+ *  根据投影到屏幕上的误差选择 LOD：返回投影误差不超过 pixelThreshold 的最粗糙级别
+ *  pixelsPerUnit 为距离相机单位距离处，一个模型单位在屏幕上对应的像素数；distance 为相机到网格的距离
+ * */
+uint32_t selectMeshLod(const MeshLod *lods, size_t lodCount, float distance, float pixelsPerUnit, float pixelThreshold);
+
+#endif
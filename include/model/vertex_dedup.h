@@ -0,0 +1,291 @@
+#ifndef VERTEX_DEDUP_H
+#define VERTEX_DEDUP_H
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "utils/hash.h"
+#include "utils/thread_pool.h"
+
+/*
+    Introduction：
+    loadModel() 中原先使用 std::unordered_map<Vertex, uint32_t> 做顶点去重，存在两个问题：
+    1、std::hash<Vertex> 只是把三个 glm hash 做异或移位，而 glm hash 本身又是 std::hash<float> 的简单组合，
+对网格这种坐标规律性很强的数据冲突非常严重；
+    2、先 count() 再 operator[]，每个角点要做两次哈希与两次查找，且每个节点单独分配内存，缓存命中率很差。
+
+    这里实现一个专用的开放寻址（线性探测）去重表：
+    1、对顶点的原始比特做 wyhash，相等判断也直接比较比特（memcmp），所以要求 T 没有填充字节。注意这意味着 -0.0
+与 +0.0、不同编码的 NaN 会被视为不同顶点，这对于去重来说只会多保留几个顶点，不影响正确性；
+    2、槽位中只保存 {哈希高32位, 顶点下标}，8 字节一个，探测时先比较哈希标签，只有标签相同时才访问顶点数组；
+    3、根据角点数量预先分配容量（装载因子不超过 2/3），整个去重过程不会发生扩容；
+    4、findOrInsert 一次探测同时完成查找与插入。
+*/
+
+template <typename T>
+class VertexDedupTable
+{
+    static_assert(std::is_trivially_copyable<T>::value, "VertexDedupTable requires a trivially copyable vertex type");
+
+public:
+    /**
+     *  expectedCount 为最多可能插入的顶点数量（通常就是角点数量，即索引数量）
+     * */
+    explicit VertexDedupTable(size_t expectedCount)
+    {
+        size_t capacity = 16;
+        while (capacity < expectedCount + expectedCount / 2)
+        {
+            capacity <<= 1;
+        }
+        slots.assign(capacity, Slot{0, EMPTY_SLOT});
+        mask = capacity - 1;
+    }
+
+    /**
+     *  查找与 value 比特相同的顶点，找到时返回其在 values 中的下标；否则将 value 追加到 values 末尾并返回新下标
+     * */
+    uint32_t findOrInsert(const T &value, std::vector<T> &values)
+    {
+        uint64_t hash = hashBytes(&value, sizeof(T));
+        return findOrInsert(value, hash, values);
+    }
+
+    /**
+     *  同上，使用调用者预先计算好的哈希值
+     * */
+    uint32_t findOrInsert(const T &value, uint64_t hash, std::vector<T> &values)
+    {
+        const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        size_t slot = static_cast<size_t>(hash) & mask;
+        while (true)
+        {
+            Slot &current = slots[slot];
+            if (current.index == EMPTY_SLOT)
+            {
+                if (count + 1 > (slots.size() >> 1) + (slots.size() >> 2))
+                {
+                    // 预估容量不足（调用者给出的 expectedCount 偏小），扩容后重新查找插入位置
+                    grow(values);
+                    return findOrInsert(value, hash, values);
+                }
+                current.tag = tag;
+                current.index = static_cast<uint32_t>(values.size());
+                values.push_back(value);
+                count++;
+                return current.index;
+            }
+            if (current.tag == tag && std::memcmp(&values[current.index], &value, sizeof(T)) == 0)
+            {
+                return current.index;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    /**
+     *  表中不同顶点的数量
+     * */
+    size_t size() const { return count; }
+
+private:
+    static const uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+    struct Slot
+    {
+        uint32_t tag;   // 哈希值高 32 位
+        uint32_t index; // 顶点在 values 中的下标
+    };
+
+    void grow(const std::vector<T> &values)
+    {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.assign(old.size() * 2, Slot{0, EMPTY_SLOT});
+        mask = slots.size() - 1;
+        for (const Slot &entry : old)
+        {
+            if (entry.index == EMPTY_SLOT)
+            {
+                continue;
+            }
+            uint64_t hash = hashBytes(&values[entry.index], sizeof(T));
+            size_t slot = static_cast<size_t>(hash) & mask;
+            while (slots[slot].index != EMPTY_SLOT)
+            {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = entry;
+        }
+    }
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+};
+
+/*
+    并行分片去重：
+    串行去重按角点顺序处理，新顶点按“首次出现”的顺序编号。为了让并行结果与串行完全一致，这里分四步：
+    1、并行计算每个角点的哈希值，按哈希高位将角点分配到若干分片，相同的顶点必然落在同一个分片中；
+        分配时按“块内计数 -> 前缀和 -> 散射”的方式进行，保证每个分片内的角点仍然保持原始顺序；
+    2、各分片独立去重，记录每个唯一顶点首次出现的角点，以及每个角点在分片内的局部编号；
+    3、对“是否为首次出现”的标记做前缀和，首次出现的角点在所有首次出现角点中的排名，就是它在串行算法中的编号；
+    4、并行写出顶点数组，并将每个角点的局部编号改写为全局编号。
+    整个过程的结果与线程数/分片数无关，与串行的 VertexDedupTable 输出逐字节相同。
+*/
+
+/**
+ *  并行去重 cornerCount 个角点，makeVertex(i) 返回第 i 个角点的顶点，结果追加到 outVertices/outIndices
+ *  makeVertex 会被多个线程并发调用，且同一个角点可能被调用多次
+ * */
+template <typename T, typename MakeVertex>
+void parallelDeduplicateVertices(size_t cornerCount, const MakeVertex &makeVertex,
+                                 std::vector<T> &outVertices, std::vector<uint32_t> &outIndices)
+{
+    ThreadPool &pool = getThreadPool();
+
+    // 分片数量取 2 的幂，且明显多于线程数，以便负载均衡
+    size_t shardBits = 0;
+    while ((size_t(1) << shardBits) < pool.concurrency() * 4)
+    {
+        shardBits++;
+    }
+    const size_t shardCount = size_t(1) << shardBits;
+    const size_t blockCount = std::max<size_t>(1, std::min(pool.concurrency() * 4, cornerCount / 4096));
+    const size_t blockSize = (cornerCount + blockCount - 1) / blockCount;
+
+    auto shardOf = [shardBits](uint64_t hash)
+    { return shardBits == 0 ? size_t(0) : static_cast<size_t>(hash >> (64 - shardBits)); };
+
+    /**
+     *  1、计算哈希并按分片统计每块中的角点数量
+     * */
+    std::vector<uint64_t> hashes(cornerCount);
+    std::vector<size_t> blockShardCount(blockCount * shardCount, 0);
+    pool.parallelFor(blockCount, [&](size_t block)
+                     {
+        size_t begin = block * blockSize, end = std::min(cornerCount, begin + blockSize);
+        size_t *counts = &blockShardCount[block * shardCount];
+        for (size_t i = begin; i < end; i++)
+        {
+            T vertex = makeVertex(i);
+            hashes[i] = hashBytes(&vertex, sizeof(T));
+            counts[shardOf(hashes[i])]++;
+        } });
+
+    // 按 (分片, 块) 的顺序做前缀和，得到每块在每个分片角点列表中的写入位置
+    std::vector<size_t> shardBegin(shardCount + 1, 0);
+    std::vector<size_t> blockShardOffset(blockCount * shardCount);
+    size_t running = 0;
+    for (size_t shard = 0; shard < shardCount; shard++)
+    {
+        shardBegin[shard] = running;
+        for (size_t block = 0; block < blockCount; block++)
+        {
+            blockShardOffset[block * shardCount + shard] = running;
+            running += blockShardCount[block * shardCount + shard];
+        }
+    }
+    shardBegin[shardCount] = running;
+
+    std::vector<uint32_t> shardCorners(cornerCount);
+    pool.parallelFor(blockCount, [&](size_t block)
+                     {
+        size_t begin = block * blockSize, end = std::min(cornerCount, begin + blockSize);
+        size_t *offsets = &blockShardOffset[block * shardCount];
+        for (size_t i = begin; i < end; i++)
+        {
+            shardCorners[offsets[shardOf(hashes[i])]++] = static_cast<uint32_t>(i);
+        } });
+
+    /**
+     *  2、各分片独立去重
+     * */
+    std::vector<uint32_t> cornerLocal(cornerCount);
+    std::vector<uint8_t> isFirst(cornerCount, 0);
+    std::vector<std::vector<T>> shardVertices(shardCount);
+    std::vector<std::vector<uint32_t>> shardFirstCorner(shardCount);
+    pool.parallelFor(shardCount, [&](size_t shard)
+                     {
+        size_t begin = shardBegin[shard], end = shardBegin[shard + 1];
+        VertexDedupTable<T> table(end - begin);
+        std::vector<T> &values = shardVertices[shard];
+        for (size_t k = begin; k < end; k++)
+        {
+            uint32_t corner = shardCorners[k];
+            size_t before = values.size();
+            uint32_t local = table.findOrInsert(makeVertex(corner), hashes[corner], values);
+            if (values.size() != before)
+            {
+                shardFirstCorner[shard].push_back(corner);
+                isFirst[corner] = 1;
+            }
+            cornerLocal[corner] = local;
+        } });
+
+    /**
+     *  3、对首次出现标记做前缀和（先按块求和，再块内展开），得到每个首次出现角点的全局编号
+     * */
+    std::vector<uint32_t> blockFirstCount(blockCount + 1, 0);
+    pool.parallelFor(blockCount, [&](size_t block)
+                     {
+        size_t begin = block * blockSize, end = std::min(cornerCount, begin + blockSize);
+        uint32_t count = 0;
+        for (size_t i = begin; i < end; i++)
+        {
+            count += isFirst[i];
+        }
+        blockFirstCount[block + 1] = count; });
+    for (size_t block = 0; block < blockCount; block++)
+    {
+        blockFirstCount[block + 1] += blockFirstCount[block];
+    }
+
+    const size_t base = outVertices.size();
+    std::vector<uint32_t> firstGlobal(cornerCount); // 仅对首次出现的角点有效
+    pool.parallelFor(blockCount, [&](size_t block)
+                     {
+        size_t begin = block * blockSize, end = std::min(cornerCount, begin + blockSize);
+        uint32_t next = static_cast<uint32_t>(base) + blockFirstCount[block];
+        for (size_t i = begin; i < end; i++)
+        {
+            if (isFirst[i])
+            {
+                firstGlobal[i] = next++;
+            }
+        } });
+
+    /**
+     *  4、写出顶点数组，并把角点的局部编号改写为全局编号
+     * */
+    outVertices.resize(base + blockFirstCount[blockCount]);
+    std::vector<std::vector<uint32_t>> shardGlobal(shardCount);
+    pool.parallelFor(shardCount, [&](size_t shard)
+                     {
+        const std::vector<uint32_t> &firstCorner = shardFirstCorner[shard];
+        std::vector<uint32_t> &global = shardGlobal[shard];
+        global.resize(firstCorner.size());
+        for (size_t local = 0; local < firstCorner.size(); local++)
+        {
+            global[local] = firstGlobal[firstCorner[local]];
+            outVertices[global[local]] = shardVertices[shard][local];
+        } });
+
+    const size_t indexBase = outIndices.size();
+    outIndices.resize(indexBase + cornerCount);
+    pool.parallelFor(blockCount, [&](size_t block)
+                     {
+        size_t begin = block * blockSize, end = std::min(cornerCount, begin + blockSize);
+        for (size_t i = begin; i < end; i++)
+        {
+            outIndices[indexBase + i] = shardGlobal[shardOf(hashes[i])][cornerLocal[i]];
+        } });
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <cstdint>
+
+/*
+    Introduction：
+    顶点格式单独放在这里：图形管线为每种格式各创建一条管线（graphic_pipeline.h），而 vertex_buffer.h 通过
+buffers_operation.h 间接包含了 graphic_pipeline.h，两边都需要在定义之前使用这个枚举。
+*/
+
+/**
+ *  顶点格式
+ * */
+enum VertexFormat
+{
+    VERTEX_FORMAT_FLOAT,        // Vertex，32 字节
+    VERTEX_FORMAT_PACKED,       // PackedVertex 不含颜色，12 字节
+    VERTEX_FORMAT_PACKED_COLOR, // PackedVertex 含 RGBA8 颜色，16 字节
+    VERTEX_FORMAT_COUNT
+};
+
+#endif
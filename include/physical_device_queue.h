@@ -52,6 +52,7 @@ struct QueueFamilyIndices
 {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> transferFamily; // 只支持传输（不支持图形/计算）的队列族，可选，存在时上传在这个队列上异步执行
 
     bool isComplete()
     {
@@ -62,7 +63,7 @@ struct QueueFamilyIndices
 extern QueueFamilyIndices queueIndices; // 声明 指令集队列集合对象
 
 /**
- * 01：核验GPU是否同时具有支持“图形绘制”和“图形展示”的指令集队列
+ * 01：核验GPU是否同时具有支持“图形绘制”和“图形展示”的指令集队列，并找出可选的专用传输队列
  * */
 QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 
@@ -17,6 +17,7 @@
 #include <set>
 // 引入计时器，查看程序运行时间（渲染一帧用时）
 #include <ctime>
+#include <chrono>
 
 #include "logical_device_queue.h"
 #include "swapchain.h"
@@ -116,6 +117,8 @@ extern std::vector<VkFence> inFlightFences;               // 声明 流程控制
 
 extern uint32_t currentFrame; // 声明 当前帧 index
 
+extern double frameCpuMilliseconds; // 声明 上一帧 CPU 端准备一帧（uniform buffer、绘制列表、命令录制）的耗时
+
 /**
  *  主渲染函数 Render Loop
  * */
@@ -0,0 +1,114 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+
+#include "graphic_pipeline.h"
+#include "uniform_buffer.h"
+#include "scene.h"
+
+/*
+    Introduction：
+    之前 recordCommandBuffer() 固定地绑定一次管线、一次顶点/索引缓冲与一次描述符，然后发出所有绘制。场景中有多条
+管线、多种材质与多份几何数据之后，按生成顺序绘制会在它们之间来回切换。这里引入一个渲染队列：
+    1、每个绘制生成一个 64 位的排序键，从高到低依次为 | 管线 8 位 | 材质 16 位 | 网格 16 位 | 深度 24 位 |，
+    状态切换代价越高的字段位置越高，相同状态下按深度由近到远绘制（不透明物体可以尽早被深度测试剔除）；
+    2、每帧的绘制列表按排序键做 LSD 基数排序（每趟 8 位，所有键在这一趟落入同一个桶时跳过这一趟）；
+    3、录制时用 RenderStateCache 记录当前已绑定的管线、描述符集（材质 + 物体的动态偏移）、push constants 与
+    几何数据，与上一个绘制相同的绑定直接跳过，并分别统计实际发出与省略的绑定次数。
+
+    管线与材质编号来自 ModelMesh::pipeline / ModelMesh::material，几何数据编号对应一组顶点/索引缓冲。管线编号即
+网格的顶点格式，对应 graphicsPipelines 中的一条管线；目前所有网格共用每帧一个描述符集以及同一组顶点/索引缓冲
+（不同格式的网格在 vertex buffer 中按各自的顶点大小对齐），编号都为 0，新增材质或几何数据时扩展 getRenderMaterial()
+等查找函数即可。bindless 模式下材质由 createBindlessMaterial() 创建，只对应纹理数组中的下标，
+切换材质只需要更新 push constants。
+*/
+
+extern const bool enableRenderQueueSort; // 是否按排序键对每帧的绘制列表排序
+
+/**
+ *  绑定次数统计
+ * */
+struct RenderBindStatistics
+{
+    uint64_t pipelineBinds = 0;
+    uint64_t pipelineBindsElided = 0;
+    uint64_t descriptorBinds = 0; // 描述符集（材质或物体的动态偏移变化时）
+    uint64_t descriptorBindsElided = 0;
+    uint64_t pushConstants = 0; // 每个物体的 push constants
+    uint64_t pushConstantsElided = 0;
+    uint64_t geometryBinds = 0; // 顶点/索引缓冲
+    uint64_t geometryBindsElided = 0;
+
+    RenderBindStatistics &operator+=(const RenderBindStatistics &other);
+    uint64_t issued() const { return pipelineBinds + descriptorBinds + pushConstants + geometryBinds; }
+    uint64_t elided() const { return pipelineBindsElided + descriptorBindsElided + pushConstantsElided + geometryBindsElided; }
+};
+
+extern RenderBindStatistics renderBindStatistics; // 最近一次录制场景时的绑定统计（预录制的命令缓冲区复用时不更新）
+
+/**
+ *  渲染队列中的一项，draw 为在绘制列表中的下标
+ * */
+struct RenderQueueItem
+{
+    uint64_t key;
+    uint32_t draw;
+};
+
+/**
+ *  一个命令缓冲区中当前已绑定的状态（次级命令缓冲区不继承主命令缓冲区的状态，每个都从空状态开始）
+ * */
+struct RenderStateCache
+{
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    uint32_t currentFrame = 0;
+    uint32_t pipeline = std::numeric_limits<uint32_t>::max();
+    uint32_t material = std::numeric_limits<uint32_t>::max();
+    uint32_t object = std::numeric_limits<uint32_t>::max();
+    uint32_t geometry = std::numeric_limits<uint32_t>::max();
+    bool bindlessBound = false; // bindless 纹理数组是否已经绑定
+    RenderBindStatistics statistics;
+};
+
+/**
+ *  打包排序键，depth 为观察空间下到相机的距离（负数按 0 处理）
+ * */
+uint64_t makeRenderSortKey(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+
+/**
+ *  按 key 升序对 items 做稳定的 LSD 基数排序，scratch 为同样大小的临时空间
+ * */
+void radixSortRenderQueue(std::vector<RenderQueueItem> &items, std::vector<RenderQueueItem> &scratch);
+
+/**
+ *  按排序键重排本帧的绘制列表 sceneDraws（由 updateSceneDraws() 调用）
+ * */
+void sortSceneDraws();
+
+/**
+ *  绑定绘制需要的管线、材质、物体（动态偏移与 push constants）与几何数据，与 cache 中当前状态相同的绑定被跳过
+ * */
+void bindRenderState(RenderStateCache &cache, uint32_t pipeline, uint32_t material, uint32_t object, uint32_t geometry);
+
+/**
+ *  按绘制所属的网格绑定状态
+ * */
+void bindSceneDrawState(RenderStateCache &cache, const SceneDraw &draw);
+
+/**
+ *  输出绑定统计
+ * */
+void printRenderBindStatistics(const RenderBindStatistics &statistics);
+
+#endif
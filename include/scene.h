@@ -0,0 +1,171 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <array>
+
+#include "vertex_buffer.h"
+#include "uniform_buffer.h"
+#include "swapchain.h"
+
+/*
+    Introduction：
+    之前的程序只有一对全局的 vertex buffer / index buffer，且每帧只发出一次绘制。这里引入一个简单的场景表示：
+    1、场景中可以有多个模型网格（ModelMesh），它们的顶点/索引依次存放在同一个 vertex buffer / index buffer 中；
+    2、每个实例只记录它使用的网格以及实例变换，所有实例的变换按网格分组后存放在一个 instance buffer 中，
+    以 VK_VERTEX_INPUT_RATE_INSTANCE 的方式绑定到 binding 1，顶点着色器中通过 gl_InstanceIndex 对应的属性读取；
+    3、每帧对每种网格只发出一次 vkCmdDrawIndexed，instanceCount 为该网格的实例数量，firstInstance 指向该网格
+    在 instance buffer 中的第一个实例。
+
+    LOD 按网格选择（取离相机最近的实例决定），只有一个实例的网格仍然走簇剔除（meshlet），多实例网格的逐实例剔除
+留给之后的 GPU 剔除。
+*/
+
+extern const bool enableInstancedScene;
+extern const std::vector<std::string> SCENE_MODEL_PATHS;
+extern const uint32_t SCENE_INSTANCE_COUNT;
+extern const bool enableSceneBenchmark;
+extern const std::vector<uint32_t> SCENE_BENCHMARK_INSTANCE_COUNTS;
+extern const uint32_t SCENE_BENCHMARK_FRAMES;
+
+/**
+ *  instance buffer 中每个实例的数据
+ * */
+struct InstanceData
+{
+    glm::mat4 model;             // 实例变换（GPU 剔除时合并了紧凑顶点格式的位置反量化）
+    glm::vec4 texCoordTransform; // 紧凑顶点格式的 UV 反量化参数（xy 偏移，zw 缩放）
+
+    /**
+     *  实例数据绑定在 binding 1 上，每个实例（而非每个顶点）前进一次
+     * */
+    static VkVertexInputBindingDescription getBindingDescription()
+    {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 1;
+        bindingDescription.stride = sizeof(InstanceData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        return bindingDescription;
+    }
+
+    /**
+     *  mat4 占用连续的四个 location（3~6），每个 location 对应一列
+     * */
+    static std::array<VkVertexInputAttributeDescription, 5> getAttributeDescriptions()
+    {
+        std::array<VkVertexInputAttributeDescription, 5> attributeDescriptions{};
+        for (uint32_t column = 0; column < 4; column++)
+        {
+            attributeDescriptions[column].binding = 1;
+            attributeDescriptions[column].location = 3 + column;
+            attributeDescriptions[column].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attributeDescriptions[column].offset = offsetof(InstanceData, model) + sizeof(glm::vec4) * column;
+        }
+        attributeDescriptions[4].binding = 1;
+        attributeDescriptions[4].location = 7;
+        attributeDescriptions[4].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        attributeDescriptions[4].offset = offsetof(InstanceData, texCoordTransform);
+        return attributeDescriptions;
+    }
+};
+
+/**
+ *  场景中的一个实例
+ * */
+struct SceneInstance
+{
+    uint32_t mesh;       // modelMeshes 中的下标
+    glm::mat4 transform; // 模型空间到场景空间的变换
+    float scale;         // transform 中的统一缩放，用于把 LOD 误差换算到场景空间
+};
+
+/**
+ *  每个网格对应的实例区间（sceneInstances 按网格分组存放）
+ * */
+struct SceneMeshInstances
+{
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+/**
+ *  一次 vkCmdDrawIndexed 的参数，以及渲染队列排序用的网格与深度
+ * */
+struct SceneDraw
+{
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t firstInstance;
+    uint32_t mesh; // modelMeshes 中的下标，决定绑定的管线与材质
+    float depth;   // 离相机最近的实例到相机的距离（场景中的观察空间），只用于排序
+};
+
+extern std::vector<SceneInstance> sceneInstances;           // 声明 场景中的所有实例（按网格分组）
+extern std::vector<SceneMeshInstances> sceneMeshInstances;  // 声明 每个网格对应的实例区间
+extern std::vector<uint32_t> sceneMeshLods;                 // 声明 当前帧每个网格选中的 LOD 级别
+extern std::vector<SceneDraw> sceneDraws;                   // 声明 当前帧需要发出的绘制
+extern MeshletCullStatistics meshletCullStatistics;         // 声明 当前帧的簇剔除统计（所有单实例网格之和）
+
+extern VkBuffer instanceBuffer;             // 声明 instance buffer 实例
+extern MemoryAllocation instanceBufferMemory; // 声明 instance buffer 对应在 GPU device 上的内存
+
+/**
+ *  场景中使用的模型文件路径
+ * */
+std::vector<std::string> getSceneModelPaths();
+
+/**
+ *  导入场景中的所有模型网格并摆放实例
+ * */
+void loadScene();
+
+/**
+ *  使用一个立方体作为占位网格（放置一个实例），真实网格在后台导入完成之前使用
+ * */
+void loadPlaceholderScene();
+
+/**
+ *  摆放实例：instanceCount 为 0 时每个网格放置一个不做变换的实例（与单模型时的效果一致），
+ *  否则把 instanceCount 个实例依次轮流使用各个网格，按网格大小归一化后排布在 XY 平面的网格上
+ * */
+void layoutSceneInstances(uint32_t instanceCount);
+
+/**
+ *  GPU上创建 Instance Buffer，并导入实例数据（需要在 createVertexBuffer() 之后调用，以获得各网格的量化参数）
+ * */
+void createInstanceBuffer();
+
+/**
+ *  注销 Instance Buffer，释放其对应的内存
+ * */
+void cleanupInstanceBuffer();
+
+/**
+ *  根据当前帧的变换阵为每个网格选择 LOD，并生成本帧的绘制列表 sceneDraws（开启 enableRenderQueueSort 时按排序键排序）
+ * */
+void updateSceneDraws();
+
+/**
+ *  实例数量逐级增加，统计每一级的平均帧耗时
+ * */
+void benchmarkScene();
+
+#endif
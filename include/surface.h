@@ -37,6 +37,7 @@ extern VkSurfaceKHR surface; // surface 全局界面实例
 
 extern VkQueue graphicsQueue; // 用于处理 “图形绘制指令” 的队列
 extern VkQueue presentQueue;  // 用于处理 “图形展示指令” 的队列
+extern VkQueue transferQueue; // 专用于数据传输的队列（可能为空）
 
 /**
  *  创建surface实例桥接窗口和渲染出的图像
@@ -21,22 +21,163 @@
 #include <array>
 #include <optional>
 #include <set>
+#include <string>
+#include <memory>
 
 #include "image_view.h"
 #include "command_buffer.h"
+#include "image/mipmap.h"
+#include "image/bc_encoder.h"
+#include "image/texture_cache.h"
+#include "image/ktx2.h"
+#include "utils/thread_pool.h"
+
+extern const std::string TEXTURE_PATH;
+extern const std::string TEXTURE_KTX2_PATH;
 
 extern uint32_t mipLevels; // 声明 当前所使用的 mipmap 等级
 
+extern VkFormat textureFormat; // 声明 纹理图像当前使用的格式（RGBA8 或 BC 压缩格式）
+
 extern VkImage textureImage;              // 声明 纹理贴图实例
-extern VkDeviceMemory textureImageMemory; // 声明 纹理贴图内存
+extern MemoryAllocation textureImageMemory; // 声明 纹理贴图内存
 extern VkImageView textureImageView;      // 声明 纹理图的 ImageView 实例
 extern VkSampler textureSampler;          // 声明 纹理图采样器实例
 
+extern const bool enableCpuMipmaps;      // 在 CPU 上生成 mip 链（关闭后使用 vkCmdBlitImage 逐级生成）
+extern const bool enableMipmapBenchmark; // 启动时对比 CPU 与 blit 两种 mipmap 生成方式的耗时
+
+extern const bool enableTextureCompression;          // 把纹理压缩为 BC 格式
+extern const bool enableTextureCache;                // 把压缩结果缓存到 .vtex 文件
+extern const bool preferBc7ForAlpha;                 // 带 alpha 的纹理使用 BC7（关闭时使用 BC3）
+extern const bool enableTextureCompressionBenchmark; // 启动时测试各 BC 格式的压缩速度与质量
+
+extern const bool enableKtx2Textures; // TEXTURE_KTX2_PATH 存在时优先从 KTX2 文件导入纹理
+extern const bool enableKtx2Export;   // 启动时把 TEXTURE_PATH 转换为 KTX2 文件（TEXTURE_KTX2_PATH）
+
+/**
+ *  释放 stb_image 解码得到的像素数据
+ * */
+void freeImagePixels(void *pixels);
+
+/**
+ *  CPU 端解码完成的 RGBA8 图像
+ * */
+struct DecodedImage
+{
+    std::unique_ptr<unsigned char, void (*)(void *)> pixels{nullptr, freeImagePixels};
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ *  CPU 端准备好、可以直接拷贝到 GPU 的纹理数据
+ * */
+struct TextureData
+{
+    VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;       // 图像的 mip 级数
+    std::vector<uint8_t> data;    // 各级别按顺序紧密排列
+    std::vector<MipLevel> levels; // 已有的级别（offset 相对于 levelData()），少于 mipLevels 时其余级别上传后由 vkCmdBlitImage 生成
+
+    MappedFile file;           // 从 KTX2 导入时直接引用映射的文件内容（此时 data 为空）
+    size_t fileDataOffset = 0; // 级别数据在映射文件中的起始位置
+    size_t fileDataSize = 0;
+
+    const uint8_t *levelData() const { return file.isOpen() ? reinterpret_cast<const uint8_t *>(file.data()) + fileDataOffset : data.data(); }
+    size_t levelDataSize() const { return file.isOpen() ? fileDataSize : data.size(); }
+};
+
+/**
+ *  解码图片文件（只涉及 CPU，可以在工作线程中调用），失败时抛出 std::runtime_error
+ * */
+DecodedImage decodeTextureImage(const std::string &path);
+
+/**
+ *  BC 格式对应的 Vulkan 格式（sRGB）
+ * */
+VkFormat getBlockCompressedVkFormat(BlockFormat format);
+
+/**
+ *  Vulkan 格式对应的 BC 格式，不是块压缩格式时返回 false
+ * */
+bool getBlockFormat(VkFormat format, BlockFormat &blockFormat);
+
+/**
+ *  由 RGBA8 像素构造未压缩的纹理数据，cpuMipmaps 为 false 时只包含第 0 级
+ * */
+TextureData makeTextureData(const unsigned char *pixels, int texWidth, int texHeight, bool cpuMipmaps);
+
+/**
+ *  准备纹理数据（只涉及 CPU，可以在工作线程中调用）：
+ *  .ktx2 文件直接映射，所有级别原样使用；其他图片需要解码、生成 mip 链，开启压缩时按 alpha 使用情况选择 BC 格式
+ * 逐级压缩，并读写 .vtex 缓存
+ * */
+TextureData prepareTextureData(const std::string &path);
+
+/**
+ *  映射并校验 KTX2 文件，级别数据不经过拷贝直接引用映射的文件
+ * */
+TextureData loadKtx2TextureData(const std::string &path);
+
+/**
+ *  实际使用的纹理路径：开启 KTX2 且 TEXTURE_KTX2_PATH 存在时使用 KTX2 文件，否则使用 TEXTURE_PATH
+ * */
+std::string resolveTexturePath();
+
+/**
+ *  把图片转换为带完整 mip 链的 KTX2 文件（格式与 prepareTextureData 的结果一致：BC 压缩或 RGBA8）
+ * */
+void exportTextureToKtx2(const std::string &sourcePath, const std::string &ktx2Path);
+
+/**
+ *  使用解码好的 RGBA8 像素创建纹理贴图实例并生成 mipmap（需要在渲染线程中调用）
+ * */
+void uploadTextureImage(const unsigned char *pixels, int texWidth, int texHeight);
+
+/**
+ *  使用准备好的纹理数据创建纹理贴图实例（需要在渲染线程中调用）
+ * */
+void uploadTextureData(TextureData texture);
+
 /**
  *  创建纹理贴图实例
  * */
 void createTextureImage();
 
+/**
+ *  检查图像格式是否支持 vkCmdBlitImage 的线性过滤
+ * */
+bool supportsLinearBlit(VkFormat imageFormat);
+
+/**
+ *  检查设备是否支持以某种 BC 格式采样（需要 textureCompressionBC 特性）
+ * */
+bool supportsBlockCompressedFormat(VkFormat imageFormat);
+
+/**
+ *  按设备能力调整纹理数据：不支持的 BC 格式在 CPU 上解码回 RGBA8，格式不支持线性 blit 时在 CPU 上生成 mip 链
+ * */
+void adaptTextureDataToDevice(TextureData &texture);
+
+/**
+ *  由纹理数据创建设备端图像，最终所有级别处于 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL 布局
+ * */
+void createTextureImageFromData(const TextureData &texture, VkImage &image, MemoryAllocation &imageMemory);
+
+/**
+ *  经由环形暂存缓冲区把纹理数据中已有的级别拷贝到图像（不等待完成）。级别完整时所有级别最终处于
+ * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL 布局，否则所有级别留在 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL 等待 generateMipmaps
+ * */
+void copyMipChainToImage(const TextureData &texture, VkImage image);
+
+/**
+ *  创建 1x1 白色的占位纹理贴图，真实纹理在后台解码完成之前使用
+ * */
+void createPlaceholderTextureImage();
+
 /**
  *  为纹理贴图创建配套的 ImageView
  * */
@@ -52,6 +193,16 @@ void createTextureSampler();
  * */
 void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
 
+/**
+ *  性能测试：对比 CPU 生成 mip 链与 vkCmdBlitImage 逐级生成两种方式的耗时
+ * */
+void benchmarkMipmapGeneration();
+
+/**
+ *  性能测试：各 BC 格式压缩整条 mip 链的速度（MPix/s）与质量（PSNR），只使用 CPU
+ * */
+void benchmarkTextureCompression();
+
 /**
  *  注销纹理贴图相关的组件
  * */
@@ -72,19 +72,58 @@
 //     glm::mat4 proj;  // 投影变换阵
 // };
 
+/*
+    Introduction 03：
+    UniformBufferObject 原先同时包含 model/view/proj，每帧整体 memcpy 一次。这样每个物体想要有自己的变换时，
+就只能为每个物体各分配一个描述符集。现在把数据按更新频率与大小分成三条路径：
+    1、UniformBufferObject 只保存整帧共用的 view/proj（binding 0，每帧一个）；
+    2、每个物体较大的数据块 ObjectUniforms 存放在一个常驻映射的大缓冲（物体环形缓冲）中，每帧占用其中一段，
+    每个物体按 minUniformBufferOffsetAlignment 对齐占用一个槽位。描述符（binding 2）的类型为
+    VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC，绑定描述符集时通过动态偏移选择物体，不需要为物体分配描述符集；
+    3、每个绘制很小且不随帧变化的数据 DrawPushConstants 通过 push constants 直接录制在命令缓冲区中。
+    这里的“物体”对应场景中的一个网格（modelMeshes 的下标），物体数量再多，每帧也不需要分配任何描述符。
+*/
+
 struct UniformBufferObject
 {
-    alignas(16) glm::mat4 model;
     alignas(16) glm::mat4 view;
     alignas(16) glm::mat4 proj;
 };
 
+/**
+ *  物体环形缓冲中每个物体的数据块（std140），每帧更新
+ * */
+struct ObjectUniforms
+{
+    alignas(16) glm::mat4 model; // 物体的模型变换（场景变换）
+};
+
+/**
+ *  每个绘制的 push constants（不超过 Vulkan 保证的 128 字节），随命令一起录制，不随帧变化
+ * */
+struct DrawPushConstants
+{
+    glm::mat4 meshTransform; // 网格局部变换（紧凑顶点格式的位置反量化），在实例变换之前作用于顶点
+    uint32_t textureIndex;   // 材质的纹理在 bindless 纹理数组中的下标（片段着色器使用）
+    uint32_t reserved[3];
+};
+
+extern const uint32_t OBJECT_UNIFORM_CAPACITY; // 物体环形缓冲中每帧可以容纳的物体数量
+
 extern VkDescriptorSetLayout descriptorSetLayout;
 
+extern glm::mat4 frameModelMatrix; // 声明 当前帧的场景变换阵（不含实例变换），供CPU端剔除使用
+extern glm::mat4 frameViewMatrix;  // 声明 当前帧的视口变换阵
+extern glm::mat4 frameProjMatrix;  // 声明 当前帧的投影变换阵（已做Y轴翻转）
+
 extern std::vector<VkBuffer> uniformBuffers;
-extern std::vector<VkDeviceMemory> uniformBuffersMemory;
+extern std::vector<MemoryAllocation> uniformBuffersMemory;
 extern std::vector<void *> uniformBuffersMapped; // 这个是做什么的？没有看懂
 
+extern VkBuffer objectUniformBuffer;             // 声明 物体环形缓冲
+extern MemoryAllocation objectUniformBufferMemory; // 声明 物体环形缓冲对应的常驻映射内存
+extern VkDeviceSize objectUniformStride;           // 声明 每个物体槽位的大小（按 minUniformBufferOffsetAlignment 对齐）
+
 extern VkDescriptorPool descriptorPool;
 extern std::vector<VkDescriptorSet> descriptorSets;
 
@@ -94,10 +133,15 @@ extern std::vector<VkDescriptorSet> descriptorSets;
 void createDescriptorSetLayout();
 
 /**
- *  创建 uniform buffer，为存储的 MVP 变换阵分配内存。
+ *  创建 uniform buffer，为存储的 MVP 变换阵分配内存（包括物体环形缓冲）。
  * */
 void createUniformBuffers();
 
+/**
+ *  物体在本帧物体环形缓冲段中的动态偏移（作为 vkCmdBindDescriptorSets 的 pDynamicOffsets）
+ * */
+uint32_t getObjectUniformOffset(uint32_t object);
+
 /**
  *  创建 descriptor pool
  * */
@@ -109,7 +153,13 @@ void createDescriptorPool();
 void createDescriptorSets();
 
 /**
- * 根据当前帧信息，更新 MVP 变换阵。并将变换阵携带的数据拷贝到预先创建好的GPU内存上。
+ *  纹理贴图被替换后，更新所有描述符集中的纹理绑定
+ * */
+void updateTextureDescriptors();
+
+/**
+ * 根据当前帧信息，更新 MVP 变换阵。并将变换阵携带的数据拷贝到预先创建好的GPU内存上（view/proj 写入 uniform buffer，
+ * 各物体的模型变换写入物体环形缓冲中本帧的一段）。
  * draw time 运行时函数。
  * */
 void updateUniformBuffer(uint32_t currentImage);
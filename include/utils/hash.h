@@ -0,0 +1,117 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/*
+    Introduction：
+    std::hash 对整数基本就是恒等映射，glm 的 hash 也只是把各分量的 std::hash 简单组合，对网格这种数值规律性很强
+的数据分布很差。这里提供一个 wyhash 风格的 64 位哈希（基于 64x64->128 位乘法混合），速度接近内存带宽，
+同时具有很好的雪崩效果，可以用于文件内容校验与哈希表。
+*/
+
+namespace hash_detail
+{
+    const uint64_t WY_SECRET[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+    inline void wyMum(uint64_t &a, uint64_t &b)
+    {
+        __uint128_t r = static_cast<__uint128_t>(a) * b;
+        a = static_cast<uint64_t>(r);
+        b = static_cast<uint64_t>(r >> 64);
+    }
+
+    inline uint64_t wyMix(uint64_t a, uint64_t b)
+    {
+        wyMum(a, b);
+        return a ^ b;
+    }
+
+    inline uint64_t wyRead8(const uint8_t *p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+    inline uint64_t wyRead4(const uint8_t *p)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    inline uint64_t wyRead3(const uint8_t *p, size_t k)
+    {
+        return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+    }
+}
+
+/**
+ *  对任意一段内存计算 64 位哈希
+ * */
+inline uint64_t hashBytes(const void *key, size_t len, uint64_t seed = 0)
+{
+    using namespace hash_detail;
+    const uint8_t *p = static_cast<const uint8_t *>(key);
+    seed ^= wyMix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+    uint64_t a, b;
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            a = (wyRead4(p) << 32) | wyRead4(p + ((len >> 3) << 2));
+            b = (wyRead4(p + len - 4) << 32) | wyRead4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0)
+        {
+            a = wyRead3(p, len);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        size_t i = len;
+        if (i > 48)
+        {
+            uint64_t see1 = seed, see2 = seed;
+            do
+            {
+                seed = wyMix(wyRead8(p) ^ WY_SECRET[1], wyRead8(p + 8) ^ seed);
+                see1 = wyMix(wyRead8(p + 16) ^ WY_SECRET[2], wyRead8(p + 24) ^ see1);
+                see2 = wyMix(wyRead8(p + 32) ^ WY_SECRET[3], wyRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = wyMix(wyRead8(p) ^ WY_SECRET[1], wyRead8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wyRead8(p + i - 16);
+        b = wyRead8(p + i - 8);
+    }
+    a ^= WY_SECRET[1];
+    b ^= seed;
+    wyMum(a, b);
+    return wyMix(a ^ WY_SECRET[0] ^ len, b ^ WY_SECRET[1]);
+}
+
+/**
+ *  合并两个 64 位哈希值
+ * */
+inline uint64_t hashCombine(uint64_t a, uint64_t b)
+{
+    return hash_detail::wyMix(a ^ hash_detail::WY_SECRET[0], b ^ hash_detail::WY_SECRET[1]);
+}
+
+#endif
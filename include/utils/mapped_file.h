@@ -0,0 +1,47 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    Introduction：
+    对大文件（模型/纹理/缓存）使用 ifstream 逐字节读入需要一次完整的内核到用户态拷贝。这里使用 mmap
+将文件直接映射到进程地址空间，由操作系统按需分页读入，解析代码可以像访问一块内存一样直接访问文件内容。
+*/
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    /**
+     *  以只读方式映射整个文件，失败时抛出 std::runtime_error
+     * */
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    const char *data() const { return static_cast<const char *>(mapped); }
+    size_t size() const { return mappedSize; }
+    bool isOpen() const { return mapped != nullptr || opened; }
+
+    /**
+     *  解除映射，关闭文件
+     * */
+    void close();
+
+private:
+    void *mapped = nullptr;
+    size_t mappedSize = 0;
+    bool opened = false;
+};
+
+#endif
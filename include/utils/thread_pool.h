@@ -0,0 +1,74 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <exception>
+#include <algorithm>
+
+/*
+    Introduction：
+    模型解析/顶点去重/纹理压缩等CPU端的预处理工作都可以按数据切块并行执行。这里提供一个简单的常驻线程池，
+线程在程序运行期间只创建一次，之后所有并行任务都投递到这里，避免反复创建/销毁线程的开销。
+    parallelFor 会让调用线程本身也参与执行，所以在工作线程内部再次调用 parallelFor 也不会死锁。
+*/
+
+class ThreadPool
+{
+public:
+    /**
+     *  threadCount 为 0 时使用 std::thread::hardware_concurrency() - 1 个工作线程（调用线程本身也会参与计算）
+     * */
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     *  工作线程数量（不包括调用线程）
+     * */
+    size_t size() const { return workers.size(); }
+
+    /**
+     *  并发度：工作线程数量 + 调用线程
+     * */
+    size_t concurrency() const { return workers.size() + 1; }
+
+    /**
+     *  对 [0, taskCount) 中的每个下标执行一次 task，阻塞直到全部完成。
+     *  任意一个 task 抛出的异常会在全部任务结束后于调用线程重新抛出。
+     * */
+    void parallelFor(size_t taskCount, const std::function<void(size_t)> &task);
+
+    /**
+     *  投递一个异步任务，不等待其完成
+     * */
+    void enqueue(std::function<void()> job);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex jobsMutex;
+    std::condition_variable jobsCondition;
+    bool stopping = false;
+};
+
+/**
+ *  获取全局共享的线程池（首次调用时创建）
+ * */
+ThreadPool &getThreadPool();
+
+#endif
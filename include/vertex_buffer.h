@@ -28,9 +28,29 @@
 
 
 extern const std::string MODEL_PATH;
-extern const std::string TEXTURE_PATH;
+extern const bool enableModelLoadBenchmark;
+extern const bool enableMeshCache;
+extern const bool enableMeshOptimization;
+extern const bool enableMeshletCulling;
+extern const bool enableMeshLod;
+extern const bool enableLodErrorValidation;
+extern const std::vector<float> LOD_TRIANGLE_RATIOS;
+extern const float LOD_MAX_RELATIVE_ERROR;
+extern const float LOD_PIXEL_ERROR_THRESHOLD;
+extern const bool enableDedupBenchmark;
+extern const bool enableParallelDedup;
+extern const size_t PARALLEL_DEDUP_MIN_CORNERS;
 
 #include "buffers/buffers_operation.h"
+#include "buffers/staging_ring.h"
+#include "model/obj_parser.h"
+#include "model/mesh_cache.h"
+#include "model/vertex_dedup.h"
+#include "model/mesh_optimizer.h"
+#include "model/quantization.h"
+#include "model/vertex_format.h"
+#include "model/meshlet.h"
+#include "model/simplifier.h"
 
 /*
     Introduction 01：
@@ -146,6 +166,120 @@ struct Vertex
     }
 };
 
+/*
+    Introduction 05：
+    Vertex 使用 32 字节存储一个顶点，其中 color 在 loadModel() 中永远是 {1,1,1}，白白占用了 12 字节的带宽。
+    PackedVertex 是一个紧凑的量化顶点格式：
+    1、位置相对于网格的包围盒（AABB）量化为 UNORM16，反量化（平移 + 缩放）作为每个绘制的 push constants
+    （DrawPushConstants::meshTransform）传入，GPU 剔除时直接合并进实例变换阵；
+    2、UV 相对于 UV 的包围盒量化为 UNORM16（纹理坐标可能超出 [0, 1]，例如重复贴图），在顶点着色器中通过
+    InstanceData::texCoordTransform 还原；
+    3、颜色为可选的 RGBA8，不需要顶点颜色时整个颜色字段都不会上传，顶点大小为 12 字节（原来的 3/8），
+    带颜色时为 16 字节（原来的一半）；
+    4、位置的 w 分量目前保留为 0，之后用于存放八面体编码的法线。
+    每个网格使用的格式记录在 ModelMesh::vertexFormat 中，对应的 vertex input 与顶点着色器（vert_packed*.spv）需要一起
+切换：createGraphicsPipeline() 为每种格式各创建一条图形管线（编号与 VertexFormat 相同），createVertexBuffer() 按网格的
+格式设置 ModelMesh::pipeline，渲染队列的排序键把同一管线的绘制排在一起（见 render_queue.h）。所有网格仍然共用一个
+vertex buffer，每个网格的起始字节偏移按各自的顶点大小对齐，baseVertex 即为偏移除以顶点大小。
+*/
+
+extern const VertexFormat MODEL_VERTEX_FORMAT; // 声明 新建网格默认使用的顶点格式
+
+/**
+ *  量化后的 vertex 结构体
+ * */
+struct PackedVertex
+{
+    uint16_t pos[4];      // 包围盒内的相对位置，UNORM16；w 分量预留给八面体法线
+    uint16_t texCoord[2]; // UV 包围盒内的相对坐标，UNORM16
+    uint8_t color[4];     // 顶点颜色 RGBA8，仅 VERTEX_FORMAT_PACKED_COLOR 使用
+
+    /**
+     *  顶点步长：不含颜色时颜色字段不会被上传
+     * */
+    static uint32_t getStride(VertexFormat format)
+    {
+        return format == VERTEX_FORMAT_PACKED_COLOR ? sizeof(PackedVertex) : offsetof(PackedVertex, color);
+    }
+
+    static VkVertexInputBindingDescription getBindingDescription(VertexFormat format)
+    {
+        VkVertexInputBindingDescription bindingDescription{};
+
+        bindingDescription.binding = 0;
+        bindingDescription.stride = getStride(format);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return bindingDescription;
+    }
+
+    static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions(VertexFormat format)
+    {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+
+        // pos vec4（w 预留）
+        VkVertexInputAttributeDescription position{};
+        position.binding = 0;
+        position.location = 0;
+        position.format = VK_FORMAT_R16G16B16A16_UNORM;
+        position.offset = offsetof(PackedVertex, pos);
+        attributeDescriptions.push_back(position);
+
+        // color vec4，与 Vertex 使用相同的 location，不含颜色时着色器中使用常量白色
+        if (format == VERTEX_FORMAT_PACKED_COLOR)
+        {
+            VkVertexInputAttributeDescription color{};
+            color.binding = 0;
+            color.location = 1;
+            color.format = VK_FORMAT_R8G8B8A8_UNORM;
+            color.offset = offsetof(PackedVertex, color);
+            attributeDescriptions.push_back(color);
+        }
+
+        // texCoord vec2
+        VkVertexInputAttributeDescription texCoord{};
+        texCoord.binding = 0;
+        texCoord.location = 2;
+        texCoord.format = VK_FORMAT_R16G16_UNORM;
+        texCoord.offset = offsetof(PackedVertex, texCoord);
+        attributeDescriptions.push_back(texCoord);
+
+        return attributeDescriptions;
+    }
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must be 16 bytes");
+
+/**
+ *  网格量化参数：反量化公式为 value = offset + q * scale
+ * */
+struct MeshQuantization
+{
+    glm::vec3 positionOffset{0.0f};
+    glm::vec3 positionScale{1.0f};
+    glm::vec2 texCoordOffset{0.0f};
+    glm::vec2 texCoordScale{1.0f};
+
+    /**
+     *  位置反量化对应的变换阵，需要右乘到模型变换阵上
+     * */
+    glm::mat4 getPositionTransform() const
+    {
+        return glm::scale(glm::translate(glm::mat4(1.0f), positionOffset), positionScale);
+    }
+
+    /**
+     *  UV 反量化参数，xy 为偏移，zw 为缩放
+     * */
+    glm::vec4 getTexCoordTransform() const
+    {
+        return glm::vec4(texCoordOffset, texCoordScale);
+    }
+};
+
+// VertexDedupTable 直接对 Vertex 的原始比特做哈希/比较，要求结构体中没有填充字节
+static_assert(sizeof(Vertex) == 8 * sizeof(float), "Vertex must not contain padding");
+
 /*
     第八步，
     同样是配合第七步中 unordered_map 的使用，需要为其创建一个特殊的哈希查找函数
@@ -165,21 +299,72 @@ namespace std
     };
 }
 
-extern std::vector<Vertex> vertices;      // 声明 存储在CPU内存上的“顶点”源数据
+/**
+ *  一个导入到 GPU 上的模型网格，所有网格的顶点/索引依次存放在同一个 vertex buffer / index buffer 中
+ * */
+struct ModelMesh
+{
+    std::string path; // 模型文件路径
+
+    std::vector<Vertex> vertices;  // 存储在CPU内存上的“顶点”源数据（命中缓存时为空）
+    std::vector<uint32_t> indices; // 存储在CPU内存上的“顶点索引”源数据，依次包含所有 LOD 级别（命中缓存时为空）
+    MeshCache cache;               // 模型对应的 .vmesh 缓存（命中时顶点/索引数据直接从这里读取）
+
+    uint32_t vertexCount = 0; // 顶点数量（无论是否命中缓存都有效）
+    uint32_t indexCount = 0;  // 索引数量（无论是否命中缓存都有效）
+    uint32_t baseVertex = 0;  // 在 vertex buffer 中的起始顶点（以本网格的顶点大小为单位），作为 vkCmdDrawIndexed 的 vertexOffset
+    uint32_t firstIndex = 0;  // 在 index buffer 中的起始位置
+
+    VertexFormat vertexFormat = MODEL_VERTEX_FORMAT; // 上传到 vertex buffer 时使用的顶点格式
+    MeshQuantization quantization;               // 顶点的量化参数（VERTEX_FORMAT_FLOAT 时为恒等变换）
+    std::vector<MeshLod> lods;                   // LOD 链，indexOffset 相对 firstIndex
+    glm::vec4 boundingSphere = glm::vec4(0.0f); // 模型空间下的包围球（xyz 为球心，w 为半径）
+
+    uint32_t pipeline = 0; // 渲染队列中的管线编号，由 createVertexBuffer() 按 vertexFormat 设置（见 render_queue.h）
+    uint32_t material = 0; // 渲染队列中的材质编号
+
+    std::vector<Meshlet> meshlets;          // 簇划分，indexOffset 相对 firstIndex
+    std::vector<uint32_t> lodMeshletOffsets; // 每个 LOD 级别在 meshlets 中的起始位置（最后一项为簇总数）
+
+    const Vertex *vertexData() const { return cache.isOpen() ? static_cast<const Vertex *>(cache.vertexData()) : vertices.data(); }
+    const uint32_t *indexData() const { return cache.isOpen() ? cache.indexData() : indices.data(); }
+};
+
+extern std::vector<ModelMesh> modelMeshes; // 声明 场景中用到的所有模型网格
+
 extern VkBuffer vertexBuffer;             // 声明 vertex buffer 实例
-extern VkDeviceMemory vertexBufferMemory; // 声明 vertex buffer 对应在 GPU device 上的内存
+extern MemoryAllocation vertexBufferMemory; // 声明 vertex buffer 对应在 GPU device 上的内存
 
-extern std::vector<uint32_t> indices;    // 声明 存储在CPU内存上的“顶点索引”源数据
 extern VkBuffer indexBuffer;             // 声明 index buffer 实例
-extern VkDeviceMemory indexBufferMemory; // 声明 index buffer 对应在 GPU device 上的内存
+extern MemoryAllocation indexBufferMemory; // 声明 index buffer 对应在 GPU device 上的内存
+
+/**
+ *  各顶点格式对应的顶点大小
+ * */
+uint32_t getVertexStride(VertexFormat format);
 
 /**
- *  GPU上创建 Vertex Buffer，并导入顶点数据
+ *  计算一组顶点的量化参数（位置与 UV 的包围盒），VERTEX_FORMAT_FLOAT 时返回单位变换
+ * */
+MeshQuantization computeMeshQuantization(const Vertex *source, size_t count, VertexFormat format);
+
+/**
+ *  按给定的量化参数把 Vertex 写为 format 指定的紧凑格式（可以分段调用，各段使用同一组参数）
+ * */
+void packVertices(const Vertex *source, size_t count, VertexFormat format, const MeshQuantization &quantization, void *destination);
+
+/**
+ *  将 Vertex 量化为 format 指定的紧凑格式，写入 destination（按 getVertexStride(format) 排布），并输出量化参数
+ * */
+void quantizeVertices(const Vertex *source, size_t count, VertexFormat format, void *destination, MeshQuantization &quantization);
+
+/**
+ *  GPU上创建 Vertex Buffer，并依次导入所有模型网格的顶点数据（同时确定各网格的 baseVertex、管线编号与量化参数）
  * */
 void createVertexBuffer();
 
 /**
- *  GPU上创建 Index Buffer，并导入顶点索引数据
+ *  GPU上创建 Index Buffer，并依次导入所有模型网格的顶点索引数据（同时确定各网格的 firstIndex）
  * */
 void createIndexBuffer();
 
@@ -194,8 +379,48 @@ void cleanupVertexBuffer();
 void cleanupIndexBuffer();
 
 /**
- *  模型文件导入
+ *  导入一个模型网格（优先使用 .vmesh 缓存），并生成 LOD 链、包围球与簇划分
+ * */
+void loadModelMesh(const std::string &path, ModelMesh &mesh);
+
+/**
+ *  计算网格在模型空间下的包围球
+ * */
+void computeMeshBounds(ModelMesh &mesh);
+
+/**
+ *  由 LOD0 逐级简化生成 LOD 链（按 LOD_TRIANGLE_RATIOS），各级索引追加到 meshIndices 末尾
+ * */
+void generateModelLods(const std::vector<Vertex> &meshVertices, std::vector<uint32_t> &meshIndices, std::vector<MeshLod> &lods);
+
+/**
+ *  对网格的每个 LOD 级别做簇划分
+ * */
+void buildMeshMeshlets(ModelMesh &mesh);
+
+/**
+ *  顶点缓存/顶点获取顺序优化（三角形重排 + 顶点重排），输出优化前后的 ACMR/ATVR
+ * */
+void optimizeModelMesh(std::vector<Vertex> &meshVertices, std::vector<uint32_t> &meshIndices);
+
+/**
+ *  使用 mmap + 多线程 OBJ 解析器导入指定模型文件，结果追加到 outVertices/outIndices
+ * */
+void loadModelFromFile(const std::string &path, std::vector<Vertex> &outVertices, std::vector<uint32_t> &outIndices);
+
+/**
+ *  使用 tinyobj 导入指定模型文件（原始实现）
+ * */
+void loadModelWithTinyObj(const std::string &path, std::vector<Vertex> &outVertices, std::vector<uint32_t> &outIndices);
+
+/**
+ *  对比 tinyobj 与多线程解析器的模型导入耗时
+ * */
+void benchmarkModelLoading();
+
+/**
+ *  对比 std::unordered_map 与 VertexDedupTable 的顶点去重吞吐量
  * */
-void loadModel();
+void benchmarkVertexDedup();
 
 #endif
\ No newline at end of file
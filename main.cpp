@@ -25,6 +25,18 @@ int main()
 
     imguiSetup();
 
+    if (enableSceneBenchmark)
+    {
+        // 测试需要真实的模型网格
+        finishAssetStreaming();
+        benchmarkScene();
+    }
+    if (enableCommandRecordingBenchmark)
+    {
+        finishAssetStreaming();
+        benchmarkCommandRecording();
+    }
+
     while (!glfwWindowShouldClose(window))
     {
         glfwPollEvents();
@@ -1,2 +0,0 @@
-glslc vertex_shader.vert -o vert.spv
-glslc fragment_shader.frag -o frag.spv
\ No newline at end of file
@@ -11,6 +11,11 @@
 
 #version 450
 
+#ifdef BINDLESS_TEXTURES
+// 运行时大小的纹理数组（textures[]）需要这个扩展
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
 
 /*
     不同于vertex shader，fragment shader中没有内置的输入输出变量，需要我们
@@ -24,7 +29,16 @@ layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord; // 第七步，承接来自Vertex buffer的UV坐标
 
 // 第八步，我们将添加对纹理的采样（从 uniform buffer 中）
+#ifdef BINDLESS_TEXTURES
+// bindless 模式：所有纹理在 set 1 的纹理数组中，材质的纹理下标通过 push constants 传入（位于网格局部变换之后）
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform DrawPushConstants {
+    layout(offset = 64) uint textureIndex;
+} draw;
+#else
 layout(binding = 1) uniform sampler2D texSampler;
+#endif
 
 // 如果vertex shader中给出了输出的顶点颜色，我们需要定义一个变量进行承接
 layout(location = 0) out vec4 outColor;
@@ -45,5 +59,10 @@ void main() {
         第十步，
         如果你想看到原定义颜色与纹理采样叠加的效果，可以进行如下修改
     */ 
+#ifdef BINDLESS_TEXTURES
+    // 同一次绘制中 textureIndex 是一致的（dynamically uniform），不需要 nonuniformEXT
+    outColor = vec4(fragColor * texture(textures[draw.textureIndex], fragTexCoord).rgb, 1.0);
+#else
     outColor = vec4(fragColor * texture(texSampler, fragTexCoord).rgb, 1.0);
+#endif
 }
@@ -9,12 +9,20 @@
 
 
 layout(binding = 0) uniform UniformBufferObject {
-    // vec2 foo;
-    mat4 model;
     mat4 view;
     mat4 proj;
 } ubo;
 
+// 物体环形缓冲中当前物体的数据块（动态偏移选择物体）
+layout(binding = 2) uniform ObjectUniforms {
+    mat4 model;
+} objectData;
+
+// 每个绘制的网格局部变换
+layout(push_constant) uniform DrawPushConstants {
+    mat4 meshTransform;
+} draw;
+
 
 
 // 这里对应的就是C++中写的 verteies
@@ -24,6 +32,10 @@ layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;       // 实际顶点颜色
 layout(location = 2) in vec2 inTexCoord;    // 顶点对应UV坐标（这是新添加的）
 
+// 实例数据（binding 1，每个实例前进一次）：实例变换占用 location 3~6，location 7 为 UV 变换（浮点格式下为恒等变换）
+layout(location = 3) in mat4 inInstanceModel;
+layout(location = 7) in vec4 inInstanceTexCoordTransform;
+
 layout(location = 0) out vec3 fragColor;    // 着色器输出颜色
 layout(location = 1) out vec2 fragTexCoord; // 片段对应的纹理坐标（这是新添加的）
 
@@ -40,7 +52,7 @@ layout(location = 1) out vec2 fragTexCoord; // 片段对应的纹理坐标（这
 
 void main() {
     // gl_Position 是默认变量，输出到vertex shader，以下这里应用了mvp变换
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * objectData.model * inInstanceModel * draw.meshTransform * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord; // 同样，我们将UV值也传给后面的fragment shader
 }
\ No newline at end of file
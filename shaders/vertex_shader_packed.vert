@@ -0,0 +1,49 @@
+/*
+    紧凑顶点格式（PackedVertex）对应的顶点着色器。
+    位置与UV都以 UNORM16 的形式存储，硬件读取时已经自动转换到 [0, 1]：
+    1、位置的反量化（包围盒平移 + 缩放）通过 push constants 的 meshTransform 传入（GPU 剔除时已在CPU端合并进每个实例的变换阵）；
+    2、UV 的反量化参数随实例数据传入（不同网格的量化参数不同）。
+    使用 -DPACKED_VERTEX_COLOR 编译时从顶点中读取 RGBA8 颜色，否则顶点颜色为常量白色。
+*/
+#version 450
+
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+// 物体环形缓冲中当前物体的数据块（动态偏移选择物体）
+layout(binding = 2) uniform ObjectUniforms {
+    mat4 model;
+} objectData;
+
+// 每个绘制的网格局部变换
+layout(push_constant) uniform DrawPushConstants {
+    mat4 meshTransform;
+} draw;
+
+
+layout(location = 0) in vec4 inPosition;    // R16G16B16A16_UNORM，w 分量预留给八面体法线
+#ifdef PACKED_VERTEX_COLOR
+layout(location = 1) in vec4 inColor;       // R8G8B8A8_UNORM
+#endif
+layout(location = 2) in vec2 inTexCoord;    // R16G16_UNORM
+
+// 实例数据（binding 1）
+layout(location = 3) in mat4 inInstanceModel;             // 实例变换（GPU 剔除时合并了位置反量化）
+layout(location = 7) in vec4 inInstanceTexCoordTransform; // xy: UV 偏移，zw: UV 缩放
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+
+
+void main() {
+    gl_Position = ubo.proj * ubo.view * objectData.model * inInstanceModel * draw.meshTransform * vec4(inPosition.xyz, 1.0);
+#ifdef PACKED_VERTEX_COLOR
+    fragColor = inColor.rgb;
+#else
+    fragColor = vec3(1.0);
+#endif
+    fragTexCoord = inInstanceTexCoordTransform.xy + inTexCoord * inInstanceTexCoordTransform.zw;
+}
@@ -0,0 +1,157 @@
+#include "asset_streaming.h"
+
+// 是否在后台线程中加载模型与纹理（关闭时在 initVulkan() 中同步加载）
+const bool enableAssetStreaming = true;
+
+// 程序启动时间（静态初始化发生在 main() 之前），作为首帧/完整画质时间的起点
+const std::chrono::high_resolution_clock::time_point applicationStartTime = std::chrono::high_resolution_clock::now();
+
+std::future<std::vector<ModelMesh>> meshStreamingTask; // 后台模型导入任务
+std::future<TextureData> textureStreamingTask;         // 后台纹理解码/压缩任务
+
+bool firstFramePresented = false;   // 是否已经呈现过第一帧
+bool fullQualityPending = !enableAssetStreaming; // 所有真实资源均已替换，等待下一次呈现（同步加载时首帧即为完整画质）
+bool fullQualityPresented = false;  // 是否已经呈现过完整画质的帧
+
+/**
+ *  启动至今的毫秒数
+ * */
+static double millisecondsSinceStart()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - applicationStartTime).count();
+}
+
+/**
+ *  启动后台加载任务
+ * */
+void startAssetStreaming()
+{
+    /*
+        使用 std::async 为两个任务各开一个线程：模型导入内部会用线程池做并行解析/去重（parallelFor 允许调用线程
+    参与执行），这里不能占用线程池的工作线程去等待线程池本身。
+    */
+    const std::vector<std::string> paths = getSceneModelPaths();
+    meshStreamingTask = std::async(std::launch::async, [paths]()
+                                   {
+                                       std::vector<ModelMesh> meshes(paths.size());
+                                       for (size_t i = 0; i < paths.size(); i++)
+                                       {
+                                           loadModelMesh(paths[i], meshes[i]);
+                                       }
+                                       return meshes;
+                                   });
+    textureStreamingTask = std::async(std::launch::async, []()
+                                      { return prepareTextureData(resolveTexturePath()); });
+}
+
+/**
+ *  模型导入完成：上传新的顶点/索引/实例数据并替换占位网格
+ * */
+static void swapInMeshes(std::vector<ModelMesh> meshes)
+{
+    // 占位资源可能刚上传、还没有被任何一帧 acquire
+    flushUploadAcquires();
+    vkDeviceWaitIdle(device);
+    cleanupInstanceBuffer();
+    cleanupIndexBuffer();
+    cleanupVertexBuffer();
+
+    modelMeshes = std::move(meshes);
+    layoutSceneInstances(enableInstancedScene ? SCENE_INSTANCE_COUNT : 0);
+
+    // 三个缓冲区的上传合并为一次提交
+    beginUploadBatch();
+    createVertexBuffer();
+    createIndexBuffer();
+    createInstanceBuffer();
+    endUploadBatch();
+    invalidateCommandBuffers();
+    std::cout << "asset streaming: meshes ready at " << millisecondsSinceStart() << " ms" << std::endl;
+}
+
+/**
+ *  纹理准备完成：上传纹理、重建 ImageView/采样器（格式与 mipmap 等级变化）并更新描述符集
+ * */
+static void swapInTexture(TextureData texture)
+{
+    // 占位资源可能刚上传、还没有被任何一帧 acquire
+    flushUploadAcquires();
+    vkDeviceWaitIdle(device);
+    cleanupTextureRelated();
+
+    uploadTextureData(std::move(texture));
+    createTextureImageView();
+    createTextureSampler();
+    updateTextureDescriptors();
+    invalidateCommandBuffers();
+    std::cout << "asset streaming: texture ready at " << millisecondsSinceStart() << " ms" << std::endl;
+}
+
+/**
+ *  检查单个后台任务，就绪时取出结果并执行替换，get() 会把后台线程中抛出的异常重新抛出
+ * */
+template <typename T, typename Swap>
+static void pollTask(std::future<T> &task, bool wait, Swap swap)
+{
+    if (!task.valid())
+    {
+        return;
+    }
+    if (!wait && task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return;
+    }
+    swap(task.get());
+}
+
+/**
+ *  检查后台任务，已就绪的资源上传到 GPU 并替换占位资源
+ * */
+static void updateAssetStreaming(bool wait)
+{
+    bool streaming = meshStreamingTask.valid() || textureStreamingTask.valid();
+    if (!streaming)
+    {
+        return;
+    }
+
+    pollTask(meshStreamingTask, wait, [](std::vector<ModelMesh> meshes)
+             { swapInMeshes(std::move(meshes)); });
+    pollTask(textureStreamingTask, wait, [](TextureData texture)
+             { swapInTexture(std::move(texture)); });
+
+    if (!meshStreamingTask.valid() && !textureStreamingTask.valid())
+    {
+        fullQualityPending = true;
+    }
+}
+
+void pollAssetStreaming()
+{
+    updateAssetStreaming(false);
+}
+
+/**
+ *  阻塞等待所有后台任务完成并替换占位资源
+ * */
+void finishAssetStreaming()
+{
+    updateAssetStreaming(true);
+}
+
+/**
+ *  每帧呈现后调用，用于统计首帧时间与完整画质时间
+ * */
+void onFramePresented()
+{
+    if (!firstFramePresented)
+    {
+        firstFramePresented = true;
+        std::cout << "time to first frame: " << millisecondsSinceStart() << " ms" << std::endl;
+    }
+    if (fullQualityPending && !fullQualityPresented)
+    {
+        fullQualityPresented = true;
+        std::cout << "time to full quality: " << millisecondsSinceStart() << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,211 @@
+#include "bindless_textures.h"
+
+#include "texture.h"
+
+const bool enableBindlessTextures = true;
+const uint32_t BINDLESS_TEXTURE_CAPACITY = 1024;
+const uint32_t BINDLESS_MAIN_TEXTURE = 0;
+bool bindlessTexturesActive = false;
+uint32_t bindlessTextureCapacity = 0;
+
+VkDescriptorSetLayout bindlessDescriptorSetLayout = VK_NULL_HANDLE;
+VkDescriptorPool bindlessDescriptorPool = VK_NULL_HANDLE;
+VkDescriptorSet bindlessDescriptorSet = VK_NULL_HANDLE;
+
+uint32_t bindlessTextureCount = 0;                                      // 纹理数组中已经使用的槽位数
+std::vector<uint32_t> materialTextureIndices = {BINDLESS_MAIN_TEXTURE}; // 每种材质的纹理下标，材质 0 使用主纹理
+
+/**
+ *  设备允许的纹理数组大小：combined image sampler 同时计入 sampler 与 sampled image 两类 update-after-bind 上限，
+ * 每阶段的上限还要扣除 set 0 中片段着色器使用的那一个
+ * */
+static uint32_t queryBindlessTextureLimit()
+{
+    VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+    vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &vulkan12Properties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+    uint32_t perStage = std::min(vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                 vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages);
+    uint32_t perSet = std::min(vulkan12Properties.maxDescriptorSetUpdateAfterBindSamplers,
+                               vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages);
+    return std::min(perStage > 0 ? perStage - 1 : 0, perSet);
+}
+
+/**
+ *  创建纹理数组的描述符布局
+ * */
+void createBindlessTextureLayout()
+{
+    bindlessTexturesActive = enableBindlessTextures && descriptorIndexingEnabled;
+    if (!bindlessTexturesActive)
+    {
+        if (enableBindlessTextures)
+        {
+            std::cout << "bindless textures: descriptor indexing is not supported, using one texture per descriptor set" << std::endl;
+        }
+        return;
+    }
+
+    bindlessTextureCapacity = std::min(BINDLESS_TEXTURE_CAPACITY, queryBindlessTextureLimit());
+    if (bindlessTextureCapacity == 0)
+    {
+        bindlessTexturesActive = false;
+        std::cout << "bindless textures: no update-after-bind texture slots available, using one texture per descriptor set" << std::endl;
+        return;
+    }
+
+    VkDescriptorSetLayoutBinding textureBinding{};
+    textureBinding.binding = 0;
+    textureBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    textureBinding.descriptorCount = bindlessTextureCapacity;
+    textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    textureBinding.pImmutableSamplers = nullptr;
+
+    /*
+        PARTIALLY_BOUND：只写入了一部分槽位，着色器不访问的槽位可以保持未写入；
+        UPDATE_AFTER_BIND：描述符集绑定到命令缓冲区之后仍然可以写入（写入时命令缓冲区不能在执行中，
+    替换纹理的 swapInTexture() 在写入前已经等待设备空闲）。
+    */
+    VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &textureBinding;
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &bindlessDescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless descriptor set layout!");
+    }
+    std::cout << "bindless textures: " << bindlessTextureCapacity << " texture slots" << std::endl;
+}
+
+/**
+ *  创建纹理数组的描述符集，并把当前的纹理写入 BINDLESS_MAIN_TEXTURE
+ * */
+void createBindlessTextureSet()
+{
+    if (!bindlessTexturesActive)
+    {
+        return;
+    }
+
+    // UPDATE_AFTER_BIND 的布局只能从带 UPDATE_AFTER_BIND 标志的池中分配
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = bindlessTextureCapacity;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 1;
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &bindlessDescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = bindlessDescriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &bindlessDescriptorSetLayout;
+    if (vkAllocateDescriptorSets(device, &allocInfo, &bindlessDescriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate bindless descriptor set!");
+    }
+
+    bindlessTextureCount = 0;
+    if (registerBindlessTexture(textureImageView, textureSampler) != BINDLESS_MAIN_TEXTURE)
+    {
+        throw std::runtime_error("unexpected bindless index for the main texture!");
+    }
+}
+
+/**
+ *  把一张纹理加入纹理数组，返回它的下标
+ * */
+uint32_t registerBindlessTexture(VkImageView imageView, VkSampler sampler)
+{
+    if (bindlessTextureCount >= bindlessTextureCapacity)
+    {
+        throw std::runtime_error("bindless texture array is full!");
+    }
+    uint32_t index = bindlessTextureCount++;
+    writeBindlessTexture(index, imageView, sampler);
+    return index;
+}
+
+/**
+ *  写入纹理数组中的一个槽位
+ * */
+void writeBindlessTexture(uint32_t index, VkImageView imageView, VkSampler sampler)
+{
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = sampler;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = bindlessDescriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = index;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+}
+
+/**
+ *  新增一种材质，返回材质编号
+ * */
+uint32_t createBindlessMaterial(uint32_t textureIndex)
+{
+    if (textureIndex >= bindlessTextureCount)
+    {
+        throw std::runtime_error("material references an unregistered bindless texture!");
+    }
+    materialTextureIndices.push_back(textureIndex);
+    return static_cast<uint32_t>(materialTextureIndices.size() - 1);
+}
+
+/**
+ *  材质使用的纹理在纹理数组中的下标
+ * */
+uint32_t getMaterialTextureIndex(uint32_t material)
+{
+    if (material >= materialTextureIndices.size())
+    {
+        throw std::runtime_error("unknown render material!");
+    }
+    return materialTextureIndices[material];
+}
+
+/**
+ *  注销纹理数组的描述符池与描述符布局（描述符集随描述符池一起释放）
+ * */
+void cleanupBindlessTextures()
+{
+    if (!bindlessTexturesActive)
+    {
+        return;
+    }
+    vkDestroyDescriptorPool(device, bindlessDescriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, bindlessDescriptorSetLayout, nullptr);
+    bindlessDescriptorPool = VK_NULL_HANDLE;
+    bindlessDescriptorSetLayout = VK_NULL_HANDLE;
+    bindlessDescriptorSet = VK_NULL_HANDLE;
+}
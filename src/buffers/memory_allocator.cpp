@@ -0,0 +1,646 @@
+#include "buffers/memory_allocator.h"
+#include "logical_device_queue.h"
+
+// 默认的内存块大小
+const VkDeviceSize DEVICE_MEMORY_BLOCK_SIZE = 256ull * 1024 * 1024;
+// 初始化完成后打印各内存类型的使用情况
+const bool enableDeviceMemoryStats = true;
+
+/**
+ *  最高有效位的位置（v > 0）
+ * */
+static uint32_t highestBit(uint64_t v)
+{
+    return 63u - static_cast<uint32_t>(__builtin_clzll(v));
+}
+
+static uint32_t lowestBit(uint64_t v)
+{
+    return static_cast<uint32_t>(__builtin_ctzll(v));
+}
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/******************************************** TLSF ********************************************/
+
+TlsfBlock::TlsfBlock(VkDeviceSize size) : blockSize(size)
+{
+    for (uint32_t fl = 0; fl < FL_COUNT; fl++)
+    {
+        for (uint32_t sl = 0; sl < SL_COUNT; sl++)
+        {
+            freeHeads[fl][sl] = INVALID_NODE;
+        }
+    }
+
+    // 初始时整个块是一个空闲区间
+    uint32_t node = createNode();
+    nodes[node].offset = 0;
+    nodes[node].size = size;
+    insertFree(node);
+}
+
+/**
+ *  大小 -> (一级, 二级) 类别：小于 2^SL_BITS 的大小全部放在第 0 级，按字节数线性划分；
+ * 其余按最高位确定一级，最高位之后的 SL_BITS 位确定二级
+ * */
+void TlsfBlock::mapping(VkDeviceSize size, uint32_t &fl, uint32_t &sl)
+{
+    if (size < SL_COUNT)
+    {
+        fl = 0;
+        sl = static_cast<uint32_t>(size);
+        return;
+    }
+    uint32_t msb = highestBit(size);
+    fl = msb - SL_BITS + 1;
+    sl = static_cast<uint32_t>(size >> (msb - SL_BITS)) - SL_COUNT;
+}
+
+/**
+ *  找出一个保证能容纳 size 的空闲区间：先把 size 向上取整到所在类别的上界，这样找到的类别中任意区间都足够大
+ * */
+uint32_t TlsfBlock::findFree(VkDeviceSize size) const
+{
+    if (size >= SL_COUNT)
+    {
+        size += (VkDeviceSize(1) << (highestBit(size) - SL_BITS)) - 1;
+    }
+    uint32_t fl, sl;
+    mapping(size, fl, sl);
+    if (fl >= FL_COUNT)
+    {
+        return INVALID_NODE;
+    }
+
+    uint32_t slMap = sl < SL_COUNT ? slBitmap[fl] & (~0u << sl) : 0;
+    if (slMap == 0)
+    {
+        // 当前一级中没有足够大的类别，取更高一级中最小的非空类别
+        uint64_t flMap = fl + 1 < FL_COUNT ? flBitmap & (~0ull << (fl + 1)) : 0;
+        if (flMap == 0)
+        {
+            return INVALID_NODE;
+        }
+        fl = lowestBit(flMap);
+        slMap = slBitmap[fl];
+    }
+    sl = lowestBit(slMap);
+    return freeHeads[fl][sl];
+}
+
+/**
+ *  在 size 自身所在的类别中逐个检查空闲区间。findFree() 向上取整后会跳过这个类别，其中比 size 大的区间
+ * （例如整块空闲、大小恰好等于请求的 dedicated 块）只能这样找到
+ * */
+uint32_t TlsfBlock::findFreeInClass(VkDeviceSize size, VkDeviceSize alignment) const
+{
+    uint32_t fl, sl;
+    mapping(size, fl, sl);
+    if (fl >= FL_COUNT)
+    {
+        return INVALID_NODE;
+    }
+    for (uint32_t node = freeHeads[fl][sl]; node != INVALID_NODE; node = nodes[node].nextFree)
+    {
+        if (alignUp(nodes[node].offset, alignment) + size <= nodes[node].offset + nodes[node].size)
+        {
+            return node;
+        }
+    }
+    return INVALID_NODE;
+}
+
+void TlsfBlock::insertFree(uint32_t node)
+{
+    uint32_t fl, sl;
+    mapping(nodes[node].size, fl, sl);
+
+    nodes[node].free = true;
+    nodes[node].prevFree = INVALID_NODE;
+    nodes[node].nextFree = freeHeads[fl][sl];
+    if (freeHeads[fl][sl] != INVALID_NODE)
+    {
+        nodes[freeHeads[fl][sl]].prevFree = node;
+    }
+    freeHeads[fl][sl] = node;
+
+    flBitmap |= 1ull << fl;
+    slBitmap[fl] |= 1u << sl;
+}
+
+void TlsfBlock::removeFree(uint32_t node)
+{
+    uint32_t fl, sl;
+    mapping(nodes[node].size, fl, sl);
+
+    Node &n = nodes[node];
+    if (n.prevFree != INVALID_NODE)
+    {
+        nodes[n.prevFree].nextFree = n.nextFree;
+    }
+    else
+    {
+        freeHeads[fl][sl] = n.nextFree;
+    }
+    if (n.nextFree != INVALID_NODE)
+    {
+        nodes[n.nextFree].prevFree = n.prevFree;
+    }
+    n.prevFree = n.nextFree = INVALID_NODE;
+    n.free = false;
+
+    if (freeHeads[fl][sl] == INVALID_NODE)
+    {
+        slBitmap[fl] &= ~(1u << sl);
+        if (slBitmap[fl] == 0)
+        {
+            flBitmap &= ~(1ull << fl);
+        }
+    }
+}
+
+uint32_t TlsfBlock::createNode()
+{
+    if (!unusedNodes.empty())
+    {
+        uint32_t node = unusedNodes.back();
+        unusedNodes.pop_back();
+        nodes[node] = Node{};
+        return node;
+    }
+    nodes.push_back(Node{});
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void TlsfBlock::releaseNode(uint32_t node)
+{
+    unusedNodes.push_back(node);
+}
+
+bool TlsfBlock::allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset, uint32_t &node)
+{
+    if (size == 0 || size > blockSize)
+    {
+        return false;
+    }
+    alignment = std::max<VkDeviceSize>(alignment, 1);
+
+    // 先按原大小查找，找到的区间对齐后放不下时，再按 size + alignment - 1 查找（这时对齐后一定放得下），
+    // 都找不到时最后在 size 所在的类别中逐个检查
+    uint32_t candidate = findFree(size);
+    if (candidate == INVALID_NODE || alignUp(nodes[candidate].offset, alignment) + size > nodes[candidate].offset + nodes[candidate].size)
+    {
+        candidate = alignment > 1 ? findFree(size + alignment - 1) : INVALID_NODE;
+        if (candidate == INVALID_NODE)
+        {
+            candidate = findFreeInClass(size, alignment);
+        }
+        if (candidate == INVALID_NODE)
+        {
+            return false;
+        }
+    }
+    removeFree(candidate);
+
+    // 对齐产生的前部空隙单独作为空闲区间（前一个节点一定不是空闲的，否则早已合并）
+    VkDeviceSize alignedOffset = alignUp(nodes[candidate].offset, alignment);
+    VkDeviceSize padding = alignedOffset - nodes[candidate].offset;
+    if (padding > 0)
+    {
+        uint32_t front = createNode();
+        Node &n = nodes[candidate];
+        nodes[front].offset = n.offset;
+        nodes[front].size = padding;
+        nodes[front].prevPhysical = n.prevPhysical;
+        nodes[front].nextPhysical = candidate;
+        if (n.prevPhysical != INVALID_NODE)
+        {
+            nodes[n.prevPhysical].nextPhysical = front;
+        }
+        n.prevPhysical = front;
+        n.offset = alignedOffset;
+        n.size -= padding;
+        insertFree(front);
+    }
+
+    // 剩余的尾部作为新的空闲区间
+    if (nodes[candidate].size > size)
+    {
+        uint32_t back = createNode();
+        Node &n = nodes[candidate];
+        nodes[back].offset = n.offset + size;
+        nodes[back].size = n.size - size;
+        nodes[back].prevPhysical = candidate;
+        nodes[back].nextPhysical = n.nextPhysical;
+        if (n.nextPhysical != INVALID_NODE)
+        {
+            nodes[n.nextPhysical].prevPhysical = back;
+        }
+        n.nextPhysical = back;
+        n.size = size;
+        insertFree(back);
+    }
+
+    usedSize += size;
+    usedCount++;
+    offset = nodes[candidate].offset;
+    node = candidate;
+    return true;
+}
+
+void TlsfBlock::free(uint32_t node)
+{
+    usedSize -= nodes[node].size;
+    usedCount--;
+
+    // 与后一个空闲区间合并（总是保留前面的节点）
+    uint32_t next = nodes[node].nextPhysical;
+    if (next != INVALID_NODE && nodes[next].free)
+    {
+        removeFree(next);
+        nodes[node].size += nodes[next].size;
+        nodes[node].nextPhysical = nodes[next].nextPhysical;
+        if (nodes[next].nextPhysical != INVALID_NODE)
+        {
+            nodes[nodes[next].nextPhysical].prevPhysical = node;
+        }
+        releaseNode(next);
+    }
+
+    // 与前一个空闲区间合并
+    uint32_t prev = nodes[node].prevPhysical;
+    if (prev != INVALID_NODE && nodes[prev].free)
+    {
+        removeFree(prev);
+        nodes[prev].size += nodes[node].size;
+        nodes[prev].nextPhysical = nodes[node].nextPhysical;
+        if (nodes[node].nextPhysical != INVALID_NODE)
+        {
+            nodes[nodes[node].nextPhysical].prevPhysical = prev;
+        }
+        releaseNode(node);
+        node = prev;
+    }
+
+    insertFree(node);
+}
+
+void TlsfBlock::addStats(MemoryStats &stats) const
+{
+    stats.allocationCount += usedCount;
+    stats.blockBytes += blockSize;
+    stats.usedBytes += usedSize;
+
+    // 沿空闲链表统计（只在打印统计信息时使用，不需要很快）
+    uint64_t flMap = flBitmap;
+    while (flMap != 0)
+    {
+        uint32_t fl = lowestBit(flMap);
+        flMap &= flMap - 1;
+        uint32_t slMap = slBitmap[fl];
+        while (slMap != 0)
+        {
+            uint32_t sl = lowestBit(slMap);
+            slMap &= slMap - 1;
+            for (uint32_t node = freeHeads[fl][sl]; node != INVALID_NODE; node = nodes[node].nextFree)
+            {
+                stats.freeRangeCount++;
+                stats.largestFreeRange = std::max(stats.largestFreeRange, nodes[node].size);
+            }
+        }
+    }
+}
+
+/******************************************** 内存块管理 ********************************************/
+
+uint32_t findMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties &memoryProperties, uint32_t typeFilter, VkMemoryPropertyFlags properties)
+{
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+    {
+        if (typeFilter & (1u << i) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+        {
+            return i;
+        }
+    }
+    throw std::runtime_error("failed to find suitable memory type!");
+}
+
+DeviceMemoryAllocator::DeviceMemoryAllocator(const VkPhysicalDeviceMemoryProperties &memoryProperties,
+                                             VkDeviceSize bufferImageGranularity,
+                                             const DeviceMemoryCallbacks &callbacks,
+                                             VkDeviceSize preferredBlockSize)
+    : memoryProperties(memoryProperties), separateTiling(bufferImageGranularity > 1), callbacks(callbacks)
+{
+    pools.resize(memoryProperties.memoryTypeCount * 2);
+    for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++)
+    {
+        // 小堆（例如 256MB 的 BAR 内存）上一块不能占满整个堆
+        VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[type].heapIndex].size;
+        VkDeviceSize blockSize = heapSize <= 1024ull * 1024 * 1024 ? std::min(preferredBlockSize, heapSize / 8) : preferredBlockSize;
+        for (uint32_t tiling = 0; tiling < 2; tiling++)
+        {
+            pools[type * 2 + tiling].memoryTypeIndex = type;
+            pools[type * 2 + tiling].blockSize = blockSize;
+        }
+    }
+}
+
+DeviceMemoryAllocator::~DeviceMemoryAllocator()
+{
+    for (uint32_t pool = 0; pool < pools.size(); pool++)
+    {
+        for (uint32_t block = 0; block < pools[pool].blocks.size(); block++)
+        {
+            if (pools[pool].blocks[block])
+            {
+                destroyBlock(pool, block);
+            }
+        }
+    }
+}
+
+uint32_t DeviceMemoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+{
+    return findMemoryTypeIndex(memoryProperties, typeFilter, properties);
+}
+
+/**
+ *  申请一个内存块放入内存池，返回其下标；申请失败时返回 UINT32_MAX
+ * */
+uint32_t DeviceMemoryAllocator::createBlock(uint32_t poolIndex, VkDeviceSize size, bool dedicated)
+{
+    MemoryPool &pool = pools[poolIndex];
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (callbacks.allocate(pool.memoryTypeIndex, size, memory) != VK_SUCCESS)
+    {
+        return UINT32_MAX;
+    }
+
+    std::unique_ptr<MemoryBlock> block(new MemoryBlock(size));
+    block->memory = memory;
+    block->dedicated = dedicated;
+    if (memoryProperties.memoryTypes[pool.memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        block->mapped = static_cast<uint8_t *>(callbacks.map(memory, size));
+        if (block->mapped == nullptr)
+        {
+            callbacks.free(memory);
+            throw std::runtime_error("failed to map device memory block!");
+        }
+    }
+
+    for (uint32_t i = 0; i < pool.blocks.size(); i++)
+    {
+        if (!pool.blocks[i])
+        {
+            pool.blocks[i] = std::move(block);
+            return i;
+        }
+    }
+    pool.blocks.push_back(std::move(block));
+    return static_cast<uint32_t>(pool.blocks.size() - 1);
+}
+
+void DeviceMemoryAllocator::destroyBlock(uint32_t poolIndex, uint32_t blockIndex)
+{
+    std::unique_ptr<MemoryBlock> &block = pools[poolIndex].blocks[blockIndex];
+    // vkFreeMemory 会隐式解除映射
+    callbacks.free(block->memory);
+    block.reset();
+}
+
+MemoryAllocation DeviceMemoryAllocator::allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties, ResourceTiling tiling)
+{
+    uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+    uint32_t poolIndex = memoryType * 2 + (separateTiling ? static_cast<uint32_t>(tiling) : 0);
+    MemoryPool &pool = pools[poolIndex];
+
+    MemoryAllocation allocation;
+    allocation.pool = poolIndex;
+    allocation.size = requirements.size;
+
+    auto place = [&](uint32_t blockIndex)
+    {
+        MemoryBlock &block = *pool.blocks[blockIndex];
+        if (block.dedicated || !block.placement.allocate(requirements.size, requirements.alignment, allocation.offset, allocation.node))
+        {
+            return false;
+        }
+        allocation.block = blockIndex;
+        allocation.memory = block.memory;
+        allocation.mapped = block.mapped ? block.mapped + allocation.offset : nullptr;
+        return true;
+    };
+
+    // 1、超过块大小一半的资源单独分配
+    if (requirements.size > pool.blockSize / 2)
+    {
+        uint32_t blockIndex = createBlock(poolIndex, requirements.size, true);
+        if (blockIndex == UINT32_MAX)
+        {
+            throw std::runtime_error("failed to allocate dedicated device memory!");
+        }
+        MemoryBlock &block = *pool.blocks[blockIndex];
+        if (!block.placement.allocate(requirements.size, 1, allocation.offset, allocation.node))
+        {
+            destroyBlock(poolIndex, blockIndex);
+            throw std::runtime_error("failed to place allocation in dedicated device memory!");
+        }
+        allocation.block = blockIndex;
+        allocation.memory = block.memory;
+        allocation.mapped = block.mapped;
+        return allocation;
+    }
+
+    // 2、在已有的块中放置
+    for (uint32_t i = 0; i < pool.blocks.size(); i++)
+    {
+        if (pool.blocks[i] && place(i))
+        {
+            return allocation;
+        }
+    }
+
+    // 3、申请新块，显存不足时依次尝试 1/2、1/4 大小的块
+    for (VkDeviceSize blockSize = pool.blockSize; blockSize >= requirements.size; blockSize /= 2)
+    {
+        uint32_t blockIndex = createBlock(poolIndex, blockSize, false);
+        if (blockIndex != UINT32_MAX)
+        {
+            if (place(blockIndex))
+            {
+                return allocation;
+            }
+            destroyBlock(poolIndex, blockIndex);
+        }
+        if (blockSize <= pool.blockSize / 4)
+        {
+            break;
+        }
+    }
+    throw std::runtime_error("failed to allocate device memory!");
+}
+
+void DeviceMemoryAllocator::free(MemoryAllocation &allocation)
+{
+    if (allocation.pool == UINT32_MAX)
+    {
+        return;
+    }
+
+    MemoryPool &pool = pools[allocation.pool];
+    MemoryBlock &block = *pool.blocks[allocation.block];
+    block.placement.free(allocation.node);
+
+    /**
+     *  dedicated 块立即释放；普通块空闲后保留一个作为缓冲，避免资源反复创建/销毁时频繁申请内存，多出来的空块释放掉
+     * */
+    if (block.placement.empty())
+    {
+        bool keep = !block.dedicated;
+        if (keep)
+        {
+            for (uint32_t i = 0; i < pool.blocks.size(); i++)
+            {
+                if (i != allocation.block && pool.blocks[i] && !pool.blocks[i]->dedicated && pool.blocks[i]->placement.empty())
+                {
+                    keep = false;
+                    break;
+                }
+            }
+        }
+        if (!keep)
+        {
+            destroyBlock(allocation.pool, allocation.block);
+        }
+    }
+
+    allocation = MemoryAllocation{};
+}
+
+MemoryStats DeviceMemoryAllocator::getStats(uint32_t memoryTypeIndex) const
+{
+    MemoryStats stats;
+    for (const MemoryPool &pool : pools)
+    {
+        if (memoryTypeIndex != UINT32_MAX && pool.memoryTypeIndex != memoryTypeIndex)
+        {
+            continue;
+        }
+        for (const std::unique_ptr<MemoryBlock> &block : pool.blocks)
+        {
+            if (!block)
+            {
+                continue;
+            }
+            stats.blockCount++;
+            stats.dedicatedCount += block->dedicated ? 1 : 0;
+            block->placement.addStats(stats);
+        }
+    }
+    return stats;
+}
+
+/******************************************** 渲染器使用的全局分配器 ********************************************/
+
+std::unique_ptr<DeviceMemoryAllocator> memoryAllocator; // 全局分配器实例
+
+const VkPhysicalDeviceMemoryProperties &getPhysicalDeviceMemoryProperties()
+{
+    static VkPhysicalDeviceMemoryProperties memoryProperties;
+    static bool queried = false;
+    if (!queried)
+    {
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+        queried = true;
+    }
+    return memoryProperties;
+}
+
+void createMemoryAllocator()
+{
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    DeviceMemoryCallbacks callbacks;
+    callbacks.allocate = [](uint32_t memoryTypeIndex, VkDeviceSize size, VkDeviceMemory &memory)
+    {
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = memoryTypeIndex;
+        return vkAllocateMemory(device, &allocInfo, nullptr, &memory);
+    };
+    callbacks.free = [](VkDeviceMemory memory)
+    {
+        vkFreeMemory(device, memory, nullptr);
+    };
+    callbacks.map = [](VkDeviceMemory memory, VkDeviceSize size) -> void *
+    {
+        void *data = nullptr;
+        return vkMapMemory(device, memory, 0, size, 0, &data) == VK_SUCCESS ? data : nullptr;
+    };
+
+    memoryAllocator.reset(new DeviceMemoryAllocator(getPhysicalDeviceMemoryProperties(),
+                                                    properties.limits.bufferImageGranularity,
+                                                    callbacks));
+}
+
+void allocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties, MemoryAllocation &allocation)
+{
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+
+    allocation = memoryAllocator->allocate(memRequirements, properties, ResourceTiling::Linear);
+    vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
+}
+
+void allocateImageMemory(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags properties, MemoryAllocation &allocation)
+{
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, image, &memRequirements);
+
+    allocation = memoryAllocator->allocate(memRequirements, properties,
+                                           tiling == VK_IMAGE_TILING_LINEAR ? ResourceTiling::Linear : ResourceTiling::Optimal);
+    vkBindImageMemory(device, image, allocation.memory, allocation.offset);
+}
+
+void freeMemoryAllocation(MemoryAllocation &allocation)
+{
+    memoryAllocator->free(allocation);
+}
+
+void printMemoryAllocatorStats()
+{
+    const VkPhysicalDeviceMemoryProperties &memoryProperties = memoryAllocator->getMemoryProperties();
+    std::cout << "---------- device memory ----------" << std::endl;
+    for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++)
+    {
+        MemoryStats stats = memoryAllocator->getStats(type);
+        if (stats.blockCount == 0)
+        {
+            continue;
+        }
+        std::cout << "    type " << type << " (heap " << memoryProperties.memoryTypes[type].heapIndex << ", flags 0x"
+                  << std::hex << memoryProperties.memoryTypes[type].propertyFlags << std::dec << "): "
+                  << stats.blockCount << " blocks (" << stats.dedicatedCount << " dedicated), "
+                  << stats.allocationCount << " allocations, "
+                  << stats.usedBytes / (1024.0 * 1024.0) << " / " << stats.blockBytes / (1024.0 * 1024.0) << " MB used, "
+                  << stats.freeRangeCount << " free ranges, fragmentation " << stats.fragmentation() * 100.0 << "%" << std::endl;
+    }
+}
+
+void cleanupMemoryAllocator()
+{
+    MemoryStats stats = memoryAllocator->getStats();
+    if (stats.allocationCount > 0)
+    {
+        std::cout << "device memory: " << stats.allocationCount << " allocations still alive at shutdown" << std::endl;
+    }
+    memoryAllocator.reset();
+}
@@ -0,0 +1,699 @@
+#include "buffers/staging_ring.h"
+#include "buffers/buffers_operation.h"
+
+// 环形暂存缓冲区大小：容纳一张 4K RGBA8 纹理的整条 mip 链绰绰有余，一般的上传不会触发等待
+const VkDeviceSize STAGING_RING_SIZE = 64ull * 1024 * 1024;
+// 单次分配不超过环的 1/4，大的上传拆分后 CPU 写入下一段时 GPU 可以同时拷贝上一段
+const VkDeviceSize STAGING_RING_MAX_ALLOCATION = STAGING_RING_SIZE / 4;
+
+/**
+ *  一次提交的批次：命令缓冲 + fence，以及它在环中占用的区间
+ * */
+struct StagingSubmission
+{
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    VkDeviceSize end = 0;   // 批次结束时的 head，完成后 tail 移动到这里
+    VkDeviceSize bytes = 0; // 批次占用的字节数（包括对齐与回绕跳过的部分）
+};
+
+VkBuffer stagingRingBuffer = VK_NULL_HANDLE;             // 环形暂存缓冲区实例
+MemoryAllocation stagingRingBufferMemory;                // 环形暂存缓冲区对应的内存（由分配器常驻映射）
+uint8_t *stagingRingMapped = nullptr;                    // 映射得到的 CPU 地址
+
+VkDeviceSize stagingRingHead = 0; // 下一次分配的起点
+VkDeviceSize stagingRingTail = 0; // 最早的未完成区间的起点
+VkDeviceSize stagingRingUsed = 0; // 已提交 + 当前批次占用的字节数
+
+StagingSubmission stagingRingCurrent;                // 当前批次（commandBuffer 为空表示没有正在录制的批次）
+std::deque<StagingSubmission> stagingRingInFlight;   // 已提交、尚未回收的批次（按提交顺序）
+std::vector<StagingSubmission> stagingRingFreeList;  // 已回收、可以复用的命令缓冲与 fence
+
+VkQueue uploadQueue = VK_NULL_HANDLE;             // 批次提交到的队列：专用传输队列，没有时为图形队列
+VkCommandPool uploadCommandPool = VK_NULL_HANDLE; // 批次命令缓冲所在的命令池（使用传输队列时为传输队列族单独创建）
+VkExtent3D uploadImageGranularity = {1, 1, 1};    // 上传队列的 minImageTransferGranularity（图形队列恒为 1x1x1）
+
+VkSemaphore uploadTimelineSemaphore = VK_NULL_HANDLE; // 每个批次在传输队列上 signal 一个递增的值
+uint64_t uploadTimelineValue = 0;                     // 最近一次提交的批次 signal 的值
+
+std::vector<VkBufferMemoryBarrier> batchBufferReleases; // 当前批次中写入完成的 buffer 区间，提交前合并为一次屏障
+std::vector<VkImageMemoryBarrier> batchImageReleases;   // 当前批次中写入完成的图像
+VkPipelineStageFlags batchReleaseStages = 0;            // 以上屏障的 dstStage
+
+uint32_t uploadBatchDepth = 0; // beginUploadBatch() 的嵌套层数，大于 0 时 submitStagingCommands() 推迟到 endUploadBatch()
+
+std::vector<VkBufferMemoryBarrier> pendingBufferAcquires; // 已 release、尚未在图形队列上 acquire 的 buffer 区间
+std::vector<VkImageMemoryBarrier> pendingImageAcquires;   // 已 release、尚未在图形队列上 acquire 的图像
+VkPipelineStageFlags pendingAcquireStages = 0;            // 以上资源在图形队列上被使用的阶段
+
+// 统计信息，注销时输出
+uint64_t stagingRingSubmitCount = 0;
+uint64_t stagingRingWaitCount = 0;
+uint64_t stagingRingUploadBytes = 0;
+uint64_t stagingRingBarrierCount = 0;
+
+/**
+ *  是否在专用传输队列上上传
+ * */
+bool usesTransferQueue()
+{
+    return transferQueue != VK_NULL_HANDLE;
+}
+
+/**
+ *  创建环形暂存缓冲区，并常驻映射
+ * */
+void createStagingRing()
+{
+    uploadQueue = graphicsQueue;
+    uploadCommandPool = commandPool;
+    uploadImageGranularity = {1, 1, 1};
+    if (usesTransferQueue())
+    {
+        uint32_t transferFamily = queueIndices.transferFamily.value();
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = transferFamily;
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &uploadCommandPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create transfer command pool!");
+        }
+
+        VkSemaphoreTypeCreateInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineInfo.initialValue = 0;
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &timelineInfo;
+        if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &uploadTimelineSemaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create upload timeline semaphore!");
+        }
+        uploadTimelineValue = 0;
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+        uploadImageGranularity = queueFamilies[transferFamily].minImageTransferGranularity;
+
+        uploadQueue = transferQueue;
+    }
+
+    createBuffer(STAGING_RING_SIZE,
+                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 stagingRingBuffer,
+                 stagingRingBufferMemory);
+
+    // HOST_COHERENT 内存在整个生命周期内保持映射，写入后不需要 flush，提交时自动对 GPU 可见
+    stagingRingMapped = static_cast<uint8_t *>(stagingRingBufferMemory.mapped);
+
+    stagingRingHead = 0;
+    stagingRingTail = 0;
+    stagingRingUsed = 0;
+}
+
+/**
+ *  回收最早的批次：把它的命令缓冲与 fence 放回空闲列表，tail 前移
+ * */
+static void retireOldestSubmission()
+{
+    StagingSubmission submission = stagingRingInFlight.front();
+    stagingRingInFlight.pop_front();
+
+    stagingRingTail = submission.end;
+    stagingRingUsed -= submission.bytes;
+    if (stagingRingUsed == 0)
+    {
+        // 环已经完全空闲，回到起点，减少之后的回绕
+        stagingRingHead = stagingRingTail = 0;
+    }
+
+    vkResetFences(device, 1, &submission.fence);
+    submission.end = 0;
+    submission.bytes = 0;
+    stagingRingFreeList.push_back(submission);
+}
+
+/**
+ *  不阻塞地回收所有已经完成的批次
+ * */
+static void retireCompletedSubmissions()
+{
+    while (!stagingRingInFlight.empty() && vkGetFenceStatus(device, stagingRingInFlight.front().fence) == VK_SUCCESS)
+    {
+        retireOldestSubmission();
+    }
+}
+
+/**
+ *  等待最早的批次完成并回收
+ * */
+static void waitOldestSubmission()
+{
+    vkWaitForFences(device, 1, &stagingRingInFlight.front().fence, VK_TRUE, UINT64_MAX);
+    stagingRingWaitCount++;
+    retireOldestSubmission();
+}
+
+/**
+ *  当前批次的命令缓冲（没有时开始一个新批次）
+ * */
+VkCommandBuffer getStagingCommandBuffer()
+{
+    if (stagingRingCurrent.commandBuffer != VK_NULL_HANDLE)
+    {
+        return stagingRingCurrent.commandBuffer;
+    }
+
+    // 优先复用已回收的命令缓冲与 fence
+    if (!stagingRingFreeList.empty())
+    {
+        stagingRingCurrent = stagingRingFreeList.back();
+        stagingRingFreeList.pop_back();
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = uploadCommandPool;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &stagingRingCurrent.commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate staging command buffer!");
+        }
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(device, &fenceInfo, nullptr, &stagingRingCurrent.fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create staging fence!");
+        }
+    }
+    stagingRingCurrent.end = 0;
+    stagingRingCurrent.bytes = 0;
+
+    // 命令池带有 VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT，begin 时会隐式重置复用的命令缓冲
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(stagingRingCurrent.commandBuffer, &beginInfo);
+
+    return stagingRingCurrent.commandBuffer;
+}
+
+/**
+ *  立即提交当前批次（不等待完成），不受 beginUploadBatch() 的影响
+ * */
+static void flushStagingCommands()
+{
+    if (stagingRingCurrent.commandBuffer == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    /**
+     *  写入的可见性由各资源的 release 屏障（以及图形队列上对应的 acquire 屏障）负责。本批次所有资源的 release 屏障在这里
+     * 合并为一次 vkCmdPipelineBarrier：拷贝都已录制在前面，屏障的第一同步范围覆盖它们
+     * */
+    if (!batchBufferReleases.empty() || !batchImageReleases.empty())
+    {
+        vkCmdPipelineBarrier(stagingRingCurrent.commandBuffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, batchReleaseStages, 0,
+                             0, nullptr,
+                             static_cast<uint32_t>(batchBufferReleases.size()), batchBufferReleases.data(),
+                             static_cast<uint32_t>(batchImageReleases.size()), batchImageReleases.data());
+        stagingRingBarrierCount += batchBufferReleases.size() + batchImageReleases.size();
+        batchBufferReleases.clear();
+        batchImageReleases.clear();
+        batchReleaseStages = 0;
+    }
+
+    vkEndCommandBuffer(stagingRingCurrent.commandBuffer);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &stagingRingCurrent.commandBuffer;
+
+    // 传输队列上的批次 signal 下一个 timeline 值，图形队列上 acquire 了本批次资源的提交等待这个值
+    uint64_t signalValue = uploadTimelineValue + 1;
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+    if (usesTransferQueue())
+    {
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &uploadTimelineSemaphore;
+    }
+
+    if (vkQueueSubmit(uploadQueue, 1, &submitInfo, stagingRingCurrent.fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit staging commands!");
+    }
+    if (usesTransferQueue())
+    {
+        uploadTimelineValue = signalValue;
+    }
+
+    stagingRingCurrent.end = stagingRingHead;
+    stagingRingInFlight.push_back(stagingRingCurrent);
+    stagingRingCurrent = StagingSubmission{};
+    stagingRingSubmitCount++;
+}
+
+/**
+ *  一次上传结束：不在上传批次中时立即提交
+ * */
+void submitStagingCommands()
+{
+    if (uploadBatchDepth == 0)
+    {
+        flushStagingCommands();
+    }
+}
+
+/**
+ *  开始一个上传批次
+ * */
+void beginUploadBatch()
+{
+    uploadBatchDepth++;
+}
+
+/**
+ *  结束上传批次，最外层结束时一次提交
+ * */
+void endUploadBatch()
+{
+    if (uploadBatchDepth == 0)
+    {
+        throw std::runtime_error("endUploadBatch() without beginUploadBatch()!");
+    }
+    if (--uploadBatchDepth == 0)
+    {
+        flushStagingCommands();
+    }
+}
+
+/**
+ *  把 buffer 区间交给图形队列
+ * */
+void releaseBufferToGraphics(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+                             VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.buffer = buffer;
+    barrier.offset = offset;
+    barrier.size = size;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    // 屏障在批次提交前与其他资源的屏障合并录制
+    getStagingCommandBuffer();
+    if (!usesTransferQueue())
+    {
+        // 同一个队列：普通的屏障即可（第二同步范围包括之后提交的所有命令）
+        barrier.dstAccessMask = dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        batchBufferReleases.push_back(barrier);
+        batchReleaseStages |= dstStage;
+        return;
+    }
+
+    /**
+     *  所有权转移：传输队列上的 release 只负责让写入可用（dstAccessMask 被忽略），图形队列上同样参数的 acquire 负责让
+     * 写入对 dstStage 可见。传输队列不支持图形阶段，release 的 dstStage 使用 BOTTOM_OF_PIPE
+     * */
+    barrier.srcQueueFamilyIndex = queueIndices.transferFamily.value();
+    barrier.dstQueueFamilyIndex = queueIndices.graphicsFamily.value();
+    barrier.dstAccessMask = 0;
+    batchBufferReleases.push_back(barrier);
+    batchReleaseStages |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = dstAccess;
+    pendingBufferAcquires.push_back(barrier);
+    pendingAcquireStages |= dstStage;
+}
+
+/**
+ *  把图像交给图形队列并完成布局转换
+ * */
+void releaseImageToGraphics(VkImage image, const VkImageSubresourceRange &range,
+                            VkImageLayout oldLayout, VkImageLayout newLayout,
+                            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = image;
+    barrier.subresourceRange = range;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    getStagingCommandBuffer();
+    if (!usesTransferQueue())
+    {
+        barrier.dstAccessMask = dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        batchImageReleases.push_back(barrier);
+        batchReleaseStages |= dstStage;
+        return;
+    }
+
+    // release 与 acquire 的布局参数相同，布局转换只执行一次（在 release 之后、acquire 之前）
+    barrier.srcQueueFamilyIndex = queueIndices.transferFamily.value();
+    barrier.dstQueueFamilyIndex = queueIndices.graphicsFamily.value();
+    barrier.dstAccessMask = 0;
+    batchImageReleases.push_back(barrier);
+    batchReleaseStages |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = dstAccess;
+    pendingImageAcquires.push_back(barrier);
+    pendingAcquireStages |= dstStage;
+}
+
+/**
+ *  在图形队列的命令缓冲中录制待处理的 acquire 屏障
+ * */
+UploadWait recordUploadAcquires(VkCommandBuffer commandBuffer)
+{
+    /**
+     *  当前批次中录制的命令（以及 release 屏障）先提交：同一队列时保证按提交顺序在这个命令缓冲之前执行，使用传输队列时
+     * 保证等待的 timeline 值覆盖所有待处理的资源
+     * */
+    flushStagingCommands();
+
+    UploadWait wait;
+    if (pendingBufferAcquires.empty() && pendingImageAcquires.empty())
+    {
+        return wait;
+    }
+
+    /**
+     *  提交时在 pendingAcquireStages 等待 timeline semaphore，acquire 屏障的第一同步范围使用同样的阶段，与信号量等待
+     * 构成依赖链；图形队列在这些阶段之前的工作（例如上一帧遗留的颜色输出）不受影响
+     * */
+    vkCmdPipelineBarrier(commandBuffer,
+                         pendingAcquireStages, pendingAcquireStages, 0,
+                         0, nullptr,
+                         static_cast<uint32_t>(pendingBufferAcquires.size()), pendingBufferAcquires.data(),
+                         static_cast<uint32_t>(pendingImageAcquires.size()), pendingImageAcquires.data());
+
+    wait.value = uploadTimelineValue;
+    wait.stages = pendingAcquireStages;
+
+    pendingBufferAcquires.clear();
+    pendingImageAcquires.clear();
+    pendingAcquireStages = 0;
+    return wait;
+}
+
+/**
+ *  是否有尚未 acquire 的上传
+ * */
+bool hasPendingUploadAcquires()
+{
+    return !pendingBufferAcquires.empty() || !pendingImageAcquires.empty();
+}
+
+/**
+ *  上传的 timeline semaphore
+ * */
+VkSemaphore getUploadTimelineSemaphore()
+{
+    return uploadTimelineSemaphore;
+}
+
+/**
+ *  分配 size 字节（按 alignment 对齐）
+ * */
+StagingAllocation allocateStaging(VkDeviceSize size, VkDeviceSize alignment)
+{
+    if (size > STAGING_RING_SIZE)
+    {
+        throw std::runtime_error("staging allocation larger than the staging ring!");
+    }
+
+    retireCompletedSubmissions();
+
+    while (true)
+    {
+        /**
+         *  已占用区间为 [tail, head)（可能回绕），空闲字节数为 STAGING_RING_SIZE - used。
+         *  对齐后末尾放得下时直接在 head 之后分配；放不下时跳过末尾剩余部分，从 0 开始分配（跳过的部分同样计入占用）
+         * */
+        VkDeviceSize alignedHead = (stagingRingHead + alignment - 1) / alignment * alignment;
+        VkDeviceSize offset;
+        VkDeviceSize consumed;
+        if (alignedHead + size <= STAGING_RING_SIZE)
+        {
+            offset = alignedHead;
+            consumed = alignedHead + size - stagingRingHead;
+        }
+        else
+        {
+            offset = 0;
+            consumed = STAGING_RING_SIZE - stagingRingHead + size;
+        }
+
+        if (stagingRingUsed + consumed <= STAGING_RING_SIZE)
+        {
+            VkCommandBuffer commandBuffer = getStagingCommandBuffer();
+            stagingRingHead = offset + size;
+            stagingRingUsed += consumed;
+            stagingRingCurrent.bytes += consumed;
+            stagingRingUploadBytes += size;
+
+            StagingAllocation allocation;
+            allocation.buffer = stagingRingBuffer;
+            allocation.offset = offset;
+            allocation.mapped = stagingRingMapped + offset;
+            allocation.commandBuffer = commandBuffer;
+            return allocation;
+        }
+
+        // 空间不足：先等待最早的已提交批次；没有已提交的批次时说明空间都被当前批次占用，先提交当前批次
+        if (!stagingRingInFlight.empty())
+        {
+            waitOldestSubmission();
+        }
+        else if (stagingRingCurrent.commandBuffer != VK_NULL_HANDLE && stagingRingCurrent.bytes > 0)
+        {
+            flushStagingCommands();
+        }
+        else
+        {
+            throw std::runtime_error("staging ring is corrupted!");
+        }
+    }
+}
+
+/**
+ *  等待所有已提交的批次完成并回收全部空间
+ * */
+void waitStagingRingIdle()
+{
+    flushStagingCommands();
+    while (!stagingRingInFlight.empty())
+    {
+        waitOldestSubmission();
+    }
+}
+
+/**
+ *  按元素拆分上传到 buffer
+ * */
+void uploadElementsToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, size_t elementCount, VkDeviceSize elementSize,
+                            const std::function<void(void *destination, size_t first, size_t count)> &fill,
+                            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    if (elementCount == 0)
+    {
+        return;
+    }
+
+    // 每段至少一个元素
+    size_t elementsPerChunk = static_cast<size_t>(std::max<VkDeviceSize>(STAGING_RING_MAX_ALLOCATION / elementSize, 1));
+    for (size_t first = 0; first < elementCount; first += elementsPerChunk)
+    {
+        size_t count = std::min(elementsPerChunk, elementCount - first);
+        VkDeviceSize size = elementSize * count;
+
+        // vkCmdCopyBuffer 没有对齐要求，按 4 字节对齐只是为了让 CPU 写入更友好
+        StagingAllocation allocation = allocateStaging(size, 4);
+        fill(allocation.mapped, first, count);
+
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = allocation.offset;
+        copyRegion.dstOffset = dstOffset + elementSize * first;
+        copyRegion.size = size;
+        vkCmdCopyBuffer(allocation.commandBuffer, allocation.buffer, dstBuffer, 1, &copyRegion);
+    }
+
+    // 拆分时前面的段已经随之前的批次提交，按队列的提交顺序在这之前完成，整个区间在最后一个批次中一次交给图形队列
+    releaseBufferToGraphics(dstBuffer, dstOffset, elementSize * elementCount, dstStage, dstAccess);
+}
+
+/**
+ *  上传一段连续的数据到 buffer
+ * */
+void uploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void *data, VkDeviceSize size,
+                    VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    const uint8_t *source = static_cast<const uint8_t *>(data);
+    uploadElementsToBuffer(dstBuffer, dstOffset, static_cast<size_t>(size), 1,
+                           [source](void *destination, size_t first, size_t count)
+                           {
+                               memcpy(destination, source + first, count);
+                           },
+                           dstStage, dstAccess);
+}
+
+/**
+ *  把 mip 链的各级拷贝到图像
+ * */
+void uploadMipLevelsToImage(VkImage image, const uint8_t *data, const std::vector<MipLevel> &levels,
+                            uint32_t blockWidth, uint32_t blockHeight, uint32_t blockBytes)
+{
+    // bufferOffset 需要是块大小（8/16 字节）与 4 的整数倍
+    const VkDeviceSize alignment = 16;
+
+    auto blockRowBytes = [&](const MipLevel &level) -> VkDeviceSize
+    {
+        return static_cast<VkDeviceSize>((level.width + blockWidth - 1) / blockWidth) * blockBytes;
+    };
+    auto blockRows = [&](const MipLevel &level) -> uint32_t
+    {
+        return (level.height + blockHeight - 1) / blockHeight;
+    };
+
+    auto makeRegion = [](uint32_t mipLevel, VkDeviceSize bufferOffset, uint32_t y, uint32_t width, uint32_t height)
+    {
+        VkBufferImageCopy region{};
+        region.bufferOffset = bufferOffset;
+        region.bufferRowLength = 0; // 紧密排列
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = mipLevel;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, static_cast<int32_t>(y), 0};
+        region.imageExtent = {width, height, 1};
+        return region;
+    };
+
+    size_t level = 0;
+    while (level < levels.size())
+    {
+        VkDeviceSize levelBytes = blockRowBytes(levels[level]) * blockRows(levels[level]);
+
+        if (levelBytes > STAGING_RING_MAX_ALLOCATION)
+        {
+            /**
+             *  单个级别超过上限：按块行拆分，每段拷贝图像中的一条水平带（y 方向的偏移是块高的整数倍）
+             * */
+            const MipLevel &mip = levels[level];
+            VkDeviceSize rowBytes = blockRowBytes(mip);
+            uint32_t rowCount = blockRows(mip);
+            uint32_t rowsPerChunk = static_cast<uint32_t>(std::max<VkDeviceSize>(STAGING_RING_MAX_ALLOCATION / rowBytes, 1));
+            // 传输队列的拷贝区域起点需要是 minImageTransferGranularity（以块为单位）的整数倍，最后一段可以到达图像边缘
+            uint32_t rowGranularity = std::max(uploadImageGranularity.height, 1u);
+            rowsPerChunk = std::max(rowsPerChunk / rowGranularity, 1u) * rowGranularity;
+            for (uint32_t row = 0; row < rowCount; row += rowsPerChunk)
+            {
+                uint32_t rows = std::min(rowsPerChunk, rowCount - row);
+                StagingAllocation allocation = allocateStaging(rowBytes * rows, alignment);
+                memcpy(allocation.mapped, data + mip.offset + rowBytes * row, static_cast<size_t>(rowBytes * rows));
+
+                uint32_t y = row * blockHeight;
+                uint32_t height = std::min(rows * blockHeight, mip.height - y);
+                VkBufferImageCopy region = makeRegion(static_cast<uint32_t>(level), allocation.offset, y, mip.width, height);
+                vkCmdCopyBufferToImage(allocation.commandBuffer, allocation.buffer, image,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+            }
+            level++;
+            continue;
+        }
+
+        /**
+         *  合并之后能一起放进一次分配的级别，用一次 vkCmdCopyBufferToImage（每级一个 region）拷贝
+         * */
+        size_t end = level;
+        VkDeviceSize groupBytes = 0;
+        while (end < levels.size())
+        {
+            VkDeviceSize bytes = blockRowBytes(levels[end]) * blockRows(levels[end]);
+            VkDeviceSize offset = (groupBytes + alignment - 1) / alignment * alignment;
+            if (offset + bytes > STAGING_RING_MAX_ALLOCATION)
+            {
+                break;
+            }
+            groupBytes = offset + bytes;
+            end++;
+        }
+
+        StagingAllocation allocation = allocateStaging(groupBytes, alignment);
+        std::vector<VkBufferImageCopy> regions;
+        regions.reserve(end - level);
+        VkDeviceSize offset = 0;
+        for (size_t i = level; i < end; i++)
+        {
+            offset = (offset + alignment - 1) / alignment * alignment;
+            VkDeviceSize bytes = blockRowBytes(levels[i]) * blockRows(levels[i]);
+            memcpy(static_cast<uint8_t *>(allocation.mapped) + offset, data + levels[i].offset, static_cast<size_t>(bytes));
+            regions.push_back(makeRegion(static_cast<uint32_t>(i), allocation.offset + offset, 0, levels[i].width, levels[i].height));
+            offset += bytes;
+        }
+        vkCmdCopyBufferToImage(allocation.commandBuffer, allocation.buffer, image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+        level = end;
+    }
+}
+
+/**
+ *  注销环形暂存缓冲区
+ * */
+void cleanupStagingRing()
+{
+    waitStagingRingIdle();
+
+    std::cout << "staging ring: " << stagingRingSubmitCount << " submissions, "
+              << stagingRingUploadBytes / (1024.0 * 1024.0) << " MB uploaded, "
+              << stagingRingWaitCount << " waits, " << stagingRingBarrierCount << " resource barriers (" << (usesTransferQueue() ? "transfer queue" : "graphics queue") << ")" << std::endl;
+
+    for (StagingSubmission &submission : stagingRingFreeList)
+    {
+        vkFreeCommandBuffers(device, uploadCommandPool, 1, &submission.commandBuffer);
+        vkDestroyFence(device, submission.fence, nullptr);
+    }
+    stagingRingFreeList.clear();
+
+    pendingBufferAcquires.clear();
+    pendingImageAcquires.clear();
+    pendingAcquireStages = 0;
+    uploadBatchDepth = 0;
+    if (usesTransferQueue())
+    {
+        vkDestroySemaphore(device, uploadTimelineSemaphore, nullptr);
+        vkDestroyCommandPool(device, uploadCommandPool, nullptr);
+        uploadTimelineSemaphore = VK_NULL_HANDLE;
+    }
+    uploadCommandPool = VK_NULL_HANDLE;
+
+    stagingRingMapped = nullptr;
+    vkDestroyBuffer(device, stagingRingBuffer, nullptr);
+    freeMemoryAllocation(stagingRingBufferMemory);
+}
@@ -1,9 +1,59 @@
 #include "command_buffer.h"
 
+#include "scene.h"
+#include "gpu_culling.h"
+#include "render_queue.h"
+
 VkCommandPool commandPool; // 命令池实例，用于管理命令缓冲区的内容
 
 std::vector<VkCommandBuffer> commandBuffers; // 命令缓冲区实例
 
+const bool enableParallelRecording = true;
+const uint32_t PARALLEL_RECORDING_MIN_DRAWS = 256;
+
+const bool enableCommandRecordingBenchmark = false;
+const uint32_t COMMAND_RECORDING_BENCHMARK_DRAWS = 100000;
+const uint32_t COMMAND_RECORDING_BENCHMARK_FRAMES = 50;
+
+/**
+ *  一个录制区间使用的命令池与次级命令缓冲区
+ * */
+struct SecondaryRecorder
+{
+    VkCommandPool pool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+};
+
+std::vector<std::vector<SecondaryRecorder>> secondaryRecorders; // 下标为 [帧][录制区间]
+
+const bool enablePrerecordedCommandBuffers = true;
+
+/**
+ *  一个预录制的命令缓冲区，以及录制时的状态
+ * */
+struct PrerecordedCommandBuffer
+{
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    uint64_t generation = 0;           // 录制时的 commandBufferGeneration，0 表示尚未录制
+    std::vector<SceneDraw> recordedDraws; // 录制时的绘制列表
+};
+
+std::vector<PrerecordedCommandBuffer> prerecordedCommandBuffers; // 下标为 帧 * 交换链图像数 + 图像
+uint64_t commandBufferGeneration = 1;                            // invalidateCommandBuffers() 时递增
+std::vector<SceneDraw> previousFrameDraws;                       // 上一帧的绘制列表，用于判断场景是否静止
+
+/**
+ *  已提交、尚未完成的单次指令，fence 触发后再释放命令缓冲
+ * */
+struct SingleTimeSubmission
+{
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+};
+
+std::vector<SingleTimeSubmission> singleTimeSubmissions; // 已提交的单次指令
+UploadWait singleTimeUploadWait;                        // 正在录制的单次指令提交时需要等待的上传
+
 /**
  *  创建 command pool
  * */
@@ -55,23 +105,100 @@ void createCommandBuffer()
     {
         throw std::runtime_error("failed to allocate command buffers!");
     }
+
+    if (!enableParallelRecording)
+    {
+        return;
+    }
+
+    /*
+        并行录制时每一帧、每个录制区间各有一个命令池，其中只分配一个次级命令缓冲区。
+        TRANSIENT：命令缓冲区每帧都重新录制；不设置 RESET_COMMAND_BUFFER：每帧整体重置命令池。
+    */
+    QueueFamilyIndices queueFamilyIndices = findQueueFamilies(physicalDevice);
+    const size_t recorderCount = getThreadPool().concurrency();
+    secondaryRecorders.assign(MAX_FRAMES_IN_FLIGHT, std::vector<SecondaryRecorder>(recorderCount));
+    for (auto &frameRecorders : secondaryRecorders)
+    {
+        for (SecondaryRecorder &recorder : frameRecorders)
+        {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+            if (vkCreateCommandPool(device, &poolInfo, nullptr, &recorder.pool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create secondary command pool!");
+            }
+
+            VkCommandBufferAllocateInfo secondaryInfo{};
+            secondaryInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            secondaryInfo.commandPool = recorder.pool;
+            secondaryInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            secondaryInfo.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(device, &secondaryInfo, &recorder.commandBuffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate secondary command buffer!");
+            }
+        }
+    }
+    std::cout << "command recording: " << recorderCount << " secondary command pools per frame" << std::endl;
 }
 
 /**
- *  更新/填充command buffer
- *  draw time 函数，在渲染过程中更新
+ *  设置绘制场景需要的动态状态，管线、描述符与顶点/索引缓冲由 RenderStateCache 按绘制绑定
+ *  （次级命令缓冲区不继承主命令缓冲区的状态，每个都要重新设置）
  * */
-void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, uint32_t currentFrame)
+static void recordSceneState(VkCommandBuffer commandBuffer)
 {
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float)swapChainExtent.width;
+    viewport.height = (float)swapChainExtent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    /**
+     * 填充指令2：设置视口大小
+     */
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-    // 开始command buffer填充，如果 command buffer 是一个已经被填充的状态，则原来的状态将先被清空/重置
-    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = swapChainExtent;
+    /**
+     * 填充指令3：设置视口截取尺寸
+     */
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+/**
+ *  发出 sceneDraws 中 [first, first + count) 区间的绘制
+ * */
+static void recordSceneDraws(RenderStateCache &cache, size_t first, size_t count)
+{
+    /**
+     * 填充指令4：绑定 graphic pipeline、描述符（每帧更新的MVP变换阵以pipelineLayout作为接口传入graphic pipeline，
+     * 物体的数据块通过动态偏移选择）、push constants 以及 vertex buffer / index buffer，与上一个绘制相同的绑定被跳过（sceneDraws 已按排序键排序，相同状态的绘制相邻）
+     *
+     * 填充指令5：开始渲染，如果没有使用index bufer，则使用vkCmdDraw命令进行填充，否则使用vkCmdDrawIndexed
+     * 命令进行填充，第二参数为要绘制的顶点数量，由于vertex buffer原数组中有顶点复用，而这里我们需要未复用的总数量，
+     * 于是使用index buffer原数组的长度作为输入值。
+     */
+    // 每种网格一次实例化绘制（单实例网格为簇剔除后的可见区间），参数由 updateSceneDraws() 生成
+    for (size_t i = first; i < first + count; i++)
     {
-        throw std::runtime_error("failed to begin recording command buffer!");
+        const SceneDraw &draw = sceneDraws[i];
+        bindSceneDrawState(cache, draw);
+        vkCmdDrawIndexed(cache.commandBuffer, draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset, draw.firstInstance);
     }
+}
 
+/**
+ *  录制场景的 render pass，maxThreads 限制并行录制使用的区间数（0 表示不限制）
+ * */
+static void recordScenePass(VkCommandBuffer commandBuffer, uint32_t imageIndex, uint32_t currentFrame, size_t maxThreads)
+{
     /*
         第六步，从这里开始真正的渲染过程Render Pass
     */
@@ -94,79 +221,369 @@ void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, uin
     renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
-    /**
-     * 填充指令1：启动RenderPass
-     */
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    // GPU 剔除在 render pass 之前生成本帧的间接绘制命令
+    if (gpuCullingActive)
+    {
+        recordGpuCulling(commandBuffer, currentFrame);
+    }
 
-    /**
-     * 填充指令2：绑定graphic pipeline
-     */
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+    // 录制区间数：每个区间至少 PARALLEL_RECORDING_MIN_DRAWS 个绘制，且不超过每帧的命令池数量
+    size_t chunkCount = 1;
+    if (enableParallelRecording && !secondaryRecorders.empty())
+    {
+        size_t limit = secondaryRecorders[currentFrame].size();
+        if (maxThreads != 0)
+        {
+            limit = std::min(limit, maxThreads);
+        }
+        chunkCount = std::min(limit, sceneDraws.size() / PARALLEL_RECORDING_MIN_DRAWS);
+    }
 
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float)swapChainExtent.width;
-    viewport.height = (float)swapChainExtent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    /**
-     * 填充指令3：设置视口大小
-     */
-    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    if (chunkCount <= 1)
+    {
+        /**
+         * 填充指令1：启动RenderPass
+         */
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        recordSceneState(commandBuffer);
+        RenderStateCache cache;
+        cache.commandBuffer = commandBuffer;
+        cache.currentFrame = currentFrame;
+        if (gpuCullingActive)
+        {
+            // 间接绘制覆盖所有物体，它们共用同一个场景变换，使用物体 0 的数据块；每个管线分组各发出一次间接绘制
+            recordGpuDraws(cache);
+        }
+        else
+        {
+            recordSceneDraws(cache, 0, sceneDraws.size());
+        }
+        renderBindStatistics = cache.statistics;
+    }
+    else
+    {
+        // 这个 subpass 中只能执行次级命令缓冲区
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+        std::vector<SecondaryRecorder> &recorders = secondaryRecorders[currentFrame];
+        const size_t drawsPerChunk = (sceneDraws.size() + chunkCount - 1) / chunkCount;
+        std::vector<RenderBindStatistics> chunkStatistics(chunkCount);
+        getThreadPool().parallelFor(chunkCount, [&](size_t chunk)
+                                    {
+            // 该帧的 fence 已经等待过，GPU 不再使用这个命令池中的命令缓冲区
+            SecondaryRecorder &recorder = recorders[chunk];
+            vkResetCommandPool(device, recorder.pool, 0);
+
+            VkCommandBufferInheritanceInfo inheritanceInfo{};
+            inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritanceInfo.renderPass = renderPass;
+            inheritanceInfo.subpass = 0;
+            inheritanceInfo.framebuffer = swapChainFramebuffers[imageIndex];
+
+            VkCommandBufferBeginInfo secondaryBeginInfo{};
+            secondaryBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            secondaryBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            secondaryBeginInfo.pInheritanceInfo = &inheritanceInfo;
+            if (vkBeginCommandBuffer(recorder.commandBuffer, &secondaryBeginInfo) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to begin recording secondary command buffer!");
+            }
+
+            const size_t first = chunk * drawsPerChunk;
+            const size_t count = std::min(drawsPerChunk, sceneDraws.size() - first);
+            recordSceneState(recorder.commandBuffer);
+            RenderStateCache cache;
+            cache.commandBuffer = recorder.commandBuffer;
+            cache.currentFrame = currentFrame;
+            recordSceneDraws(cache, first, count);
+            chunkStatistics[chunk] = cache.statistics;
+
+            if (vkEndCommandBuffer(recorder.commandBuffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to record secondary command buffer!");
+            } });
+
+        // 按区间顺序执行，绘制顺序与单线程录制时一致
+        std::vector<VkCommandBuffer> secondaries(chunkCount);
+        for (size_t chunk = 0; chunk < chunkCount; chunk++)
+        {
+            secondaries[chunk] = recorders[chunk].commandBuffer;
+        }
+        vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+
+        renderBindStatistics = RenderBindStatistics{};
+        for (const RenderBindStatistics &statistics : chunkStatistics)
+        {
+            renderBindStatistics += statistics;
+        }
+    }
 
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = swapChainExtent;
     /**
-     * 填充指令4：设置视口截取尺寸
+     * 填充指令6：结束RenderPass
      */
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    vkCmdEndRenderPass(commandBuffer);
+}
 
-    /**
-     * 填充指令5：绑定 vertex buffer（这将作为顶点数据源传入graphic pipeline）
-     */
-    VkBuffer vertexBuffers[] = {vertexBuffer};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+/**
+ *  更新/填充command buffer
+ *  draw time 函数，在渲染过程中更新
+ * */
+UploadWait recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, uint32_t currentFrame)
+{
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
-    /**
-     * 填充指令6：绑定 index buffer（这将作为顶点索引数据源传入graphic pipeline）
-     * 当有模型文件需要导入的时候，UINT16不够用，这里要使用UINT32类型记录INDEX
-     */
-    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    // 开始command buffer填充，如果 command buffer 是一个已经被填充的状态，则原来的状态将先被清空/重置
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin recording command buffer!");
+    }
 
-    /**
-     * 填充指令7：绑定描述符，这将每帧更新的MVP变换阵以pipelineLayout作为接口传入graphic pipeline
-     * 进行修改更新，并将更新后的描述符作用于每个顶点
-     */
-    vkCmdBindDescriptorSets(commandBuffer,
-                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            pipelineLayout,
-                            0,
-                            1,
-                            &descriptorSets[currentFrame],
-                            0,
-                            nullptr);
+    // 传输队列上传完成的资源在 render pass 之前取得所有权，提交时需要等待返回的 timeline 值
+    UploadWait uploadWait = recordUploadAcquires(commandBuffer);
 
-    /**
-     * 填充指令8：开始渲染，如果没有使用index bufer，则使用vkCmdDraw命令进行填充，否则使用vkCmdDrawIndexed
-     * 命令进行填充，第二参数为要绘制的顶点数量，由于vertex buffer原数组中有顶点复用，而这里我们需要未复用的总数量，
-     * 于是使用index buffer原数组的长度作为输入值。
-     */
-    vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
-
-    /**
-     * 填充指令9：结束RenderPass
-     */
-    vkCmdEndRenderPass(commandBuffer);
+    recordScenePass(commandBuffer, imageIndex, currentFrame, 0);
 
     // 结束 command buffer 填充
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to record command buffer!");
     }
+    return uploadWait;
+}
+
+/**
+ *  绘制列表是否与录制时相同（depth 只用于排序，不影响录制的命令，不参与比较）
+ * */
+static bool sameSceneDraws(const std::vector<SceneDraw> &recorded)
+{
+    if (recorded.size() != sceneDraws.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < recorded.size(); i++)
+    {
+        const SceneDraw &a = recorded[i];
+        const SceneDraw &b = sceneDraws[i];
+        if (a.indexCount != b.indexCount || a.instanceCount != b.instanceCount || a.firstIndex != b.firstIndex ||
+            a.vertexOffset != b.vertexOffset || a.firstInstance != b.firstInstance || a.mesh != b.mesh)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ *  取得本帧要提交的命令缓冲区
+ * */
+VkCommandBuffer prepareFrameCommandBuffer(uint32_t imageIndex, uint32_t currentFrame, UploadWait &uploadWait)
+{
+    if (!enablePrerecordedCommandBuffers)
+    {
+        // 重置并填充command buffer，用于提交到 graphic queue 对场景中的物体进行渲染
+        vkResetCommandBuffer(commandBuffers[currentFrame], 0);
+        uploadWait = recordCommandBuffer(commandBuffers[currentFrame], imageIndex, currentFrame);
+        return commandBuffers[currentFrame];
+    }
+
+    /*
+        预录制的命令缓冲区中不能录制 acquire 屏障（它们只能执行一次）：先提交暂存的上传命令，有待处理的上传时
+    用一次单次指令 acquire，同一队列上之后提交的帧按提交顺序在屏障之后执行。
+    */
+    uploadWait = UploadWait{};
+    submitStagingCommands();
+    if (hasPendingUploadAcquires())
+    {
+        flushUploadAcquires();
+    }
+
+    if (prerecordedCommandBuffers.empty())
+    {
+        prerecordedCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT * swapChainImages.size());
+        std::vector<VkCommandBuffer> allocated(prerecordedCommandBuffers.size());
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = static_cast<uint32_t>(allocated.size());
+        if (vkAllocateCommandBuffers(device, &allocInfo, allocated.data()) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate prerecorded command buffers!");
+        }
+        for (size_t i = 0; i < allocated.size(); i++)
+        {
+            prerecordedCommandBuffers[i].commandBuffer = allocated[i];
+        }
+    }
+
+    /*
+        绘制列表与上一帧不同时（相机移动导致 LOD/剔除结果变化），预录制的命令缓冲区下一帧多半又会失效，这一帧
+    按普通路径录制到 commandBuffers[currentFrame]（绘制较多时使用并行录制的次级命令缓冲区）。上面已经处理过
+    待处理的 acquire，recordUploadAcquires() 不会再录制屏障。绘制列表稳定之后再回到预录制的命令缓冲区。
+    */
+    const bool drawsChanged = !sameSceneDraws(previousFrameDraws);
+    if (drawsChanged)
+    {
+        previousFrameDraws = sceneDraws;
+        vkResetCommandBuffer(commandBuffers[currentFrame], 0);
+        uploadWait = recordCommandBuffer(commandBuffers[currentFrame], imageIndex, currentFrame);
+        return commandBuffers[currentFrame];
+    }
+
+    PrerecordedCommandBuffer &prerecorded = prerecordedCommandBuffers[currentFrame * swapChainImages.size() + imageIndex];
+    if (prerecorded.generation == commandBufferGeneration && sameSceneDraws(prerecorded.recordedDraws))
+    {
+        return prerecorded.commandBuffer;
+    }
+
+    // 该命令缓冲区只随 inFlightFences[currentFrame] 提交，调用前已经等待过，可以直接重置
+    vkResetCommandBuffer(prerecorded.commandBuffer, 0);
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    if (vkBeginCommandBuffer(prerecorded.commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin recording command buffer!");
+    }
+    // 次级命令缓冲区所在的命令池每次录制都会被重置，预录制时只能直接录制在主命令缓冲区中
+    recordScenePass(prerecorded.commandBuffer, imageIndex, currentFrame, 1);
+    if (vkEndCommandBuffer(prerecorded.commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record command buffer!");
+    }
+
+    prerecorded.generation = commandBufferGeneration;
+    prerecorded.recordedDraws = sceneDraws;
+    return prerecorded.commandBuffer;
+}
+
+/**
+ *  标记所有预录制的命令缓冲区需要重新录制
+ * */
+void invalidateCommandBuffers()
+{
+    commandBufferGeneration++;
+}
+
+/**
+ *  释放所有预录制的命令缓冲区
+ * */
+void freePrerecordedCommandBuffers()
+{
+    for (PrerecordedCommandBuffer &prerecorded : prerecordedCommandBuffers)
+    {
+        vkFreeCommandBuffers(device, commandPool, 1, &prerecorded.commandBuffer);
+    }
+    prerecordedCommandBuffers.clear();
+}
+
+/**
+ *  并行录制测试
+ * */
+void benchmarkCommandRecording()
+{
+    if (!enableParallelRecording || modelMeshes.empty())
+    {
+        std::cout << "command recording benchmark: parallel recording is disabled" << std::endl;
+        return;
+    }
+    if (gpuCullingActive)
+    {
+        std::cout << "command recording benchmark: gpu culling is active, draws are generated on the gpu" << std::endl;
+        return;
+    }
+
+    // 测试期间不提交，只需要保证第 0 帧的命令缓冲区与命令池不再被 GPU 使用
+    vkDeviceWaitIdle(device);
+
+    // 把场景展开为逐实例绘制（不做实例化合并），得到大量绘制
+    std::vector<SceneDraw> savedDraws = sceneDraws;
+    sceneDraws.clear();
+    sceneDraws.reserve(COMMAND_RECORDING_BENCHMARK_DRAWS);
+    for (uint32_t i = 0; i < COMMAND_RECORDING_BENCHMARK_DRAWS; i++)
+    {
+        const uint32_t m = i % static_cast<uint32_t>(modelMeshes.size());
+        const ModelMesh &mesh = modelMeshes[m];
+        const SceneMeshInstances &instances = sceneMeshInstances[m];
+        const uint32_t instance = instances.instanceCount == 0 ? 0 : instances.firstInstance + (i / modelMeshes.size()) % instances.instanceCount;
+        sceneDraws.push_back(SceneDraw{mesh.lods[0].indexCount, 1, mesh.firstIndex + mesh.lods[0].indexOffset,
+                                       static_cast<int32_t>(mesh.baseVertex), instance, m, 0.0f});
+    }
+    // 展开后各网格的绘制交错排列，按排序键排序后相同状态的绘制相邻
+    if (enableRenderQueueSort)
+    {
+        sortSceneDraws();
+    }
+
+    std::cout << "---------- command recording benchmark (" << sceneDraws.size() << " draws) ----------" << std::endl;
+
+    // 线程数 1, 2, 4, ... 直到每帧的命令池数量（1 个线程时直接录制在主命令缓冲区中，即原来的单线程录制）
+    const size_t maxThreads = secondaryRecorders[0].size();
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double singleThreadTime = 0.0;
+    for (size_t threads : threadCounts)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < COMMAND_RECORDING_BENCHMARK_FRAMES; frame++)
+        {
+            vkResetCommandBuffer(commandBuffers[0], 0);
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            if (vkBeginCommandBuffer(commandBuffers[0], &beginInfo) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to begin recording command buffer!");
+            }
+            recordScenePass(commandBuffers[0], 0, 0, threads);
+            if (vkEndCommandBuffer(commandBuffers[0]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to record command buffer!");
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double frameTime = std::chrono::duration<double, std::milli>(end - start).count() / COMMAND_RECORDING_BENCHMARK_FRAMES;
+        if (threads == 1)
+        {
+            singleThreadTime = frameTime;
+        }
+        std::cout << "    " << threads << " threads: " << frameTime << " ms/frame, "
+                  << sceneDraws.size() / frameTime / 1e3 << " M draws/s, speedup " << singleThreadTime / frameTime << "x" << std::endl;
+    }
+    std::cout << "    ";
+    printRenderBindStatistics(renderBindStatistics);
+
+    vkResetCommandBuffer(commandBuffers[0], 0);
+    sceneDraws = std::move(savedDraws);
+}
+
+/**
+ *  释放已经完成的单次指令，wait 为 true 时等待全部完成
+ * */
+static void releaseSingleTimeCommands(bool wait)
+{
+    size_t kept = 0;
+    for (SingleTimeSubmission &submission : singleTimeSubmissions)
+    {
+        if (wait)
+        {
+            vkWaitForFences(device, 1, &submission.fence, VK_TRUE, UINT64_MAX);
+        }
+        else if (vkGetFenceStatus(device, submission.fence) != VK_SUCCESS)
+        {
+            singleTimeSubmissions[kept++] = submission;
+            continue;
+        }
+        vkFreeCommandBuffers(device, commandPool, 1, &submission.commandBuffer);
+        vkDestroyFence(device, submission.fence, nullptr);
+    }
+    singleTimeSubmissions.resize(kept);
 }
 
 /**
@@ -180,6 +597,9 @@ VkCommandBuffer beginSingleTimeCommands()
     allocInfo.commandPool = commandPool;
     allocInfo.commandBufferCount = 1;
 
+    // 顺便回收之前已经完成的单次指令
+    releaseSingleTimeCommands(false);
+
     VkCommandBuffer commandBuffer;
     vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
 
@@ -189,11 +609,15 @@ VkCommandBuffer beginSingleTimeCommands()
 
     vkBeginCommandBuffer(commandBuffer, &beginInfo);
 
+    // 单次指令通常紧接着上传使用刚上传的资源（例如 generateMipmaps），先取得它们的所有权
+    singleTimeUploadWait = recordUploadAcquires(commandBuffer);
+
     return commandBuffer;
 }
 
 /**
  *  结束一个 用于提交单次指令的 command buffer 的填充，并将其送入 graphic queue 进行执行
+ *  不再 vkQueueWaitIdle：同一队列上之后提交的命令按提交顺序在它之后执行，命令缓冲在 fence 触发后释放
  * */
 void endSingleTimeCommands(VkCommandBuffer commandBuffer)
 {
@@ -204,13 +628,65 @@ void endSingleTimeCommands(VkCommandBuffer commandBuffer)
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
+    // 录制了 acquire 屏障时等待对应的上传批次（timeline semaphore）
+    VkSemaphore uploadSemaphore = getUploadTimelineSemaphore();
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = 1;
+    timelineInfo.pWaitSemaphoreValues = &singleTimeUploadWait.value;
+    if (singleTimeUploadWait.value != 0)
+    {
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &uploadSemaphore;
+        submitInfo.pWaitDstStageMask = &singleTimeUploadWait.stages;
+    }
 
-    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+    SingleTimeSubmission submission;
+    submission.commandBuffer = commandBuffer;
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkCreateFence(device, &fenceInfo, nullptr, &submission.fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create single time command fence!");
+    }
+
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, submission.fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit single time commands!");
+    }
+    singleTimeSubmissions.push_back(submission);
+    singleTimeUploadWait = UploadWait{};
+}
+
+/**
+ *  用一次空的单次指令在图形队列上 acquire 所有待处理的上传
+ * */
+void flushUploadAcquires()
+{
+    endSingleTimeCommands(beginSingleTimeCommands());
+}
+
+/**
+ *  等待所有已提交的单次指令完成并释放
+ * */
+void waitSingleTimeCommandsIdle()
+{
+    releaseSingleTimeCommands(true);
 }
 
 void cleanupCommandPool()
 {
+    waitSingleTimeCommandsIdle();
+    freePrerecordedCommandBuffers();
+    for (auto &frameRecorders : secondaryRecorders)
+    {
+        for (SecondaryRecorder &recorder : frameRecorders)
+        {
+            // 命令池注销时其中的命令缓冲区一并释放
+            vkDestroyCommandPool(device, recorder.pool, nullptr);
+        }
+    }
+    secondaryRecorders.clear();
     vkDestroyCommandPool(device, commandPool, nullptr);
 }
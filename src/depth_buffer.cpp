@@ -1,7 +1,7 @@
 #include "depth_buffer.h"
 
 VkImage depthImage;
-VkDeviceMemory depthImageMemory;
+MemoryAllocation depthImageMemory;
 VkImageView depthImageView;
 
 /**
@@ -75,3 +75,13 @@ bool hasStencilComponent(VkFormat format)
 {
     return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
 }
+
+/**
+ *  注销深度图及其 ImageView，释放对应的内存
+ * */
+void cleanupDepthResources()
+{
+    vkDestroyImageView(device, depthImageView, nullptr);
+    vkDestroyImage(device, depthImage, nullptr);
+    freeMemoryAllocation(depthImageMemory);
+}
@@ -0,0 +1,440 @@
+#include "gpu_culling.h"
+
+#include "graphic_pipeline/utils.h"
+#include "shaders/cull_objects.spv.h"
+
+#include <cmath>
+
+const bool enableGpuCulling = true;
+bool gpuCullingActive = false;
+
+static const uint32_t CULL_WORKGROUP_SIZE = 64;                                // 与 cull_objects.comp 中的 local_size_x 一致
+static const VkDeviceSize DRAW_BUFFER_HEADER_SIZE = 16;                        // 间接绘制缓冲开头每个分组的 drawCount（最多 4 组）
+static const uint32_t DRAW_COMMAND_STRIDE = sizeof(VkDrawIndexedIndirectCommand);
+static const uint32_t MAX_DRAW_GROUPS = DRAW_BUFFER_HEADER_SIZE / sizeof(uint32_t);
+
+VkDescriptorSetLayout cullDescriptorSetLayout = VK_NULL_HANDLE;
+VkPipelineLayout cullPipelineLayout = VK_NULL_HANDLE;
+VkPipeline cullPipeline = VK_NULL_HANDLE;
+VkDescriptorPool cullDescriptorPool = VK_NULL_HANDLE;
+std::vector<VkDescriptorSet> cullDescriptorSets; // 每帧一个
+
+std::vector<VkBuffer> cullParamsBuffers; // 每帧的剔除参数（HOST_VISIBLE，常驻映射）
+std::vector<MemoryAllocation> cullParamsBuffersMemory;
+
+VkBuffer cullObjectBuffer = VK_NULL_HANDLE; // 所有物体
+MemoryAllocation cullObjectBufferMemory;
+VkBuffer cullLodBuffer = VK_NULL_HANDLE; // 所有网格的 LOD 链
+MemoryAllocation cullLodBufferMemory;
+std::vector<VkBuffer> drawBuffers; // 每帧的间接绘制缓冲：各分组的 drawCount + VkDrawIndexedIndirectCommand[objectCount]
+std::vector<MemoryAllocation> drawBuffersMemory;
+
+uint32_t cullObjectCount = 0; // 当前场景的物体数量
+
+/**
+ *  使用同一条图形管线的物体组成一个绘制分组，在间接绘制缓冲中占 [firstDraw, firstDraw + objectCount) 的命令
+ * */
+struct GpuDrawGroup
+{
+    uint32_t pipeline;
+    uint32_t firstDraw;
+    uint32_t objectCount;
+    uint32_t maxDraws; // 一次间接绘制最多发出的命令数（maxDrawIndirectCount 与组内物体数量取小）
+};
+std::vector<GpuDrawGroup> drawGroups;
+
+PFN_vkCmdDrawIndexedIndirectCount cmdDrawIndexedIndirectCount = nullptr; // 1.2 的核心函数，通过 vkGetDeviceProcAddr 取得
+
+/**
+ *  创建剔除用的 compute pipeline、描述符与每帧的参数缓冲
+ * */
+void createGpuCullingPipeline()
+{
+    gpuCullingActive = enableGpuCulling && multiDrawIndirectEnabled;
+    if (!gpuCullingActive)
+    {
+        if (enableGpuCulling)
+        {
+            std::cout << "gpu culling: multiDrawIndirect is not supported, using cpu draw lists" << std::endl;
+        }
+        return;
+    }
+
+    if (drawIndirectCountEnabled)
+    {
+        cmdDrawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCount>(vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCount"));
+    }
+    std::cout << "gpu culling: " << (cmdDrawIndexedIndirectCount ? "vkCmdDrawIndexedIndirectCount" : "vkCmdDrawIndexedIndirect (drawIndirectCount is not supported)") << std::endl;
+
+    // binding 0 为剔除参数，1/2 为物体与 LOD，3 为本帧的间接绘制缓冲
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); i++)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &cullDescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create culling descriptor set layout!");
+    }
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &cullDescriptorSetLayout;
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &cullPipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create culling pipeline layout!");
+    }
+
+    VkShaderModule cullShaderModule = createShaderModule(cull_objects_spv);
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = cullShaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = cullPipelineLayout;
+    if (vkCreateComputePipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &cullPipeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create culling pipeline!");
+    }
+    vkDestroyShaderModule(device, cullShaderModule, nullptr);
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT * 3);
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &cullDescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create culling descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, cullDescriptorSetLayout);
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = cullDescriptorPool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    allocInfo.pSetLayouts = layouts.data();
+    cullDescriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
+    if (vkAllocateDescriptorSets(device, &allocInfo, cullDescriptorSets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate culling descriptor sets!");
+    }
+
+    // 剔除参数每帧由 CPU 写入，与 uniform buffer 一样直接放在 HOST_VISIBLE 的内存上
+    cullParamsBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    cullParamsBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
+    for (size_t i = 0; i < static_cast<size_t>(MAX_FRAMES_IN_FLIGHT); i++)
+    {
+        createBuffer(sizeof(GpuCullParams),
+                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     cullParamsBuffers[i],
+                     cullParamsBuffersMemory[i]);
+
+        VkDescriptorBufferInfo paramsInfo{};
+        paramsInfo.buffer = cullParamsBuffers[i];
+        paramsInfo.offset = 0;
+        paramsInfo.range = sizeof(GpuCullParams);
+
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = cullDescriptorSets[i];
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &paramsInfo;
+        vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+    }
+}
+
+/**
+ *  按当前场景创建物体/LOD 缓冲与每帧的间接绘制缓冲
+ * */
+void createGpuCullingBuffers()
+{
+    if (!gpuCullingActive)
+    {
+        return;
+    }
+
+    // 所有网格的 LOD 链依次存放，firstIndex 换算为 index buffer 中的绝对位置
+    std::vector<GpuCullLod> lods;
+    std::vector<uint32_t> meshFirstLods(modelMeshes.size());
+    for (size_t m = 0; m < modelMeshes.size(); m++)
+    {
+        const ModelMesh &mesh = modelMeshes[m];
+        meshFirstLods[m] = static_cast<uint32_t>(lods.size());
+        for (const MeshLod &lod : mesh.lods)
+        {
+            lods.push_back(GpuCullLod{mesh.firstIndex + lod.indexOffset, lod.indexCount, lod.error, 0});
+        }
+    }
+
+    cullObjectCount = static_cast<uint32_t>(sceneInstances.size());
+
+    // 按网格的图形管线把物体分组，每组的命令在间接绘制缓冲中连续存放，按管线编号排列
+    std::vector<uint32_t> pipelineObjectCounts(graphicsPipelines.size(), 0);
+    for (const SceneInstance &instance : sceneInstances)
+    {
+        pipelineObjectCounts[modelMeshes[instance.mesh].pipeline]++;
+    }
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    std::vector<uint32_t> pipelineGroups(graphicsPipelines.size(), 0);
+    uint32_t firstDraw = 0;
+    drawGroups.clear();
+    for (uint32_t pipeline = 0; pipeline < pipelineObjectCounts.size(); pipeline++)
+    {
+        const uint32_t objectCount = pipelineObjectCounts[pipeline];
+        if (objectCount == 0)
+        {
+            continue;
+        }
+        pipelineGroups[pipeline] = static_cast<uint32_t>(drawGroups.size());
+        GpuDrawGroup group{pipeline, firstDraw, objectCount, std::min(objectCount, properties.limits.maxDrawIndirectCount)};
+        if (group.maxDraws < objectCount)
+        {
+            std::cout << "gpu culling: " << objectCount << " objects of pipeline " << pipeline << " exceed maxDrawIndirectCount ("
+                      << group.maxDraws << "), only the first visible ones are drawn" << std::endl;
+        }
+        drawGroups.push_back(group);
+        firstDraw += objectCount;
+    }
+    if (drawGroups.size() > MAX_DRAW_GROUPS)
+    {
+        throw std::runtime_error("too many graphics pipelines for gpu culling draw groups!");
+    }
+
+    // 缓冲区大小不能为 0，物体/LOD 为空时仍然创建最小的缓冲区，保证描述符始终有效
+    createBuffer(sizeof(GpuCullObject) * std::max<size_t>(cullObjectCount, 1),
+                 VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                 cullObjectBuffer,
+                 cullObjectBufferMemory);
+    createBuffer(sizeof(GpuCullLod) * std::max<size_t>(lods.size(), 1),
+                 VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                 cullLodBuffer,
+                 cullLodBufferMemory);
+
+    // 包围球换算到场景空间（实例变换为旋转 + 统一缩放 + 平移），直接写入暂存空间
+    uploadElementsToBuffer(cullObjectBuffer, 0, cullObjectCount, sizeof(GpuCullObject),
+                           [&meshFirstLods, &pipelineGroups](void *destination, size_t first, size_t count)
+                           {
+                               GpuCullObject *objects = static_cast<GpuCullObject *>(destination);
+                               for (size_t i = 0; i < count; i++)
+                               {
+                                   const SceneInstance &instance = sceneInstances[first + i];
+                                   const ModelMesh &mesh = modelMeshes[instance.mesh];
+                                   GpuCullObject &object = objects[i];
+                                   glm::vec3 center = glm::vec3(instance.transform * glm::vec4(glm::vec3(mesh.boundingSphere), 1.0f));
+                                   object.sphere = glm::vec4(center, mesh.boundingSphere.w * instance.scale);
+                                   object.scale = instance.scale;
+                                   object.firstLod = meshFirstLods[instance.mesh];
+                                   object.lodCount = static_cast<uint32_t>(mesh.lods.size());
+                                   object.vertexOffset = static_cast<int32_t>(mesh.baseVertex);
+                                   object.instanceIndex = static_cast<uint32_t>(first + i);
+                                   object.drawGroup = pipelineGroups[mesh.pipeline];
+                                   object.firstDraw = drawGroups[object.drawGroup].firstDraw;
+                                   object.reserved = 0;
+                               }
+                           },
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    uploadToBuffer(cullLodBuffer, 0, lods.data(), sizeof(GpuCullLod) * lods.size(),
+                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    submitStagingCommands();
+
+    drawBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    drawBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
+    const VkDeviceSize drawBufferSize = DRAW_BUFFER_HEADER_SIZE + DRAW_COMMAND_STRIDE * std::max<VkDeviceSize>(cullObjectCount, 1);
+    for (size_t i = 0; i < static_cast<size_t>(MAX_FRAMES_IN_FLIGHT); i++)
+    {
+        createBuffer(drawBufferSize,
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                     drawBuffers[i],
+                     drawBuffersMemory[i]);
+
+        std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+        bufferInfos[0] = VkDescriptorBufferInfo{cullObjectBuffer, 0, VK_WHOLE_SIZE};
+        bufferInfos[1] = VkDescriptorBufferInfo{cullLodBuffer, 0, VK_WHOLE_SIZE};
+        bufferInfos[2] = VkDescriptorBufferInfo{drawBuffers[i], 0, VK_WHOLE_SIZE};
+
+        std::array<VkWriteDescriptorSet, 3> descriptorWrites{};
+        for (uint32_t b = 0; b < descriptorWrites.size(); b++)
+        {
+            descriptorWrites[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrites[b].dstSet = cullDescriptorSets[i];
+            descriptorWrites[b].dstBinding = b + 1;
+            descriptorWrites[b].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptorWrites[b].descriptorCount = 1;
+            descriptorWrites[b].pBufferInfo = &bufferInfos[b];
+        }
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+    }
+}
+
+/**
+ *  注销物体/LOD/间接绘制缓冲
+ * */
+void cleanupGpuCullingBuffers()
+{
+    if (!gpuCullingActive)
+    {
+        return;
+    }
+
+    vkDestroyBuffer(device, cullObjectBuffer, nullptr);
+    freeMemoryAllocation(cullObjectBufferMemory);
+    vkDestroyBuffer(device, cullLodBuffer, nullptr);
+    freeMemoryAllocation(cullLodBufferMemory);
+    for (size_t i = 0; i < drawBuffers.size(); i++)
+    {
+        vkDestroyBuffer(device, drawBuffers[i], nullptr);
+        freeMemoryAllocation(drawBuffersMemory[i]);
+    }
+    drawBuffers.clear();
+    drawBuffersMemory.clear();
+    cullObjectCount = 0;
+    drawGroups.clear();
+}
+
+/**
+ *  写入本帧的剔除参数
+ * */
+void updateGpuCulling(uint32_t currentFrame)
+{
+    GpuCullParams params{};
+    params.sceneView = frameViewMatrix * frameModelMatrix;
+
+    // 从 proj * view * model 中提取场景空间下的视锥平面（深度范围 [0, 1]），法线归一化后点到平面的值即为距离
+    const glm::mat4 clip = frameProjMatrix * params.sceneView;
+    auto row = [&clip](int i)
+    {
+        return glm::vec4(clip[0][i], clip[1][i], clip[2][i], clip[3][i]);
+    };
+    const glm::vec4 planes[6] = {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2)};
+    for (int i = 0; i < 6; i++)
+    {
+        float length = std::sqrt(planes[i].x * planes[i].x + planes[i].y * planes[i].y + planes[i].z * planes[i].z);
+        params.frustumPlanes[i] = planes[i] * (1.0f / length);
+    }
+
+    // proj[1][1] = 1 / tan(fovy / 2)，乘以半个屏幕高度即为单位距离处一个单位长度对应的像素数
+    params.pixelsPerUnit = std::abs(frameProjMatrix[1][1]) * swapChainExtent.height * 0.5f;
+    params.pixelThreshold = LOD_PIXEL_ERROR_THRESHOLD;
+    params.objectCount = cullObjectCount;
+    params.lodEnabled = enableMeshLod ? 1 : 0;
+
+    std::memcpy(cullParamsBuffersMemory[currentFrame].mapped, &params, sizeof(GpuCullParams));
+}
+
+/**
+ *  录制剔除的 compute pass
+ * */
+void recordGpuCulling(VkCommandBuffer commandBuffer, uint32_t currentFrame)
+{
+    VkBuffer drawBuffer = drawBuffers[currentFrame];
+
+    // 清零各组的 drawCount；没有 drawIndirectCount 时按组内物体总数绘制，整个缓冲清零使未写入的命令 instanceCount 为 0
+    VkDeviceSize clearSize = cmdDrawIndexedIndirectCount ? DRAW_BUFFER_HEADER_SIZE : VK_WHOLE_SIZE;
+    vkCmdFillBuffer(commandBuffer, drawBuffer, 0, clearSize, 0);
+
+    VkBufferMemoryBarrier clearBarrier{};
+    clearBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    clearBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    clearBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    clearBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    clearBarrier.buffer = drawBuffer;
+    clearBarrier.offset = 0;
+    clearBarrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         0, nullptr, 1, &clearBarrier, 0, nullptr);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipelineLayout,
+                            0, 1, &cullDescriptorSets[currentFrame], 0, nullptr);
+    vkCmdDispatch(commandBuffer, (cullObjectCount + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE, 1, 1);
+
+    // 剔除结果作为间接绘制的参数读取
+    VkBufferMemoryBarrier drawBarrier = clearBarrier;
+    drawBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    drawBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+                         0, nullptr, 1, &drawBarrier, 0, nullptr);
+}
+
+/**
+ *  在 render pass 中录制间接绘制：每个分组绑定自己的管线，计数取自缓冲开头对应的 drawCount
+ * */
+void recordGpuDraws(RenderStateCache &cache)
+{
+    VkBuffer drawBuffer = drawBuffers[cache.currentFrame];
+    for (uint32_t g = 0; g < drawGroups.size(); g++)
+    {
+        const GpuDrawGroup &group = drawGroups[g];
+        bindRenderState(cache, group.pipeline, 0, 0, 0);
+        const VkDeviceSize offset = DRAW_BUFFER_HEADER_SIZE + static_cast<VkDeviceSize>(DRAW_COMMAND_STRIDE) * group.firstDraw;
+        if (cmdDrawIndexedIndirectCount)
+        {
+            cmdDrawIndexedIndirectCount(cache.commandBuffer, drawBuffer, offset, drawBuffer, sizeof(uint32_t) * g,
+                                        group.maxDraws, DRAW_COMMAND_STRIDE);
+        }
+        else
+        {
+            vkCmdDrawIndexedIndirect(cache.commandBuffer, drawBuffer, offset, group.maxDraws, DRAW_COMMAND_STRIDE);
+        }
+    }
+}
+
+/**
+ *  当前场景的物体数量
+ * */
+uint32_t getGpuCullObjectCount()
+{
+    return cullObjectCount;
+}
+
+/**
+ *  注销剔除用的管线、描述符与参数缓冲
+ * */
+void cleanupGpuCulling()
+{
+    if (!gpuCullingActive)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < cullParamsBuffers.size(); i++)
+    {
+        vkDestroyBuffer(device, cullParamsBuffers[i], nullptr);
+        freeMemoryAllocation(cullParamsBuffersMemory[i]);
+    }
+    cullParamsBuffers.clear();
+    cullParamsBuffersMemory.clear();
+
+    // 描述符集随描述符池一起释放
+    vkDestroyDescriptorPool(device, cullDescriptorPool, nullptr);
+    vkDestroyPipeline(device, cullPipeline, nullptr);
+    vkDestroyPipelineLayout(device, cullPipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(device, cullDescriptorSetLayout, nullptr);
+}
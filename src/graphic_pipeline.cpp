@@ -1,7 +1,7 @@
 #include "graphic_pipeline.h"
 
 VkPipelineLayout pipelineLayout; // 图形渲染管线布局实例（运行时对管线进行修改/参数传入的接口实例）
-VkPipeline graphicsPipeline;     // 图形渲染管线实例
+std::array<VkPipeline, VERTEX_FORMAT_COUNT> graphicsPipelines; // 图形渲染管线实例，每种顶点格式一条
 
 const int MAX_FRAMES_IN_FLIGHT = 6; // CPU可以不加等待向GPU提交的最多任务量（CPU提交任务最多领先GPU多少个Loop）
 
@@ -11,14 +11,17 @@ const int MAX_FRAMES_IN_FLIGHT = 6; // CPU可以不加等待向GPU提交的最
 void createGraphicsPipeline()
 {
 
-    // 配置可编程部分的 vertex shader 和 fragment shader
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+    // 配置可编程部分的 vertex shader 和 fragment shader：每种顶点格式使用各自的顶点着色器，片段着色器共用
     VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-
-    VkShaderModule vertShaderModule = configure_vertex_shader(vertShaderStageInfo);
     VkShaderModule fragShaderModule = configure_fragment_shader(fragShaderStageInfo);
 
-    VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
+    std::array<std::array<VkPipelineShaderStageCreateInfo, 2>, VERTEX_FORMAT_COUNT> shaderStages{};
+    std::array<VkShaderModule, VERTEX_FORMAT_COUNT> vertShaderModules{};
+    for (uint32_t format = 0; format < VERTEX_FORMAT_COUNT; format++)
+    {
+        vertShaderModules[format] = configure_vertex_shader(shaderStages[format][0], static_cast<VertexFormat>(format));
+        shaderStages[format][1] = fragShaderStageInfo;
+    }
 
     // 下面开始对非可编程部分进行配置
 
@@ -31,8 +34,11 @@ void createGraphicsPipeline()
     /**
      *  vertex input 应该算作是一个“前处理阶段”，配置顶点数据的传入规则，如何从文件中导入顶点数据
      * */
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    configure_vertex_input(vertexInputInfo);
+    std::array<VkPipelineVertexInputStateCreateInfo, VERTEX_FORMAT_COUNT> vertexInputInfos{};
+    for (uint32_t format = 0; format < VERTEX_FORMAT_COUNT; format++)
+    {
+        configure_vertex_input(vertexInputInfos[format], static_cast<VertexFormat>(format));
+    }
 
     /**
      *  input assembler 输入汇编器，配置顶点将以怎样的规则被组合/装配成几何图形
@@ -91,8 +97,18 @@ void createGraphicsPipeline()
      * */
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout; // 指定描述符，在运行时通过更新MVP变换阵使得图像中的物体“动起来”
+    // 指定描述符，在运行时通过更新MVP变换阵使得图像中的物体“动起来”；bindless 模式下 set 1 为纹理数组
+    std::array<VkDescriptorSetLayout, 2> setLayouts = {descriptorSetLayout, bindlessDescriptorSetLayout};
+    pipelineLayoutInfo.setLayoutCount = bindlessTexturesActive ? 2 : 1;
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+
+    // 每个绘制的 push constants：网格局部变换在顶点着色器中使用，纹理下标在片段着色器中使用
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(DrawPushConstants);
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
     if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
     {
@@ -100,7 +116,7 @@ void createGraphicsPipeline()
     }
 
     /**
-     *  真正创建 pipeline
+     *  真正创建 pipeline：各条管线只有 shader 与 vertex input 不同
      */
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -109,12 +125,12 @@ void createGraphicsPipeline()
         第一步，从可编程的部分开始配置
         所以这一步是将shader相关的配置信息传入
     */
-    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pStages = shaderStages[0].data();
     /*
         第二步，配置“非可编程”的部分，也就是fixed stage
         同样是传入之前配置好的结构体
     */
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pVertexInputState = &vertexInputInfos[0];
     pipelineInfo.pInputAssemblyState = &inputAssembly;
     pipelineInfo.pViewportState = &viewportState;
     pipelineInfo.pRasterizationState = &rasterizer;
@@ -140,17 +156,34 @@ void createGraphicsPipeline()
 
     /*
         第六步，创建渲染管线
-        需要注意 vkCreateGraphicsPipelines 实际是被设计为一次调用创建多个图形渲染管线，但这里没有体现；
-    后面的章节中（缓存章节），我们将会看到，使用缓存机制同时创建多管线要比逐个创建要高效的多！
+        需要注意 vkCreateGraphicsPipelines 实际是被设计为一次调用创建多个图形渲染管线：这里每种顶点格式一条管线，
+    在同一次调用中一起创建。
+    */
+    std::array<VkGraphicsPipelineCreateInfo, VERTEX_FORMAT_COUNT> pipelineInfos;
+    for (uint32_t format = 0; format < VERTEX_FORMAT_COUNT; format++)
+    {
+        pipelineInfos[format] = pipelineInfo;
+        pipelineInfos[format].pStages = shaderStages[format].data();
+        pipelineInfos[format].pVertexInputState = &vertexInputInfos[format];
+    }
+
+    /*
+        传入共用的管线缓存：缓存中已有同样的管线（warm）时驱动可以跳过 SPIR-V 的编译
     */
-    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS)
+    auto start = std::chrono::high_resolution_clock::now();
+    if (vkCreateGraphicsPipelines(device, pipelineCache, static_cast<uint32_t>(pipelineInfos.size()), pipelineInfos.data(), nullptr, graphicsPipelines.data()) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to create graphics pipeline!");
     }
+    double createTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << graphicsPipelines.size() << " graphics pipelines created in " << createTime << " ms (" << (pipelineCacheWarm ? "warm" : "cold") << " pipeline cache)" << std::endl;
 
     // 注意，shader被以SPIR-V的字节码的形式被导入pipeline配置后，在程序中就是固定的了，也不会允许在运行时进行修改，所以这里可以直接销毁
     vkDestroyShaderModule(device, fragShaderModule, nullptr);
-    vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    for (VkShaderModule vertShaderModule : vertShaderModules)
+    {
+        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    }
 }
 
 /**
@@ -158,6 +191,9 @@ void createGraphicsPipeline()
  * */
 void cleanupGraphicPipeline()
 {
-    vkDestroyPipeline(device, graphicsPipeline, nullptr);
+    for (VkPipeline pipeline : graphicsPipelines)
+    {
+        vkDestroyPipeline(device, pipeline, nullptr);
+    }
     vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
 }
\ No newline at end of file
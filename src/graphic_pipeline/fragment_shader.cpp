@@ -1,18 +1,21 @@
 #include "graphic_pipeline/fragment_shader.h"
+#include "shaders/frag.spv.h"
+#include "shaders/frag_bindless.spv.h"
+
+#include "bindless_textures.h"
 
 
 
 /**
  *  配置 fragment shader 部分
  *  fragment shader 是整个vulkan graphic pipeline中的第六阶段
- *  进入函数前保证已经使用GLSL完成了对 fragment shader 的编辑，并已经使用glslc工具将其编译为了vulkan可直接识别
- * 的SPIR-V二进制码文件。
+ *  fragment shader 在构建时已由glslc编译为SPIR-V，并嵌入为 frag_spv 数组（见 CMakeLists.txt）。
+ *  bindless 模式下使用以 -DBINDLESS_TEXTURES 编译的 frag_bindless_spv，从纹理数组中按材质的下标采样。
  * */ 
 VkShaderModule configure_fragment_shader(VkPipelineShaderStageCreateInfo &fragShaderStageInfo)
 {
-    // 读取编译好的二进制码文件，并使用返回的二进制串构建 fragment shader module
-    auto fragShaderCode = readFile("../shaders/frag.spv");
-    VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+    // 使用嵌入的二进制码构建 fragment shader module
+    VkShaderModule fragShaderModule = bindlessTexturesActive ? createShaderModule(frag_bindless_spv) : createShaderModule(frag_spv);
 
     // 修改配置变量
     fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -3,7 +3,7 @@
 VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
 
 VkImage colorImage;
-VkDeviceMemory colorImageMemory;
+MemoryAllocation colorImageMemory;
 VkImageView colorImageView;
 
 /**
@@ -83,5 +83,5 @@ void cleanupMultiSampleColorResource()
 {
     vkDestroyImageView(device, colorImageView, nullptr);
     vkDestroyImage(device, colorImage, nullptr);
-    vkFreeMemory(device, colorImageMemory, nullptr);
+    freeMemoryAllocation(colorImageMemory);
 }
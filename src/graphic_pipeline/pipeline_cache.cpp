@@ -0,0 +1,190 @@
+#include "graphic_pipeline/pipeline_cache.h"
+#include "utils/hash.h"
+
+const std::string PIPELINE_CACHE_PATH = "pipeline_cache.bin";
+const bool enablePipelineCache = true;
+
+VkPipelineCache pipelineCache = VK_NULL_HANDLE; // 所有管线共用的管线缓存
+bool pipelineCacheWarm = false;                  // 是否成功载入了磁盘上的缓存数据
+
+static const char PIPELINE_CACHE_MAGIC[4] = {'V', 'P', 'S', 'O'};
+static const uint32_t PIPELINE_CACHE_FILE_VERSION = 1;
+
+/**
+ *  缓存文件头，之后紧跟 dataSize 字节的驱动缓存数据
+ * */
+struct PipelineCacheFileHeader
+{
+    char magic[4];     // "VPSO"
+    uint32_t version;  // PIPELINE_CACHE_FILE_VERSION
+    uint64_t dataSize; // 驱动缓存数据的字节数
+    uint64_t dataHash; // 驱动缓存数据的内容哈希
+};
+
+/**
+ *  校验驱动缓存数据的头部
+ * */
+bool validatePipelineCacheData(const uint8_t *data, size_t size, const VkPhysicalDeviceProperties &properties)
+{
+    /**
+     *  VkPipelineCacheHeaderVersionOne 的布局（各字段按小端的 uint32 依次排列）：
+     *  | headerSize | headerVersion | vendorID | deviceID | pipelineCacheUUID[VK_UUID_SIZE] |
+     * */
+    const size_t headerSize = 16 + VK_UUID_SIZE;
+    if (size < headerSize)
+    {
+        return false;
+    }
+
+    uint32_t fields[4];
+    std::memcpy(fields, data, sizeof(fields));
+    return fields[0] >= headerSize && fields[0] <= size &&
+           fields[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           fields[2] == properties.vendorID &&
+           fields[3] == properties.deviceID &&
+           std::memcmp(data + 16, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+/**
+ *  读取磁盘上的缓存数据，文件不存在、损坏或者与当前设备不匹配时返回空数组
+ * */
+static std::vector<uint8_t> loadPipelineCacheData(const VkPhysicalDeviceProperties &properties)
+{
+    std::ifstream file(PIPELINE_CACHE_PATH, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        std::cout << "pipeline cache: " << PIPELINE_CACHE_PATH << " not found, starting cold" << std::endl;
+        return {};
+    }
+
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    PipelineCacheFileHeader header{};
+    if (fileSize < sizeof(PipelineCacheFileHeader))
+    {
+        std::cout << "pipeline cache: " << PIPELINE_CACHE_PATH << " is truncated, ignored" << std::endl;
+        return {};
+    }
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(&header), sizeof(PipelineCacheFileHeader));
+    if (std::memcmp(header.magic, PIPELINE_CACHE_MAGIC, sizeof(PIPELINE_CACHE_MAGIC)) != 0 ||
+        header.version != PIPELINE_CACHE_FILE_VERSION ||
+        header.dataSize != fileSize - sizeof(PipelineCacheFileHeader))
+    {
+        std::cout << "pipeline cache: " << PIPELINE_CACHE_PATH << " has an invalid header, ignored" << std::endl;
+        return {};
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(header.dataSize));
+    file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file || hashBytes(data.data(), data.size()) != header.dataHash)
+    {
+        std::cout << "pipeline cache: " << PIPELINE_CACHE_PATH << " is corrupted, ignored" << std::endl;
+        return {};
+    }
+
+    // 驱动对不匹配的数据本应直接忽略，但有些驱动遇到其他设备的缓存会出错，这里先自己检查一遍
+    if (!validatePipelineCacheData(data.data(), data.size(), properties))
+    {
+        std::cout << "pipeline cache: " << PIPELINE_CACHE_PATH << " was created by another device or driver, ignored" << std::endl;
+        return {};
+    }
+    return data;
+}
+
+/**
+ *  创建管线缓存
+ * */
+void createPipelineCache()
+{
+    std::vector<uint8_t> initialData;
+    if (enablePipelineCache)
+    {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        initialData = loadPipelineCacheData(properties);
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = initialData.size();
+    cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+    if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+
+    pipelineCacheWarm = !initialData.empty();
+    if (pipelineCacheWarm)
+    {
+        std::cout << "pipeline cache: loaded " << initialData.size() << " bytes from " << PIPELINE_CACHE_PATH << std::endl;
+    }
+}
+
+/**
+ *  把当前的缓存数据写回磁盘
+ * */
+void savePipelineCache()
+{
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to query pipeline cache size!");
+    }
+    std::vector<uint8_t> data(dataSize);
+    if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, data.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to read pipeline cache data!");
+    }
+    data.resize(dataSize);
+
+    PipelineCacheFileHeader header{};
+    std::memcpy(header.magic, PIPELINE_CACHE_MAGIC, sizeof(PIPELINE_CACHE_MAGIC));
+    header.version = PIPELINE_CACHE_FILE_VERSION;
+    header.dataSize = data.size();
+    header.dataHash = hashBytes(data.data(), data.size());
+
+    const std::string tempPath = PIPELINE_CACHE_PATH + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("failed to create pipeline cache: " + tempPath);
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(PipelineCacheFileHeader));
+    out.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    out.close();
+
+    if (!out)
+    {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("failed to write pipeline cache: " + tempPath);
+    }
+
+    // rename 在同一文件系统内是原子的，下次启动要么读到旧缓存，要么读到完整的新缓存
+    if (std::rename(tempPath.c_str(), PIPELINE_CACHE_PATH.c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("failed to replace pipeline cache: " + PIPELINE_CACHE_PATH);
+    }
+    std::cout << "pipeline cache: saved " << data.size() << " bytes to " << PIPELINE_CACHE_PATH << std::endl;
+}
+
+/**
+ *  保存并注销管线缓存
+ * */
+void cleanupPipelineCache()
+{
+    if (enablePipelineCache)
+    {
+        // 写缓存失败不影响退出，下次启动从空缓存开始即可
+        try
+        {
+            savePipelineCache();
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "pipeline cache: " << e.what() << std::endl;
+        }
+    }
+    vkDestroyPipelineCache(device, pipelineCache, nullptr);
+    pipelineCache = VK_NULL_HANDLE;
+}
@@ -1,9 +1,11 @@
 #include "graphic_pipeline/vertex_input.h"
 
+#include "scene.h"
+
 /**
  *  配置顶点数据的传入规则
  * */
-void configure_vertex_input(VkPipelineVertexInputStateCreateInfo &vertexInputInfo)
+void configure_vertex_input(VkPipelineVertexInputStateCreateInfo &vertexInputInfo, VertexFormat format)
 {
     /*
     从文件中读取顶点信息并进行输入：
@@ -20,16 +22,36 @@ void configure_vertex_input(VkPipelineVertexInputStateCreateInfo &vertexInputInf
         在引入shader的pipeline中对应改写，如下：
         将刚刚配置的结构体通过执行内置成员函数的方式引入
     */
-    static VkVertexInputBindingDescription bindingDescription = Vertex::getBindingDescription();
-    static std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions = Vertex::getAttributeDescriptions();
+    // 每种格式各自保存一份描述，多条管线可以在同一次 vkCreateGraphicsPipelines 中创建
+    static std::array<std::array<VkVertexInputBindingDescription, 2>, VERTEX_FORMAT_COUNT> formatBindingDescriptions;
+    static std::array<std::vector<VkVertexInputAttributeDescription>, VERTEX_FORMAT_COUNT> formatAttributeDescriptions;
+    std::array<VkVertexInputBindingDescription, 2> &bindingDescriptions = formatBindingDescriptions[format];
+    std::vector<VkVertexInputAttributeDescription> &attributeDescriptions = formatAttributeDescriptions[format];
+    if (format == VERTEX_FORMAT_FLOAT)
+    {
+        bindingDescriptions[0] = Vertex::getBindingDescription();
+        std::array<VkVertexInputAttributeDescription, 3> floatAttributes = Vertex::getAttributeDescriptions();
+        attributeDescriptions.assign(floatAttributes.begin(), floatAttributes.end());
+    }
+    else
+    {
+        // 紧凑顶点格式，需要配合 vert_packed*.spv 使用
+        bindingDescriptions[0] = PackedVertex::getBindingDescription(format);
+        attributeDescriptions = PackedVertex::getAttributeDescriptions(format);
+    }
+
+    // 实例数据（binding 1，location 3~7），每个实例前进一次
+    bindingDescriptions[1] = InstanceData::getBindingDescription();
+    std::array<VkVertexInputAttributeDescription, 5> instanceAttributes = InstanceData::getAttributeDescriptions();
+    attributeDescriptions.insert(attributeDescriptions.end(), instanceAttributes.begin(), instanceAttributes.end());
 
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     // vertexInputInfo.vertexBindingDescriptionCount = 0;
     // vertexInputInfo.vertexAttributeDescriptionCount = 0;
     // 不再将顶点数据从vertex shader文件中写死，而是从程序中定义并导入
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
     vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
     vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 
 }
@@ -1,17 +1,32 @@
 #include "graphic_pipeline/vertex_shader.h"
+#include "vertex_buffer.h"
+#include "shaders/vert.spv.h"
+#include "shaders/vert_packed.spv.h"
+#include "shaders/vert_packed_color.spv.h"
 
 
 /**
  *  配置 vertex shader 部分
  *  vertex shader 是整个vulkan graphic pipeline中的第二阶段
- *  进入函数前保证已经使用GLSL完成了对 vertex shader 的编辑，并已经使用glslc工具将其编译为了vulkan可直接识别
- * 的SPIR-V二进制码文件。
+ *  vertex shader 在构建时已由glslc编译为SPIR-V，并嵌入为 vert_spv 等数组（见 CMakeLists.txt）。
  * */ 
-VkShaderModule configure_vertex_shader(VkPipelineShaderStageCreateInfo &vertShaderStageInfo)
+VkShaderModule configure_vertex_shader(VkPipelineShaderStageCreateInfo &vertShaderStageInfo, VertexFormat format)
 {
-    // 读取编译好的二进制码文件，并使用返回的二进制串构建 vertex shader module
-    auto vertShaderCode = readFile("../shaders/vert.spv");
-    VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
+    // 使用嵌入的二进制码构建 vertex shader module
+    // 顶点着色器需要与管线对应的顶点格式匹配
+    VkShaderModule vertShaderModule;
+    if (format == VERTEX_FORMAT_PACKED)
+    {
+        vertShaderModule = createShaderModule(vert_packed_spv);
+    }
+    else if (format == VERTEX_FORMAT_PACKED_COLOR)
+    {
+        vertShaderModule = createShaderModule(vert_packed_color_spv);
+    }
+    else
+    {
+        vertShaderModule = createShaderModule(vert_spv);
+    }
 
     // 修改配置变量
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -0,0 +1,926 @@
+#include "image/bc_encoder.h"
+
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    // 每个并行任务至少处理的块数
+    const size_t BC_BLOCKS_PER_TASK = 256;
+
+    // BC7 4 位索引对应的插值权重（/64）
+    const int BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    typedef float BlockColors[16][4];
+
+    inline int clampInt(int v, int lo, int hi)
+    {
+        return v < lo ? lo : (v > hi ? hi : v);
+    }
+
+    inline float clampColor(float v)
+    {
+        return v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v);
+    }
+
+    /**
+     *  对块内像素的前 channels 个通道做主成分分析：返回均值与主轴方向（协方差矩阵的最大特征向量，幂迭代求得）
+     * */
+    void computePrincipalAxis(const BlockColors &colors, int channels, float mean[4], float axis[4])
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            mean[c] = 0.0f;
+            axis[c] = 0.0f;
+        }
+        for (int i = 0; i < 16; i++)
+        {
+            for (int c = 0; c < channels; c++)
+            {
+                mean[c] += colors[i][c];
+            }
+        }
+        for (int c = 0; c < channels; c++)
+        {
+            mean[c] /= 16.0f;
+        }
+
+        float covariance[4][4] = {};
+        for (int i = 0; i < 16; i++)
+        {
+            float d[4];
+            for (int c = 0; c < channels; c++)
+            {
+                d[c] = colors[i][c] - mean[c];
+            }
+            for (int r = 0; r < channels; r++)
+            {
+                for (int c = 0; c < channels; c++)
+                {
+                    covariance[r][c] += d[r] * d[c];
+                }
+            }
+        }
+
+        // 以对角线最大的通道作为初始向量，避免初始向量恰好与主轴正交
+        int largest = 0;
+        for (int c = 1; c < channels; c++)
+        {
+            if (covariance[c][c] > covariance[largest][largest])
+            {
+                largest = c;
+            }
+        }
+        for (int c = 0; c < channels; c++)
+        {
+            axis[c] = covariance[largest][c];
+        }
+
+        for (int iteration = 0; iteration < 8; iteration++)
+        {
+            float next[4] = {};
+            float maxComponent = 0.0f;
+            for (int r = 0; r < channels; r++)
+            {
+                for (int c = 0; c < channels; c++)
+                {
+                    next[r] += covariance[r][c] * axis[c];
+                }
+                maxComponent = std::max(maxComponent, std::fabs(next[r]));
+            }
+            if (maxComponent <= 0.0f)
+            {
+                break;
+            }
+            for (int c = 0; c < channels; c++)
+            {
+                axis[c] = next[c] / maxComponent;
+            }
+        }
+    }
+
+    /**
+     *  取主轴方向上投影最小/最大的像素作为初始端点
+     * */
+    void selectInitialEndpoints(const BlockColors &colors, int channels, float e0[4], float e1[4])
+    {
+        float mean[4], axis[4];
+        computePrincipalAxis(colors, channels, mean, axis);
+
+        int minIndex = 0, maxIndex = 0;
+        float minProjection = std::numeric_limits<float>::max();
+        float maxProjection = -std::numeric_limits<float>::max();
+        for (int i = 0; i < 16; i++)
+        {
+            float projection = 0.0f;
+            for (int c = 0; c < channels; c++)
+            {
+                projection += (colors[i][c] - mean[c]) * axis[c];
+            }
+            if (projection < minProjection)
+            {
+                minProjection = projection;
+                minIndex = i;
+            }
+            if (projection > maxProjection)
+            {
+                maxProjection = projection;
+                maxIndex = i;
+            }
+        }
+        for (int c = 0; c < 4; c++)
+        {
+            e0[c] = colors[maxIndex][c];
+            e1[c] = colors[minIndex][c];
+        }
+    }
+
+    /**
+     *  固定每个像素的插值权重（0 对应 e0，1 对应 e1），用最小二乘重新拟合两个端点，矩阵奇异时返回 false
+     * */
+    bool fitEndpoints(const BlockColors &colors, const float weights[16], int channels, float e0[4], float e1[4])
+    {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        float x[4] = {}, y[4] = {};
+        for (int i = 0; i < 16; i++)
+        {
+            float w = weights[i];
+            float v = 1.0f - w;
+            a += v * v;
+            b += v * w;
+            c += w * w;
+            for (int ch = 0; ch < channels; ch++)
+            {
+                x[ch] += v * colors[i][ch];
+                y[ch] += w * colors[i][ch];
+            }
+        }
+        float determinant = a * c - b * b;
+        if (std::fabs(determinant) < 1e-6f)
+        {
+            return false;
+        }
+        for (int ch = 0; ch < channels; ch++)
+        {
+            e0[ch] = clampColor((c * x[ch] - b * y[ch]) / determinant);
+            e1[ch] = clampColor((a * y[ch] - b * x[ch]) / determinant);
+        }
+        return true;
+    }
+
+    /**
+     *  简单的按位写入/读取（低位在前），BC7 的字段按此顺序紧密排列
+     * */
+    struct BitWriter
+    {
+        uint8_t *bytes;
+        uint32_t position = 0;
+
+        void write(uint32_t value, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++, position++)
+            {
+                if ((value >> i) & 1u)
+                {
+                    bytes[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+                }
+            }
+        }
+    };
+
+    struct BitReader
+    {
+        const uint8_t *bytes;
+        uint32_t position = 0;
+
+        uint32_t read(uint32_t count)
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < count; i++, position++)
+            {
+                value |= static_cast<uint32_t>((bytes[position >> 3] >> (position & 7)) & 1u) << i;
+            }
+            return value;
+        }
+    };
+
+    void loadColors(const uint8_t *pixels, BlockColors &colors)
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                colors[i][c] = pixels[4 * i + c];
+            }
+        }
+    }
+
+    /* ---------------------------------------- BC1 ---------------------------------------- */
+
+    inline uint16_t packRgb565(const float color[4])
+    {
+        int r = clampInt(static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+        int g = clampInt(static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+        int b = clampInt(static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    inline void unpackRgb565(uint16_t packed, int color[3])
+    {
+        int r = (packed >> 11) & 31;
+        int g = (packed >> 5) & 63;
+        int b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    /**
+     *  BC1 四色模式的调色板：c0, c1, (2c0 + c1) / 3, (c0 + 2c1) / 3
+     * */
+    void buildBc1Palette(uint16_t c0, uint16_t c1, bool fourColor, int palette[4][4])
+    {
+        unpackRgb565(c0, palette[0]);
+        unpackRgb565(c1, palette[1]);
+        palette[0][3] = palette[1][3] = 255;
+        for (int c = 0; c < 3; c++)
+        {
+            if (fourColor)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        palette[2][3] = 255;
+        palette[3][3] = fourColor ? 255 : 0;
+    }
+
+    struct Bc1Result
+    {
+        uint16_t c0, c1;
+        uint32_t indices;
+        float error;
+    };
+
+    /**
+     *  以给定端点编码颜色块（总是使用四色模式，c0 > c1）
+     * */
+    Bc1Result tryBc1Endpoints(const BlockColors &colors, const float e0[4], const float e1[4])
+    {
+        Bc1Result result{packRgb565(e0), packRgb565(e1), 0, 0.0f};
+        if (result.c0 < result.c1)
+        {
+            std::swap(result.c0, result.c1);
+        }
+
+        int palette[4][4];
+        buildBc1Palette(result.c0, result.c1, true, palette);
+        // c0 == c1 时解码器会进入三色模式（索引 3 为黑色），此时只使用索引 0
+        int paletteSize = result.c0 == result.c1 ? 1 : 4;
+
+        for (int i = 0; i < 16; i++)
+        {
+            int bestIndex = 0;
+            float bestError = std::numeric_limits<float>::max();
+            for (int p = 0; p < paletteSize; p++)
+            {
+                float error = 0.0f;
+                for (int c = 0; c < 3; c++)
+                {
+                    float d = colors[i][c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            result.indices |= static_cast<uint32_t>(bestIndex) << (2 * i);
+            result.error += bestError;
+        }
+        return result;
+    }
+
+    /**
+     *  单色块的最优端点表：对每个 8 位值给出一对 5/6 位端点，使调色板索引 2 的 (2c0 + c1) / 3 最接近该值
+     * */
+    struct SingleColorTable
+    {
+        uint8_t endpoints[256][2];
+
+        explicit SingleColorTable(int bits)
+        {
+            const int levels = 1 << bits;
+            for (int value = 0; value < 256; value++)
+            {
+                int bestError = std::numeric_limits<int>::max();
+                for (int a = 0; a < levels && bestError > 0; a++)
+                {
+                    int expandedA = (a << (8 - bits)) | (a >> (2 * bits - 8));
+                    for (int b = 0; b < levels; b++)
+                    {
+                        int expandedB = (b << (8 - bits)) | (b >> (2 * bits - 8));
+                        int error = std::abs((2 * expandedA + expandedB) / 3 - value);
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            endpoints[value][0] = static_cast<uint8_t>(a);
+                            endpoints[value][1] = static_cast<uint8_t>(b);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     *  整块为同一 RGB 时直接查表，避免端点量化到 565 后的误差（PCA 得到的两个端点重合，只能用 c0 表示颜色）
+     * */
+    bool encodeBc1SingleColor(const BlockColors &colors, uint8_t *block)
+    {
+        for (int i = 1; i < 16; i++)
+        {
+            if (colors[i][0] != colors[0][0] || colors[i][1] != colors[0][1] || colors[i][2] != colors[0][2])
+            {
+                return false;
+            }
+        }
+
+        static const SingleColorTable table5(5), table6(6);
+        const uint8_t *r = table5.endpoints[static_cast<int>(colors[0][0])];
+        const uint8_t *g = table6.endpoints[static_cast<int>(colors[0][1])];
+        const uint8_t *b = table5.endpoints[static_cast<int>(colors[0][2])];
+        uint16_t c0 = static_cast<uint16_t>((r[0] << 11) | (g[0] << 5) | b[0]);
+        uint16_t c1 = static_cast<uint16_t>((r[1] << 11) | (g[1] << 5) | b[1]);
+
+        // 四色模式要求 c0 > c1：交换端点后 (c0 + 2c1) / 3 即原来的 (2c0 + c1) / 3，改用索引 3；两端点相同时索引 0 就是原色
+        uint32_t index = 2;
+        if (c0 < c1)
+        {
+            std::swap(c0, c1);
+            index = 3;
+        }
+        else if (c0 == c1)
+        {
+            index = 0;
+        }
+        uint32_t indices = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            indices |= index << (2 * i);
+        }
+
+        std::memcpy(block + 0, &c0, 2);
+        std::memcpy(block + 2, &c1, 2);
+        std::memcpy(block + 4, &indices, 4);
+        return true;
+    }
+
+    void encodeBc1Color(const BlockColors &colors, uint8_t *block)
+    {
+        if (encodeBc1SingleColor(colors, block))
+        {
+            return;
+        }
+
+        float e0[4], e1[4];
+        selectInitialEndpoints(colors, 3, e0, e1);
+        Bc1Result best = tryBc1Endpoints(colors, e0, e1);
+
+        // 索引 0/1/2/3 分别对应 e1 方向上的权重 0、1、1/3、2/3
+        const float indexWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        float weights[16];
+        for (int i = 0; i < 16; i++)
+        {
+            weights[i] = indexWeights[(best.indices >> (2 * i)) & 3];
+        }
+        if (best.error > 0.0f && fitEndpoints(colors, weights, 3, e0, e1))
+        {
+            Bc1Result refined = tryBc1Endpoints(colors, e0, e1);
+            if (refined.error < best.error)
+            {
+                best = refined;
+            }
+        }
+
+        std::memcpy(block + 0, &best.c0, 2);
+        std::memcpy(block + 2, &best.c1, 2);
+        std::memcpy(block + 4, &best.indices, 4);
+    }
+
+    void decodeBc1Color(const uint8_t *block, bool forceFourColor, uint8_t *pixels)
+    {
+        uint16_t c0, c1;
+        uint32_t indices;
+        std::memcpy(&c0, block + 0, 2);
+        std::memcpy(&c1, block + 2, 2);
+        std::memcpy(&indices, block + 4, 4);
+
+        int palette[4][4];
+        buildBc1Palette(c0, c1, forceFourColor || c0 > c1, palette);
+        for (int i = 0; i < 16; i++)
+        {
+            const int *color = palette[(indices >> (2 * i)) & 3];
+            for (int c = 0; c < 4; c++)
+            {
+                pixels[4 * i + c] = static_cast<uint8_t>(color[c]);
+            }
+        }
+    }
+
+    /* ---------------------------------------- BC3 ---------------------------------------- */
+
+    /**
+     *  BC4 alpha 块的调色板：a0 > a1 时为 a0, a1 以及 6 个插值
+     * */
+    void buildAlphaPalette(int a0, int a1, int palette[8])
+    {
+        palette[0] = a0;
+        palette[1] = a1;
+        for (int k = 1; k <= 6; k++)
+        {
+            palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+        }
+    }
+
+    void encodeBc4Alpha(const uint8_t *pixels, uint8_t *block)
+    {
+        int a0 = 0, a1 = 255;
+        for (int i = 0; i < 16; i++)
+        {
+            a0 = std::max<int>(a0, pixels[4 * i + 3]);
+            a1 = std::min<int>(a1, pixels[4 * i + 3]);
+        }
+
+        uint64_t indices = 0;
+        if (a0 != a1)
+        {
+            int palette[8];
+            buildAlphaPalette(a0, a1, palette);
+            for (int i = 0; i < 16; i++)
+            {
+                int alpha = pixels[4 * i + 3];
+                int bestIndex = 0;
+                int bestError = std::numeric_limits<int>::max();
+                for (int p = 0; p < 8; p++)
+                {
+                    int error = std::abs(alpha - palette[p]);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        bestIndex = p;
+                    }
+                }
+                indices |= static_cast<uint64_t>(bestIndex) << (3 * i);
+            }
+        }
+
+        block[0] = static_cast<uint8_t>(a0);
+        block[1] = static_cast<uint8_t>(a1);
+        for (int i = 0; i < 6; i++)
+        {
+            block[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+        }
+    }
+
+    void decodeBc4Alpha(const uint8_t *block, uint8_t *pixels)
+    {
+        int a0 = block[0], a1 = block[1];
+        int palette[8];
+        if (a0 > a1)
+        {
+            buildAlphaPalette(a0, a1, palette);
+        }
+        else
+        {
+            // 六值模式：4 个插值 + 0 + 255
+            palette[0] = a0;
+            palette[1] = a1;
+            for (int k = 1; k <= 4; k++)
+            {
+                palette[k + 1] = ((5 - k) * a0 + k * a1) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t indices = 0;
+        for (int i = 0; i < 6; i++)
+        {
+            indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+        }
+        for (int i = 0; i < 16; i++)
+        {
+            pixels[4 * i + 3] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+        }
+    }
+
+    /* ---------------------------------------- BC7 ---------------------------------------- */
+
+    struct Bc7Result
+    {
+        int endpoints[2][4]; // 带 p-bit 的 8 位端点
+        uint8_t indices[16];
+        float error;
+    };
+
+    /**
+     *  模式 6 的端点量化：7 位数值 + p-bit 作为最低位
+     * */
+    inline int quantizeBc7Endpoint(float value, int pbit)
+    {
+        int v7 = clampInt(static_cast<int>((value - pbit) / 2.0f + 0.5f), 0, 127);
+        return (v7 << 1) | pbit;
+    }
+
+    /**
+     *  以给定端点编码模式 6 块，对 4 种 p-bit 组合分别选择索引，保留误差最小的一种
+     * */
+    Bc7Result tryBc7Endpoints(const BlockColors &colors, const float e0[4], const float e1[4])
+    {
+        Bc7Result best{};
+        best.error = std::numeric_limits<float>::max();
+        for (int pbits = 0; pbits < 4; pbits++)
+        {
+            Bc7Result result{};
+            for (int c = 0; c < 4; c++)
+            {
+                result.endpoints[0][c] = quantizeBc7Endpoint(e0[c], pbits & 1);
+                result.endpoints[1][c] = quantizeBc7Endpoint(e1[c], pbits >> 1);
+            }
+
+            int palette[16][4];
+            for (int p = 0; p < 16; p++)
+            {
+                for (int c = 0; c < 4; c++)
+                {
+                    palette[p][c] = ((64 - BC7_WEIGHTS4[p]) * result.endpoints[0][c] + BC7_WEIGHTS4[p] * result.endpoints[1][c] + 32) >> 6;
+                }
+            }
+
+            for (int i = 0; i < 16 && result.error < best.error; i++)
+            {
+                int bestIndex = 0;
+                float bestError = std::numeric_limits<float>::max();
+                for (int p = 0; p < 16; p++)
+                {
+                    float error = 0.0f;
+                    for (int c = 0; c < 4; c++)
+                    {
+                        float d = colors[i][c] - palette[p][c];
+                        error += d * d;
+                    }
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        bestIndex = p;
+                    }
+                }
+                result.indices[i] = static_cast<uint8_t>(bestIndex);
+                result.error += bestError;
+            }
+            if (result.error < best.error)
+            {
+                best = result;
+            }
+        }
+        return best;
+    }
+
+    void encodeBc7Mode6(const BlockColors &colors, uint8_t *block)
+    {
+        float e0[4], e1[4];
+        selectInitialEndpoints(colors, 4, e0, e1);
+        Bc7Result best = tryBc7Endpoints(colors, e0, e1);
+
+        float weights[16];
+        for (int i = 0; i < 16; i++)
+        {
+            weights[i] = BC7_WEIGHTS4[best.indices[i]] / 64.0f;
+        }
+        if (best.error > 0.0f && fitEndpoints(colors, weights, 4, e0, e1))
+        {
+            Bc7Result refined = tryBc7Endpoints(colors, e0, e1);
+            if (refined.error < best.error)
+            {
+                best = refined;
+            }
+        }
+
+        // 第一个像素（锚点）的索引最高位隐含为 0，不满足时交换端点并翻转所有索引
+        if (best.indices[0] & 8)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                std::swap(best.endpoints[0][c], best.endpoints[1][c]);
+            }
+            for (int i = 0; i < 16; i++)
+            {
+                best.indices[i] = static_cast<uint8_t>(15 - best.indices[i]);
+            }
+        }
+
+        std::memset(block, 0, 16);
+        BitWriter writer{block};
+        writer.write(1u << 6, 7); // 模式 6：前 6 位为 0，第 7 位为 1
+        for (int c = 0; c < 4; c++)
+        {
+            writer.write(static_cast<uint32_t>(best.endpoints[0][c] >> 1), 7);
+            writer.write(static_cast<uint32_t>(best.endpoints[1][c] >> 1), 7);
+        }
+        writer.write(static_cast<uint32_t>(best.endpoints[0][0] & 1), 1);
+        writer.write(static_cast<uint32_t>(best.endpoints[1][0] & 1), 1);
+        writer.write(best.indices[0], 3);
+        for (int i = 1; i < 16; i++)
+        {
+            writer.write(best.indices[i], 4);
+        }
+    }
+
+    void decodeBc7Mode6(const uint8_t *block, uint8_t *pixels)
+    {
+        if ((block[0] & 0x7f) != 0x40)
+        {
+            // 不是模式 6（不是由本编码器生成），输出透明黑色
+            std::memset(pixels, 0, 64);
+            return;
+        }
+
+        BitReader reader{block};
+        reader.read(7);
+        int endpoints[2][4];
+        for (int c = 0; c < 4; c++)
+        {
+            endpoints[0][c] = static_cast<int>(reader.read(7)) << 1;
+            endpoints[1][c] = static_cast<int>(reader.read(7)) << 1;
+        }
+        int p0 = static_cast<int>(reader.read(1));
+        int p1 = static_cast<int>(reader.read(1));
+        for (int c = 0; c < 4; c++)
+        {
+            endpoints[0][c] |= p0;
+            endpoints[1][c] |= p1;
+        }
+        for (int i = 0; i < 16; i++)
+        {
+            int weight = BC7_WEIGHTS4[reader.read(i == 0 ? 3 : 4)];
+            for (int c = 0; c < 4; c++)
+            {
+                pixels[4 * i + c] = static_cast<uint8_t>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+            }
+        }
+    }
+
+    /**
+     *  把 [0, blockRows) 的块行切块后交给线程池处理
+     * */
+    void parallelForBlockRows(uint32_t blockRows, uint32_t blocksPerRow, const std::function<void(uint32_t)> &row)
+    {
+        size_t rowsPerTask = std::max<size_t>(1, BC_BLOCKS_PER_TASK / std::max<uint32_t>(blocksPerRow, 1));
+        size_t taskCount = (blockRows + rowsPerTask - 1) / rowsPerTask;
+        getThreadPool().parallelFor(taskCount, [&](size_t task)
+                                    {
+            uint32_t begin = static_cast<uint32_t>(task * rowsPerTask);
+            uint32_t end = static_cast<uint32_t>(std::min<size_t>(blockRows, begin + rowsPerTask));
+            for (uint32_t y = begin; y < end; y++)
+            {
+                row(y);
+            } });
+    }
+}
+
+/**
+ *  每个 4x4 块的字节数
+ * */
+uint32_t getBlockBytes(BlockFormat format)
+{
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+/**
+ *  格式名称
+ * */
+const char *getBlockFormatName(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::BC1:
+        return "BC1";
+    case BlockFormat::BC3:
+        return "BC3";
+    case BlockFormat::BC7:
+        return "BC7";
+    }
+    return "unknown";
+}
+
+/**
+ *  RGBA8 图像中是否存在非 255 的 alpha
+ * */
+bool imageHasAlpha(const uint8_t *pixels, uint32_t width, uint32_t height)
+{
+    size_t pixelCount = size_t(width) * height;
+    for (size_t i = 0; i < pixelCount; i++)
+    {
+        if (pixels[4 * i + 3] != 255)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ *  根据 alpha 的使用情况选择格式
+ * */
+BlockFormat selectBlockFormat(bool hasAlpha, bool preferBc7)
+{
+    if (!hasAlpha)
+    {
+        return BlockFormat::BC1;
+    }
+    return preferBc7 ? BlockFormat::BC7 : BlockFormat::BC3;
+}
+
+/**
+ *  编码单个块
+ * */
+void encodeBlock(BlockFormat format, const uint8_t *pixels, uint8_t *block)
+{
+    BlockColors colors;
+    loadColors(pixels, colors);
+    switch (format)
+    {
+    case BlockFormat::BC1:
+        encodeBc1Color(colors, block);
+        break;
+    case BlockFormat::BC3:
+        encodeBc4Alpha(pixels, block);
+        encodeBc1Color(colors, block + 8);
+        break;
+    case BlockFormat::BC7:
+        encodeBc7Mode6(colors, block);
+        break;
+    }
+}
+
+/**
+ *  解码单个块
+ * */
+void decodeBlock(BlockFormat format, const uint8_t *block, uint8_t *pixels)
+{
+    switch (format)
+    {
+    case BlockFormat::BC1:
+        decodeBc1Color(block, false, pixels);
+        break;
+    case BlockFormat::BC3:
+        // BC3 的颜色块总是按四色模式解码
+        decodeBc1Color(block + 8, true, pixels);
+        decodeBc4Alpha(block, pixels);
+        break;
+    case BlockFormat::BC7:
+        decodeBc7Mode6(block, pixels);
+        break;
+    }
+}
+
+/**
+ *  压缩整幅 RGBA8 图像
+ * */
+void compressImage(BlockFormat format, const uint8_t *pixels, uint32_t width, uint32_t height, uint8_t *blocks)
+{
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const uint32_t blockBytes = getBlockBytes(format);
+
+    parallelForBlockRows(blocksY, blocksX, [&](uint32_t by)
+                         {
+        uint8_t blockPixels[64];
+        for (uint32_t bx = 0; bx < blocksX; bx++)
+        {
+            // 超出图像的部分重复边缘像素
+            for (uint32_t y = 0; y < 4; y++)
+            {
+                uint32_t sy = std::min(by * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; x++)
+                {
+                    uint32_t sx = std::min(bx * 4 + x, width - 1);
+                    std::memcpy(blockPixels + 4 * (4 * y + x), pixels + 4 * (size_t(sy) * width + sx), 4);
+                }
+            }
+            encodeBlock(format, blockPixels, blocks + (size_t(by) * blocksX + bx) * blockBytes);
+        } });
+}
+
+/**
+ *  把压缩数据解码回 RGBA8 图像
+ * */
+void decompressImage(BlockFormat format, const uint8_t *blocks, uint32_t width, uint32_t height, uint8_t *pixels)
+{
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const uint32_t blockBytes = getBlockBytes(format);
+
+    parallelForBlockRows(blocksY, blocksX, [&](uint32_t by)
+                         {
+        uint8_t blockPixels[64];
+        for (uint32_t bx = 0; bx < blocksX; bx++)
+        {
+            decodeBlock(format, blocks + (size_t(by) * blocksX + bx) * blockBytes, blockPixels);
+            for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++)
+            {
+                for (uint32_t x = 0; x < 4 && bx * 4 + x < width; x++)
+                {
+                    std::memcpy(pixels + 4 * (size_t(by * 4 + y) * width + bx * 4 + x), blockPixels + 4 * (4 * y + x), 4);
+                }
+            }
+        } });
+}
+
+/**
+ *  压缩后图像占用的字节数
+ * */
+size_t getCompressedSize(BlockFormat format, uint32_t width, uint32_t height)
+{
+    return size_t((width + 3) / 4) * ((height + 3) / 4) * getBlockBytes(format);
+}
+
+/**
+ *  逐级压缩 CPU 生成的 mip 链
+ * */
+void compressMipChain(BlockFormat format, const MipChain &chain, CompressedMipChain &compressed)
+{
+    compressed.format = format;
+    compressed.levels.resize(chain.levels.size());
+    size_t totalSize = 0;
+    for (size_t level = 0; level < chain.levels.size(); level++)
+    {
+        compressed.levels[level] = chain.levels[level];
+        compressed.levels[level].offset = totalSize;
+        totalSize += getCompressedSize(format, chain.levels[level].width, chain.levels[level].height);
+    }
+    compressed.data.resize(totalSize);
+
+    for (size_t level = 0; level < chain.levels.size(); level++)
+    {
+        const MipLevel &src = chain.levels[level];
+        compressImage(format, chain.data.data() + src.offset, src.width, src.height,
+                      compressed.data.data() + compressed.levels[level].offset);
+    }
+}
+
+/**
+ *  把压缩的 mip 链解码回 RGBA8 mip 链
+ * */
+void decompressMipChain(const CompressedMipChain &compressed, MipChain &chain)
+{
+    chain.levels.resize(compressed.levels.size());
+    size_t totalSize = 0;
+    for (size_t level = 0; level < compressed.levels.size(); level++)
+    {
+        chain.levels[level] = compressed.levels[level];
+        chain.levels[level].offset = totalSize;
+        totalSize += size_t(chain.levels[level].width) * chain.levels[level].height * 4;
+    }
+    chain.data.resize(totalSize);
+
+    for (size_t level = 0; level < compressed.levels.size(); level++)
+    {
+        const MipLevel &dst = chain.levels[level];
+        decompressImage(compressed.format, compressed.data.data() + compressed.levels[level].offset, dst.width, dst.height,
+                        chain.data.data() + dst.offset);
+    }
+}
+
+/**
+ *  计算两幅 RGBA8 图像的峰值信噪比（dB）
+ * */
+double computePsnr(const uint8_t *a, const uint8_t *b, size_t pixelCount, uint32_t channels)
+{
+    double squaredError = 0.0;
+    for (size_t i = 0; i < pixelCount; i++)
+    {
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            double d = double(a[4 * i + c]) - double(b[4 * i + c]);
+            squaredError += d * d;
+        }
+    }
+    double meanSquaredError = squaredError / (double(pixelCount) * channels);
+    if (meanSquaredError <= 0.0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
@@ -0,0 +1,366 @@
+#include "image/ktx2.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    // 标识符(12) + 文件头(9 * 4) + 索引(4 * 4 + 2 * 8)
+    const size_t KTX2_HEADER_SIZE = 80;
+    // 每一级：byteOffset, byteLength, uncompressedByteLength
+    const size_t KTX2_LEVEL_INDEX_ENTRY_SIZE = 24;
+
+    // 数据格式描述符（Khronos Data Format Specification）中用到的常量
+    const uint32_t KHR_DF_VERSION = 2;
+    const uint32_t KHR_DF_MODEL_RGBSDA = 1;
+    const uint32_t KHR_DF_MODEL_BC1A = 128;
+    const uint32_t KHR_DF_MODEL_BC3 = 130;
+    const uint32_t KHR_DF_MODEL_BC7 = 135;
+    const uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+    const uint32_t KHR_DF_TRANSFER_SRGB = 2;
+    const uint32_t KHR_DF_SAMPLE_DATATYPE_LINEAR = 0x10;
+
+    const char KTX2_WRITER_KEY[] = "KTXwriter";
+    const char KTX2_WRITER_VALUE[] = "vk_demo";
+
+    inline uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    inline uint32_t readU32(const char *p)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint64_t readU64(const char *p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline void appendU32(std::vector<uint8_t> &out, uint32_t v)
+    {
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(&v);
+        out.insert(out.end(), p, p + sizeof(v));
+    }
+
+    inline void appendU64(std::vector<uint8_t> &out, uint64_t v)
+    {
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(&v);
+        out.insert(out.end(), p, p + sizeof(v));
+    }
+
+    /**
+     *  每一级数据在文件中的对齐要求：lcm(块字节数, 4)
+     * */
+    uint64_t getLevelAlignment(const FormatBlockInfo &info)
+    {
+        uint64_t a = info.blockBytes, b = 4;
+        while (b != 0)
+        {
+            uint64_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return uint64_t(info.blockBytes) * 4 / a;
+    }
+
+    size_t getLevelSize(const FormatBlockInfo &info, uint32_t width, uint32_t height)
+    {
+        return size_t((width + info.blockWidth - 1) / info.blockWidth) * ((height + info.blockHeight - 1) / info.blockHeight) * info.blockBytes;
+    }
+
+    /**
+     *  DFD 中的一个采样描述
+     * */
+    struct DfdSample
+    {
+        uint32_t bitOffset;
+        uint32_t bitLength; // 实际位数
+        uint32_t channelType;
+        uint32_t upper;
+    };
+
+    /**
+     *  构造基本数据格式描述符（以 32 位字为单位，第一个字为 dfdTotalSize）
+     * */
+    std::vector<uint32_t> buildDfd(VkFormat format, const FormatBlockInfo &info)
+    {
+        uint32_t colorModel = KHR_DF_MODEL_RGBSDA;
+        std::vector<DfdSample> samples;
+        switch (format)
+        {
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            samples = {{0, 8, 0, 255}, {8, 8, 1, 255}, {16, 8, 2, 255}, {24, 8, 15 | KHR_DF_SAMPLE_DATATYPE_LINEAR, 255}};
+            break;
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            colorModel = KHR_DF_MODEL_BC1A;
+            samples = {{0, 64, 0, 0xFFFFFFFFu}};
+            break;
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            colorModel = KHR_DF_MODEL_BC1A;
+            samples = {{0, 64, 1, 0xFFFFFFFFu}};
+            break;
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            colorModel = KHR_DF_MODEL_BC3;
+            samples = {{0, 64, 15, 0xFFFFFFFFu}, {64, 64, 0, 0xFFFFFFFFu}};
+            break;
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            colorModel = KHR_DF_MODEL_BC7;
+            samples = {{0, 128, 0, 0xFFFFFFFFu}};
+            break;
+        default:
+            throw std::runtime_error("unsupported KTX2 format!");
+        }
+
+        uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+        std::vector<uint32_t> words;
+        words.push_back(4 + blockSize);                 // dfdTotalSize
+        words.push_back(0);                             // vendorId = KHRONOS, descriptorType = BASICFORMAT
+        words.push_back(KHR_DF_VERSION | (blockSize << 16));
+        words.push_back(colorModel | (KHR_DF_PRIMARIES_BT709 << 8) | (KHR_DF_TRANSFER_SRGB << 16)); // flags = ALPHA_STRAIGHT
+        words.push_back((info.blockWidth - 1) | ((info.blockHeight - 1) << 8)); // texelBlockDimension0..3
+        words.push_back(info.blockBytes);               // bytesPlane0..3
+        words.push_back(0);                             // bytesPlane4..7
+        for (const DfdSample &sample : samples)
+        {
+            words.push_back(sample.bitOffset | ((sample.bitLength - 1) << 16) | (sample.channelType << 24));
+            words.push_back(0); // samplePosition0..3
+            words.push_back(0); // sampleLower
+            words.push_back(sample.upper);
+        }
+        return words;
+    }
+}
+
+/**
+ *  获取格式的块信息
+ * */
+bool getFormatBlockInfo(VkFormat format, FormatBlockInfo &info)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8G8B8A8_SRGB:
+        info = FormatBlockInfo{1, 1, 4};
+        return true;
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        info = FormatBlockInfo{4, 4, 8};
+        return true;
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+        info = FormatBlockInfo{4, 4, 16};
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ *  path 是否为 .ktx2 文件
+ * */
+bool isKtx2Path(const std::string &path)
+{
+    const std::string extension = ".ktx2";
+    return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/**
+ *  映射并校验 KTX2 文件
+ * */
+void loadKtx2(const std::string &path, Ktx2Texture &texture)
+{
+    MappedFile file(path);
+    const char *p = file.data();
+    if (file.size() < KTX2_HEADER_SIZE || std::memcmp(p, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+    {
+        throw std::runtime_error("not a KTX2 file: " + path);
+    }
+
+    VkFormat format = static_cast<VkFormat>(readU32(p + 12));
+    uint32_t width = readU32(p + 20);
+    uint32_t height = readU32(p + 24);
+    uint32_t depth = readU32(p + 28);
+    uint32_t layerCount = readU32(p + 32);
+    uint32_t faceCount = readU32(p + 36);
+    uint32_t levelCount = readU32(p + 40);
+    uint32_t supercompressionScheme = readU32(p + 44);
+
+    FormatBlockInfo info;
+    if (!getFormatBlockInfo(format, info))
+    {
+        throw std::runtime_error("unsupported KTX2 format " + std::to_string(format) + ": " + path);
+    }
+    if (supercompressionScheme != 0)
+    {
+        throw std::runtime_error("supercompressed KTX2 files are not supported: " + path);
+    }
+    if (width == 0 || height == 0 || depth != 0 || layerCount > 1 || faceCount != 1)
+    {
+        throw std::runtime_error("only 2D KTX2 textures without array layers or faces are supported: " + path);
+    }
+
+    uint32_t fullLevelCount = computeMipLevelCount(width, height);
+    uint32_t storedLevelCount = std::max(levelCount, 1u);
+    if (levelCount > fullLevelCount ||
+        KTX2_HEADER_SIZE + uint64_t(storedLevelCount) * KTX2_LEVEL_INDEX_ENTRY_SIZE > file.size())
+    {
+        throw std::runtime_error("invalid KTX2 level count: " + path);
+    }
+
+    // 校验级别索引：每一级的长度必须与尺寸一致，且完整地落在文件内
+    const uint64_t alignment = getLevelAlignment(info);
+    std::vector<MipLevel> levels(storedLevelCount);
+    uint64_t dataBegin = file.size(), dataEnd = 0;
+    for (uint32_t level = 0; level < storedLevelCount; level++)
+    {
+        const char *entry = p + KTX2_HEADER_SIZE + level * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+        uint64_t byteOffset = readU64(entry);
+        uint64_t byteLength = readU64(entry + 8);
+
+        uint32_t levelWidth = std::max(1u, width >> level);
+        uint32_t levelHeight = std::max(1u, height >> level);
+        if (byteLength != getLevelSize(info, levelWidth, levelHeight) || byteOffset % alignment != 0 ||
+            byteOffset > file.size() || byteLength > file.size() - byteOffset)
+        {
+            throw std::runtime_error("invalid KTX2 level index (level " + std::to_string(level) + "): " + path);
+        }
+        levels[level] = MipLevel{static_cast<size_t>(byteOffset), levelWidth, levelHeight};
+        dataBegin = std::min(dataBegin, byteOffset);
+        dataEnd = std::max(dataEnd, byteOffset + byteLength);
+    }
+
+    // 级别偏移改为相对于数据区起始位置，整个数据区可以一次拷贝到 staging buffer
+    for (MipLevel &level : levels)
+    {
+        level.offset -= static_cast<size_t>(dataBegin);
+    }
+
+    texture.file = std::move(file);
+    texture.format = format;
+    texture.width = width;
+    texture.height = height;
+    // levelCount 为 0 表示由加载方生成完整的 mip 链；块压缩格式无法用 vkCmdBlitImage 生成，只使用存储的一级
+    texture.mipLevels = levelCount != 0 ? levelCount : (info.blockWidth > 1 ? 1 : fullLevelCount);
+    texture.levels = std::move(levels);
+    texture.dataOffset = static_cast<size_t>(dataBegin);
+    texture.dataSize = static_cast<size_t>(dataEnd - dataBegin);
+}
+
+/**
+ *  写出 KTX2 文件
+ * */
+void writeKtx2(const std::string &path, VkFormat format, uint32_t width, uint32_t height,
+               const uint8_t *data, const std::vector<MipLevel> &levels)
+{
+    FormatBlockInfo info;
+    if (!getFormatBlockInfo(format, info))
+    {
+        throw std::runtime_error("unsupported KTX2 format " + std::to_string(format) + ": " + path);
+    }
+    if (levels.empty() || levels.size() > computeMipLevelCount(width, height))
+    {
+        throw std::runtime_error("invalid KTX2 level count: " + path);
+    }
+
+    const uint32_t levelCount = static_cast<uint32_t>(levels.size());
+    const uint64_t alignment = getLevelAlignment(info);
+
+    // DFD 紧跟在级别索引之后
+    std::vector<uint32_t> dfd = buildDfd(format, info);
+    uint64_t dfdOffset = KTX2_HEADER_SIZE + uint64_t(levelCount) * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+    uint64_t dfdLength = dfd.size() * sizeof(uint32_t);
+
+    // 键值数据：keyAndValueByteLength + "key\0value\0" + 填充到 4 字节
+    std::vector<uint8_t> kvd;
+    uint32_t keyAndValueLength = static_cast<uint32_t>(sizeof(KTX2_WRITER_KEY) + sizeof(KTX2_WRITER_VALUE));
+    appendU32(kvd, keyAndValueLength);
+    kvd.insert(kvd.end(), KTX2_WRITER_KEY, KTX2_WRITER_KEY + sizeof(KTX2_WRITER_KEY));
+    kvd.insert(kvd.end(), KTX2_WRITER_VALUE, KTX2_WRITER_VALUE + sizeof(KTX2_WRITER_VALUE));
+    kvd.resize(alignUp(kvd.size(), 4), 0);
+    uint64_t kvdOffset = dfdOffset + dfdLength;
+
+    // 各级别从最小级别到第 0 级依次存放
+    std::vector<uint64_t> levelOffsets(levelCount), levelSizes(levelCount);
+    uint64_t cursor = kvdOffset + kvd.size();
+    for (uint32_t level = levelCount; level-- > 0;)
+    {
+        uint32_t levelWidth = std::max(1u, width >> level);
+        uint32_t levelHeight = std::max(1u, height >> level);
+        if (levels[level].width != levelWidth || levels[level].height != levelHeight)
+        {
+            throw std::runtime_error("KTX2 level size mismatch (level " + std::to_string(level) + "): " + path);
+        }
+        cursor = alignUp(cursor, alignment);
+        levelOffsets[level] = cursor;
+        levelSizes[level] = getLevelSize(info, levelWidth, levelHeight);
+        cursor += levelSizes[level];
+    }
+
+    std::vector<uint8_t> header;
+    header.insert(header.end(), KTX2_IDENTIFIER, KTX2_IDENTIFIER + sizeof(KTX2_IDENTIFIER));
+    appendU32(header, static_cast<uint32_t>(format));
+    appendU32(header, 1); // typeSize：8 位通道与块压缩格式均为 1
+    appendU32(header, width);
+    appendU32(header, height);
+    appendU32(header, 0); // pixelDepth
+    appendU32(header, 0); // layerCount
+    appendU32(header, 1); // faceCount
+    appendU32(header, levelCount);
+    appendU32(header, 0); // supercompressionScheme
+    appendU32(header, static_cast<uint32_t>(dfdOffset));
+    appendU32(header, static_cast<uint32_t>(dfdLength));
+    appendU32(header, static_cast<uint32_t>(kvdOffset));
+    appendU32(header, static_cast<uint32_t>(kvd.size()));
+    appendU64(header, 0); // sgdByteOffset
+    appendU64(header, 0); // sgdByteLength
+    for (uint32_t level = 0; level < levelCount; level++)
+    {
+        appendU64(header, levelOffsets[level]);
+        appendU64(header, levelSizes[level]);
+        appendU64(header, levelSizes[level]); // 无超压缩时 uncompressedByteLength 与 byteLength 相同
+    }
+    for (uint32_t word : dfd)
+    {
+        appendU32(header, word);
+    }
+    header.insert(header.end(), kvd.begin(), kvd.end());
+
+    const std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("failed to create KTX2 file: " + tempPath);
+    }
+
+    const char padding[16] = {};
+    uint64_t written = header.size();
+    out.write(reinterpret_cast<const char *>(header.data()), header.size());
+    for (uint32_t level = levelCount; level-- > 0;)
+    {
+        out.write(padding, levelOffsets[level] - written);
+        out.write(reinterpret_cast<const char *>(data + levels[level].offset), levelSizes[level]);
+        written = levelOffsets[level] + levelSizes[level];
+    }
+    out.close();
+
+    if (!out)
+    {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("failed to write KTX2 file: " + tempPath);
+    }
+
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("failed to replace KTX2 file: " + path);
+    }
+}
@@ -0,0 +1,319 @@
+#include "image/mipmap.h"
+
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64)) && (defined(__SSE2__) || defined(_M_X64))
+#define MIPMAP_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+// AVX2 版本通过 target 属性单独编译，运行时检测 CPU 支持后才会调用，不需要给整个工程加 -mavx2
+#define MIPMAP_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MIPMAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // 线性值编码到 sRGB8 的查找表精度（16 位），暗部的量化步长远小于 sRGB8 一级的跨度
+    const uint32_t SRGB_ENCODE_TABLE_SIZE = 1u << 16;
+
+    // 每个并行任务至少处理的输出像素数，避免小级别的任务调度开销超过计算本身
+    const size_t MIPMAP_PIXELS_PER_TASK = 16384;
+
+    float srgbToLinear(float c)
+    {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(float c)
+    {
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    /**
+     *  sRGB 解码/编码查找表（首次使用时构建）
+     * */
+    struct SrgbTables
+    {
+        float decode[256];
+        std::vector<uint8_t> encode;
+
+        SrgbTables() : encode(SRGB_ENCODE_TABLE_SIZE)
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                decode[i] = srgbToLinear(i / 255.0f);
+            }
+            for (uint32_t i = 0; i < SRGB_ENCODE_TABLE_SIZE; i++)
+            {
+                float srgb = linearToSrgb(i / float(SRGB_ENCODE_TABLE_SIZE - 1));
+                encode[i] = static_cast<uint8_t>(std::min(255.0f, srgb * 255.0f + 0.5f));
+            }
+        }
+    };
+
+    const SrgbTables &getSrgbTables()
+    {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    /**
+     *  把一行 RGBA8 sRGB 像素解码为线性 float
+     * */
+    void decodeRow(const SrgbTables &tables, const uint8_t *src, float *dst, uint32_t width)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            dst[4 * x + 0] = tables.decode[src[4 * x + 0]];
+            dst[4 * x + 1] = tables.decode[src[4 * x + 1]];
+            dst[4 * x + 2] = tables.decode[src[4 * x + 2]];
+            dst[4 * x + 3] = src[4 * x + 3] * (1.0f / 255.0f);
+        }
+    }
+
+    /**
+     *  把一行线性 float 像素编码为 RGBA8 sRGB
+     * */
+    void encodeRow(const SrgbTables &tables, const float *src, uint8_t *dst, uint32_t width)
+    {
+        const float scale = float(SRGB_ENCODE_TABLE_SIZE - 1);
+        for (uint32_t x = 0; x < width; x++)
+        {
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                float v = std::min(std::max(src[4 * x + c], 0.0f), 1.0f);
+                dst[4 * x + c] = tables.encode[static_cast<uint32_t>(v * scale + 0.5f)];
+            }
+            float a = std::min(std::max(src[4 * x + 3], 0.0f), 1.0f);
+            dst[4 * x + 3] = static_cast<uint8_t>(a * 255.0f + 0.5f);
+        }
+    }
+
+    /**
+     *  2x2 盒式滤波的一行：dst[x] = (row0[2x] + row0[2x+1] + row1[2x] + row1[2x+1]) / 4
+     *  调用方保证源行宽度 >= 2 * dstWidth
+     * */
+    using DownsampleRowFn = void (*)(const float *row0, const float *row1, float *dst, uint32_t dstWidth);
+
+#if !defined(MIPMAP_SSE2) && !defined(MIPMAP_NEON)
+    void downsampleRowScalar(const float *row0, const float *row1, float *dst, uint32_t dstWidth)
+    {
+        for (uint32_t x = 0; x < dstWidth; x++)
+        {
+            const float *a = row0 + 8 * x;
+            const float *b = row1 + 8 * x;
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                dst[4 * x + c] = (a[c] + a[4 + c] + b[c] + b[4 + c]) * 0.25f;
+            }
+        }
+    }
+#endif
+
+#if defined(MIPMAP_SSE2)
+    /**
+     *  SSE2：一个 RGBA float 像素正好是一个 __m128
+     * */
+    void downsampleRowSse2(const float *row0, const float *row1, float *dst, uint32_t dstWidth)
+    {
+        const __m128 quarter = _mm_set1_ps(0.25f);
+        for (uint32_t x = 0; x < dstWidth; x++)
+        {
+            __m128 a = _mm_add_ps(_mm_loadu_ps(row0 + 8 * x), _mm_loadu_ps(row0 + 8 * x + 4));
+            __m128 b = _mm_add_ps(_mm_loadu_ps(row1 + 8 * x), _mm_loadu_ps(row1 + 8 * x + 4));
+            _mm_storeu_ps(dst + 4 * x, _mm_mul_ps(_mm_add_ps(a, b), quarter));
+        }
+    }
+#endif
+
+#if defined(MIPMAP_AVX2)
+    /**
+     *  AVX2：每次读入两行各 4 个源像素，输出 2 个像素
+     *  s0 = (P0, P1)，s1 = (P2, P3) 为两行相加的结果，通过跨 128 位通道的重排得到 (P0, P2) + (P1, P3)
+     * */
+    __attribute__((target("avx2"))) void downsampleRowAvx2(const float *row0, const float *row1, float *dst, uint32_t dstWidth)
+    {
+        const __m256 quarter = _mm256_set1_ps(0.25f);
+        uint32_t x = 0;
+        for (; x + 2 <= dstWidth; x += 2)
+        {
+            __m256 s0 = _mm256_add_ps(_mm256_loadu_ps(row0 + 8 * x), _mm256_loadu_ps(row1 + 8 * x));
+            __m256 s1 = _mm256_add_ps(_mm256_loadu_ps(row0 + 8 * x + 8), _mm256_loadu_ps(row1 + 8 * x + 8));
+            __m256 even = _mm256_permute2f128_ps(s0, s1, 0x20);
+            __m256 odd = _mm256_permute2f128_ps(s0, s1, 0x31);
+            _mm256_storeu_ps(dst + 4 * x, _mm256_mul_ps(_mm256_add_ps(even, odd), quarter));
+        }
+        if (x < dstWidth)
+        {
+            downsampleRowSse2(row0 + 8 * x, row1 + 8 * x, dst + 4 * x, dstWidth - x);
+        }
+    }
+#endif
+
+#if defined(MIPMAP_NEON)
+    /**
+     *  NEON：与 SSE2 版本相同，一个像素对应一个 float32x4_t
+     * */
+    void downsampleRowNeon(const float *row0, const float *row1, float *dst, uint32_t dstWidth)
+    {
+        for (uint32_t x = 0; x < dstWidth; x++)
+        {
+            float32x4_t a = vaddq_f32(vld1q_f32(row0 + 8 * x), vld1q_f32(row0 + 8 * x + 4));
+            float32x4_t b = vaddq_f32(vld1q_f32(row1 + 8 * x), vld1q_f32(row1 + 8 * x + 4));
+            vst1q_f32(dst + 4 * x, vmulq_n_f32(vaddq_f32(a, b), 0.25f));
+        }
+    }
+#endif
+
+    struct MipmapKernel
+    {
+        DownsampleRowFn downsampleRow;
+        const char *name;
+    };
+
+    MipmapKernel selectKernel()
+    {
+#if defined(MIPMAP_AVX2)
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return MipmapKernel{downsampleRowAvx2, "avx2"};
+        }
+#endif
+#if defined(MIPMAP_SSE2)
+        return MipmapKernel{downsampleRowSse2, "sse2"};
+#elif defined(MIPMAP_NEON)
+        return MipmapKernel{downsampleRowNeon, "neon"};
+#else
+        return MipmapKernel{downsampleRowScalar, "scalar"};
+#endif
+    }
+
+    const MipmapKernel &getKernel()
+    {
+        static const MipmapKernel kernel = selectKernel();
+        return kernel;
+    }
+
+    /**
+     *  把 [0, rowCount) 的行切块后交给线程池处理，每块至少包含 MIPMAP_PIXELS_PER_TASK 个像素
+     * */
+    void parallelForRows(uint32_t rowCount, uint32_t width, const std::function<void(uint32_t)> &row)
+    {
+        size_t rowsPerTask = std::max<size_t>(1, MIPMAP_PIXELS_PER_TASK / std::max<uint32_t>(width, 1));
+        size_t taskCount = (rowCount + rowsPerTask - 1) / rowsPerTask;
+        if (taskCount <= 1)
+        {
+            for (uint32_t y = 0; y < rowCount; y++)
+            {
+                row(y);
+            }
+            return;
+        }
+        getThreadPool().parallelFor(taskCount, [&](size_t task)
+                                    {
+            uint32_t begin = static_cast<uint32_t>(task * rowsPerTask);
+            uint32_t end = static_cast<uint32_t>(std::min<size_t>(rowCount, begin + rowsPerTask));
+            for (uint32_t y = begin; y < end; y++)
+            {
+                row(y);
+            } });
+    }
+}
+
+/**
+ *  计算完整 mip 链的级数
+ * */
+uint32_t computeMipLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    uint32_t size = std::max(width, height);
+    while (size > 1)
+    {
+        size >>= 1;
+        levels++;
+    }
+    return levels;
+}
+
+/**
+ *  生成完整的 mip 链
+ * */
+void buildMipChain(const uint8_t *pixels, uint32_t width, uint32_t height, MipChain &chain)
+{
+    if (width == 0 || height == 0)
+    {
+        throw std::runtime_error("cannot build mip chain for an empty image!");
+    }
+
+    const SrgbTables &tables = getSrgbTables();
+    const DownsampleRowFn downsampleRow = getKernel().downsampleRow;
+
+    // 先排布所有级别，确定总大小
+    uint32_t levelCount = computeMipLevelCount(width, height);
+    chain.levels.resize(levelCount);
+    size_t totalSize = 0;
+    for (uint32_t level = 0; level < levelCount; level++)
+    {
+        MipLevel &mip = chain.levels[level];
+        mip.offset = totalSize;
+        mip.width = std::max(1u, width >> level);
+        mip.height = std::max(1u, height >> level);
+        totalSize += size_t(mip.width) * mip.height * 4;
+    }
+    chain.data.resize(totalSize);
+
+    // 第 0 级直接拷贝，同时解码到线性空间作为下一级的输入
+    std::copy(pixels, pixels + size_t(width) * height * 4, chain.data.begin());
+    if (levelCount == 1)
+    {
+        return;
+    }
+
+    std::vector<float> current(size_t(width) * height * 4);
+    std::vector<float> next;
+    parallelForRows(height, width, [&](uint32_t y)
+                    { decodeRow(tables, pixels + size_t(y) * width * 4, current.data() + size_t(y) * width * 4, width); });
+
+    for (uint32_t level = 1; level < levelCount; level++)
+    {
+        const MipLevel &src = chain.levels[level - 1];
+        const MipLevel &dst = chain.levels[level];
+        next.resize(size_t(dst.width) * dst.height * 4);
+
+        parallelForRows(dst.height, dst.width, [&](uint32_t y)
+                        {
+            // 源图像只有一行/一列时（非正方形图像的末尾几级），与自身求平均，相当于只在另一个方向上滤波
+            const float *row0 = current.data() + size_t(std::min(2 * y, src.height - 1)) * src.width * 4;
+            const float *row1 = current.data() + size_t(std::min(2 * y + 1, src.height - 1)) * src.width * 4;
+            float *out = next.data() + size_t(y) * dst.width * 4;
+            if (src.width == 1)
+            {
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    out[c] = (row0[c] + row1[c]) * 0.5f;
+                }
+            }
+            else
+            {
+                downsampleRow(row0, row1, out, dst.width);
+            }
+            encodeRow(tables, out, chain.data.data() + dst.offset + size_t(y) * dst.width * 4, dst.width); });
+
+        current.swap(next);
+    }
+}
+
+/**
+ *  当前平台实际使用的滤波核名称
+ * */
+const char *getMipmapKernelName()
+{
+    return getKernel().name;
+}
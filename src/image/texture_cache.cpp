@@ -0,0 +1,151 @@
+#include "image/texture_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace
+{
+    const char TEXTURE_CACHE_MAGIC[4] = {'V', 'T', 'E', 'X'};
+
+    // 级别表/压缩数据按 16 字节对齐存放（与 BC 块大小一致）
+    const uint64_t TEXTURE_CACHE_ALIGNMENT = 16;
+
+    inline uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+/**
+ *  缓存文件路径
+ * */
+std::string getTextureCachePath(const std::string &sourcePath)
+{
+    return sourcePath + ".vtex";
+}
+
+/**
+ *  读取并校验缓存文件
+ * */
+bool readTextureCache(const std::string &cachePath, const MeshSourceKey &key, CompressedMipChain &chain)
+{
+    struct stat fileStat;
+    if (::stat(cachePath.c_str(), &fileStat) != 0)
+    {
+        return false;
+    }
+
+    MappedFile mapped(cachePath);
+    if (mapped.size() < sizeof(TextureCacheHeader))
+    {
+        return false;
+    }
+
+    TextureCacheHeader header;
+    std::memcpy(&header, mapped.data(), sizeof(TextureCacheHeader));
+
+    if (std::memcmp(header.magic, TEXTURE_CACHE_MAGIC, sizeof(TEXTURE_CACHE_MAGIC)) != 0 ||
+        header.version != TEXTURE_CACHE_VERSION ||
+        header.options != key.options ||
+        header.sourceSize != key.size ||
+        header.sourceMtime != key.mtime ||
+        header.sourceHash != key.hash ||
+        header.pathLength != key.path.size() ||
+        sizeof(TextureCacheHeader) + header.pathLength > mapped.size() ||
+        std::memcmp(mapped.data() + sizeof(TextureCacheHeader), key.path.data(), key.path.size()) != 0)
+    {
+        return false;
+    }
+
+    BlockFormat format = static_cast<BlockFormat>(header.format);
+    if (format != BlockFormat::BC1 && format != BlockFormat::BC3 && format != BlockFormat::BC7)
+    {
+        return false;
+    }
+
+    // 防止损坏的缓存文件导致越界访问
+    uint64_t levelBytes = uint64_t(header.levelCount) * sizeof(TextureCacheLevel);
+    if (header.levelCount == 0 || header.levelOffset % TEXTURE_CACHE_ALIGNMENT != 0 || header.dataOffset % TEXTURE_CACHE_ALIGNMENT != 0 ||
+        header.levelOffset + levelBytes > mapped.size() || header.dataOffset + header.dataSize > mapped.size())
+    {
+        return false;
+    }
+
+    std::vector<TextureCacheLevel> levels(header.levelCount);
+    std::memcpy(levels.data(), mapped.data() + header.levelOffset, levelBytes);
+    for (const TextureCacheLevel &level : levels)
+    {
+        if (level.width == 0 || level.height == 0 ||
+            level.offset + getCompressedSize(format, level.width, level.height) > header.dataSize)
+        {
+            return false;
+        }
+    }
+
+    chain.format = format;
+    chain.levels.resize(levels.size());
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        chain.levels[i] = MipLevel{static_cast<size_t>(levels[i].offset), levels[i].width, levels[i].height};
+    }
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(mapped.data() + header.dataOffset);
+    chain.data.assign(data, data + header.dataSize);
+    return true;
+}
+
+/**
+ *  将压缩完成的 mip 链写入缓存文件
+ * */
+void writeTextureCache(const std::string &cachePath, const MeshSourceKey &key, const CompressedMipChain &chain)
+{
+    std::vector<TextureCacheLevel> levels(chain.levels.size());
+    for (size_t i = 0; i < chain.levels.size(); i++)
+    {
+        levels[i] = TextureCacheLevel{chain.levels[i].offset, chain.levels[i].width, chain.levels[i].height};
+    }
+
+    TextureCacheHeader header{};
+    std::memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(TEXTURE_CACHE_MAGIC));
+    header.version = TEXTURE_CACHE_VERSION;
+    header.pathLength = static_cast<uint32_t>(key.path.size());
+    header.options = key.options;
+    header.format = static_cast<uint32_t>(chain.format);
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.sourceSize = key.size;
+    header.sourceMtime = key.mtime;
+    header.sourceHash = key.hash;
+    header.levelOffset = alignUp(sizeof(TextureCacheHeader) + key.path.size(), TEXTURE_CACHE_ALIGNMENT);
+    header.dataOffset = alignUp(header.levelOffset + levels.size() * sizeof(TextureCacheLevel), TEXTURE_CACHE_ALIGNMENT);
+    header.dataSize = chain.data.size();
+
+    const std::string tempPath = cachePath + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("failed to create texture cache: " + tempPath);
+    }
+
+    const char padding[TEXTURE_CACHE_ALIGNMENT] = {};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(TextureCacheHeader));
+    out.write(key.path.data(), key.path.size());
+    out.write(padding, header.levelOffset - sizeof(TextureCacheHeader) - key.path.size());
+    out.write(reinterpret_cast<const char *>(levels.data()), levels.size() * sizeof(TextureCacheLevel));
+    out.write(padding, header.dataOffset - header.levelOffset - levels.size() * sizeof(TextureCacheLevel));
+    out.write(reinterpret_cast<const char *>(chain.data.data()), chain.data.size());
+    out.close();
+
+    if (!out)
+    {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("failed to write texture cache: " + tempPath);
+    }
+
+    // rename 在同一文件系统内是原子的，其他进程要么看到旧缓存，要么看到完整的新缓存
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("failed to replace texture cache: " + cachePath);
+    }
+}
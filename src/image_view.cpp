@@ -28,7 +28,7 @@ void createImage(uint32_t width,
                  VkImageUsageFlags usage,
                  VkMemoryPropertyFlags properties,
                  VkImage &image,
-                 VkDeviceMemory &imageMemory)
+                 MemoryAllocation &imageMemory)
 {
 
     // 创建一个图像实例
@@ -52,22 +52,8 @@ void createImage(uint32_t width,
         throw std::runtime_error("failed to create image!");
     }
 
-    // 为图像实例分配内存空间
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(device, image, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to allocate image memory!");
-    }
-
-    // 将分配的内存空间绑定到当前创建好的图片实例上
-    vkBindImageMemory(device, image, imageMemory, 0);
+    // 从内存分配器中为图像实例分配内存空间，并绑定到当前创建好的图片实例上（optimal 图像与 buffer 按 bufferImageGranularity 分开放置）
+    allocateImageMemory(image, tiling, properties, imageMemory);
 }
 
 /**
@@ -48,6 +48,11 @@ static void SetupVulkan(const char **extensions, uint32_t extensions_count)
         g_Queue = graphicsQueue;
     }
 
+    // 与主渲染管线共用同一个管线缓存（退出时一起写回磁盘）
+    {
+        g_PipelineCache = pipelineCache;
+    }
+
     // Create Descriptor Pool
     {
         VkDescriptorPoolSize pool_sizes[] =
@@ -5,6 +5,18 @@
  * */
 void initVulkan()
 {
+    // 把 PNG 纹理转换为 KTX2（只在需要转换资源时开启），之后的加载会直接使用 KTX2 文件
+    if (enableKtx2Export)
+    {
+        exportTextureToKtx2(TEXTURE_PATH, TEXTURE_KTX2_PATH);
+    }
+
+    // 模型解析/纹理解码只涉及 CPU，最先交给后台线程，与下面的 Vulkan 对象创建并行
+    if (enableAssetStreaming)
+    {
+        startAssetStreaming();
+    }
+
     // // 在创建 instance 之前可以先查看以下支持的扩展，并打印输出（这只是一个罗列查看，去掉也无妨）
     // checkExtension();
 
@@ -18,6 +30,8 @@ void initVulkan()
 
     createLogicalDevice(); // 将物理设备映射到逻辑设备，创建逻辑设备实例
 
+    createMemoryAllocator(); // 创建设备内存分配器，之后所有 buffer/image 的内存都从这里子分配
+
     createSwapChain(); // 创建交换链
 
     createImageViews(); // 创建配置要填充在交换链中图像实例
@@ -29,36 +43,90 @@ void initVulkan()
 
     createDescriptorSetLayout(); // 创建描述符区
 
+    createBindlessTextureLayout(); // 创建 bindless 纹理数组的描述符布局（设备支持描述符索引时）
+
+    createPipelineCache(); // 创建所有管线共用的管线缓存，并载入上次保存的缓存数据
+
     createGraphicsPipeline(); // 创建渲染图形管线
 
+    createGpuCullingPipeline(); // 创建 GPU 剔除使用的 compute pipeline（设备支持间接绘制时）
+
     createCommandPool(); // 创建命令池
 
+    createStagingRing(); // 创建所有上传共用的环形暂存缓冲区
+
     createColorResources();
 
     createDepthResources(); // 创建深度缓冲区
 
     createFramebuffers(); // 创建帧缓冲区
 
-    createTextureImage(); // 创建纹理贴图
+    // 纹理与顶点/索引/实例缓冲的上传合并为一个上传批次，在 createInstanceBuffer() 之后一次提交
+    beginUploadBatch();
+
+    // 创建纹理贴图（后台加载时先使用占位纹理）
+    if (enableAssetStreaming)
+    {
+        createPlaceholderTextureImage();
+    }
+    else
+    {
+        createTextureImage();
+    }
 
     createTextureImageView(); // 为纹理图创建ImageView
 
     createTextureSampler(); // 创建纹理采样器
 
-    loadModel();
+    if (enableMipmapBenchmark)
+    {
+        benchmarkMipmapGeneration();
+    }
+    if (enableTextureCompressionBenchmark)
+    {
+        benchmarkTextureCompression();
+    }
+
+    if (enableModelLoadBenchmark)
+    {
+        benchmarkModelLoading();
+    }
+    if (enableDedupBenchmark)
+    {
+        benchmarkVertexDedup();
+    }
+    // 导入场景中的模型网格并摆放实例（后台加载时先使用占位网格）
+    if (enableAssetStreaming)
+    {
+        loadPlaceholderScene();
+    }
+    else
+    {
+        loadScene();
+    }
 
     createVertexBuffer(); // 创建顶点缓冲区
 
     createIndexBuffer(); // 创建索引缓冲区
 
+    createInstanceBuffer(); // 创建实例缓冲区
+
+    endUploadBatch(); // 提交启动时的所有上传（不等待完成）
+
     createUniformBuffers(); // 创建“统一”缓冲区
 
     createDescriptorPool(); // 创建描述符池
     createDescriptorSets(); // 创建描述符集合
+    createBindlessTextureSet(); // 创建 bindless 纹理数组的描述符集
 
     createCommandBuffer(); // 创建命令缓冲区
 
     createSyncObjects(); // 创建绘制循环中的流控制原语
+
+    if (enableDeviceMemoryStats)
+    {
+        printMemoryAllocatorStats();
+    }
 }
 
 /**
@@ -70,28 +138,42 @@ void cleanupVulkan()
 
     cleanupMultiSampleColorResource();
 
+    cleanupDepthResources();
+
     cleanupTextureRelated();
 
     cleanupGraphicPipeline();
 
+    cleanupGpuCulling();
+
+    cleanupPipelineCache(); // 把管线缓存写回磁盘
+
     cleanupRenderPass();
 
     cleanupUniformBuffer();
 
     cleanupDescriptor();
 
+    cleanupBindlessTextures();
+
+    cleanupInstanceBuffer();
+
     cleanupIndexBuffer();
 
     cleanupVertexBuffer();
 
     cleanupRenderLoopRelated();
 
+    cleanupStagingRing();
+
     cleanupCommandPool();
 
     cleanupFramebuffer();
 
     cleanupImageView();
 
+    cleanupMemoryAllocator();
+
     logicalDeviceCleanup();
 
     surfaceCleanUp();
@@ -2,6 +2,35 @@
 
 VkDevice device; // 逻辑设备，物理设备的映射，一个物理设备可以映射到多个逻辑设备
 
+const bool enableTransferQueue = true; // 设备有专用传输队列族且支持 timeline semaphore 时，上传在传输队列上异步执行
+bool timelineSemaphoreEnabled = false; // 逻辑设备是否开启了 timelineSemaphore 特性
+bool multiDrawIndirectEnabled = false; // 逻辑设备是否开启了 multiDrawIndirect 与 drawIndirectFirstInstance 特性
+bool drawIndirectCountEnabled = false; // 逻辑设备是否开启了 drawIndirectCount 特性
+bool descriptorIndexingEnabled = false; // 逻辑设备是否开启了 bindless 纹理数组需要的描述符索引特性
+
+/**
+ *  查询设备支持的 1.2 特性（设备的 API 版本低于 1.2 时全部为 VK_FALSE）
+ * */
+static VkPhysicalDeviceVulkan12Features queryVulkan12Features(VkPhysicalDevice device)
+{
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_2)
+    {
+        return vulkan12Features;
+    }
+
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &vulkan12Features;
+    vkGetPhysicalDeviceFeatures2(device, &features);
+    vulkan12Features.pNext = nullptr;
+    return vulkan12Features;
+}
+
 /**
  *  逻辑设备创建：在这里我们可以看到
  *  1、一个物理设备可以对应多个逻辑设备（当然目前还只有一个逻辑设备）
@@ -13,6 +42,15 @@ void createLogicalDevice()
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueQueueFamilies = {queueIndices.graphicsFamily.value(), queueIndices.presentFamily.value()};
 
+    // 传输队列上的上传通过 timeline semaphore 与图形队列同步，二者缺一时不创建传输队列
+    VkPhysicalDeviceVulkan12Features supportedVulkan12Features = queryVulkan12Features(physicalDevice);
+    timelineSemaphoreEnabled = supportedVulkan12Features.timelineSemaphore == VK_TRUE;
+    bool useTransferQueue = enableTransferQueue && timelineSemaphoreEnabled && queueIndices.transferFamily.has_value();
+    if (useTransferQueue)
+    {
+        uniqueQueueFamilies.insert(queueIndices.transferFamily.value());
+    }
+
     // Vulkan使用一个 0.0～1.0 的浮点数来为队列分配优先级，从而影响命令缓冲区执行的调度
     // 注意，即使你只有一个队列，这里为其分配优先级也是必须的
     float queuePriority = 1.0f;
@@ -38,6 +76,16 @@ void createLogicalDevice()
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.sampleRateShading = VK_TRUE; // enable sample shading feature for the device
 
+    // 纹理使用 BC 压缩格式时需要开启 textureCompressionBC，设备不支持时纹理会在 CPU 上解码回 RGBA8
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+
+    // GPU 剔除一次间接绘制发出多条命令，且每条命令的 firstInstance 指向不同的实例
+    multiDrawIndirectEnabled = supportedFeatures.multiDrawIndirect == VK_TRUE && supportedFeatures.drawIndirectFirstInstance == VK_TRUE;
+    deviceFeatures.multiDrawIndirect = multiDrawIndirectEnabled ? VK_TRUE : VK_FALSE;
+    deviceFeatures.drawIndirectFirstInstance = multiDrawIndirectEnabled ? VK_TRUE : VK_FALSE;
+
     // 开始创建逻辑设备
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -45,6 +93,28 @@ void createLogicalDevice()
     createInfo.queueCreateInfoCount = uniqueQueueFamilies.size();
     createInfo.pEnabledFeatures = &deviceFeatures;
 
+    // 1.2 的特性统一通过 VkPhysicalDeviceVulkan12Features 由 pNext 传入（与 pEnabledFeatures 可以同时使用）
+    drawIndirectCountEnabled = supportedVulkan12Features.drawIndirectCount == VK_TRUE;
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.timelineSemaphore = timelineSemaphoreEnabled ? VK_TRUE : VK_FALSE;
+    vulkan12Features.drawIndirectCount = drawIndirectCountEnabled ? VK_TRUE : VK_FALSE;
+
+    // bindless 纹理数组需要的描述符索引特性（1.2 中 VK_EXT_descriptor_indexing 已并入核心）
+    // 纹理下标来自 push constants（dynamically uniform），用它索引纹理数组还需要 1.0 的 shaderSampledImageArrayDynamicIndexing
+    descriptorIndexingEnabled = supportedVulkan12Features.runtimeDescriptorArray == VK_TRUE &&
+                                supportedVulkan12Features.descriptorBindingPartiallyBound == VK_TRUE &&
+                                supportedVulkan12Features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+                                supportedFeatures.shaderSampledImageArrayDynamicIndexing == VK_TRUE;
+    deviceFeatures.shaderSampledImageArrayDynamicIndexing = descriptorIndexingEnabled ? VK_TRUE : VK_FALSE;
+    vulkan12Features.runtimeDescriptorArray = descriptorIndexingEnabled ? VK_TRUE : VK_FALSE;
+    vulkan12Features.descriptorBindingPartiallyBound = descriptorIndexingEnabled ? VK_TRUE : VK_FALSE;
+    vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = descriptorIndexingEnabled ? VK_TRUE : VK_FALSE;
+    if (timelineSemaphoreEnabled || drawIndirectCountEnabled || descriptorIndexingEnabled)
+    {
+        createInfo.pNext = &vulkan12Features;
+    }
+
     // 支持一些扩展，如swap chain
     createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
     createInfo.ppEnabledExtensionNames = deviceExtensions.data();
@@ -66,6 +136,11 @@ void createLogicalDevice()
     // 实例化逻辑设备后，我们将其指令集队列“映射”到我们预先定义好的两个指令集队列上
     vkGetDeviceQueue(device, queueIndices.graphicsFamily.value(), 0, &graphicsQueue);
     vkGetDeviceQueue(device, queueIndices.presentFamily.value(), 0, &presentQueue);
+    if (useTransferQueue)
+    {
+        vkGetDeviceQueue(device, queueIndices.transferFamily.value(), 0, &transferQueue);
+    }
+    std::cout << "upload queue: " << (useTransferQueue ? "dedicated transfer queue family " + std::to_string(queueIndices.transferFamily.value()) : std::string("graphics queue")) << std::endl;
 }
 
 /**
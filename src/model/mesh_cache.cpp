@@ -0,0 +1,168 @@
+#include "model/mesh_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace
+{
+    const char MESH_CACHE_MAGIC[4] = {'V', 'M', 'S', 'H'};
+
+    // 顶点/索引/LOD 数据按 16 字节对齐存放，保证 mmap 之后可以直接按 Vertex/uint32_t/MeshLod 访问
+    const uint64_t MESH_CACHE_ALIGNMENT = 16;
+
+    inline uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+/**
+ *  读取源文件的大小/修改时间，并计算内容哈希
+ * */
+MeshSourceKey makeMeshSourceKey(const std::string &path)
+{
+    struct stat fileStat;
+    if (::stat(path.c_str(), &fileStat) != 0)
+    {
+        throw std::runtime_error("failed to stat file: " + path);
+    }
+
+    MeshSourceKey key;
+    key.path = path;
+    key.size = static_cast<uint64_t>(fileStat.st_size);
+    key.mtime = static_cast<int64_t>(fileStat.st_mtim.tv_sec) * 1000000000ll + fileStat.st_mtim.tv_nsec;
+
+    // 仅比较大小和修改时间无法发现“内容被替换但时间戳被保留”的情况（例如 git checkout / 拷贝时保留属性），
+    // 所以再对内容做一次哈希，mmap + wyhash 基本可以跑满内存带宽，代价远小于重新解析
+    MappedFile file(path);
+    key.hash = hashBytes(file.data(), file.size());
+    key.options = 0;
+    return key;
+}
+
+/**
+ *  缓存文件路径
+ * */
+std::string getMeshCachePath(const std::string &sourcePath)
+{
+    return sourcePath + ".vmesh";
+}
+
+/**
+ *  映射并校验缓存文件
+ * */
+bool MeshCache::open(const std::string &cachePath, const MeshSourceKey &key, uint32_t vertexStride)
+{
+    close();
+
+    struct stat fileStat;
+    if (::stat(cachePath.c_str(), &fileStat) != 0)
+    {
+        return false;
+    }
+
+    MappedFile mapped(cachePath);
+    if (mapped.size() < sizeof(MeshCacheHeader))
+    {
+        return false;
+    }
+
+    MeshCacheHeader fileHeader;
+    std::memcpy(&fileHeader, mapped.data(), sizeof(MeshCacheHeader));
+
+    if (std::memcmp(fileHeader.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) != 0 ||
+        fileHeader.version != MESH_CACHE_VERSION ||
+        fileHeader.vertexStride != vertexStride ||
+        fileHeader.options != key.options ||
+        fileHeader.sourceSize != key.size ||
+        fileHeader.sourceMtime != key.mtime ||
+        fileHeader.sourceHash != key.hash ||
+        fileHeader.pathLength != key.path.size() ||
+        sizeof(MeshCacheHeader) + fileHeader.pathLength > mapped.size() ||
+        std::memcmp(mapped.data() + sizeof(MeshCacheHeader), key.path.data(), key.path.size()) != 0)
+    {
+        return false;
+    }
+
+    // 防止损坏的缓存文件导致越界访问
+    uint64_t vertexBytes = fileHeader.vertexCount * vertexStride;
+    uint64_t indexBytes = fileHeader.indexCount * sizeof(uint32_t);
+    uint64_t lodBytes = fileHeader.lodCount * sizeof(MeshLod);
+    if (fileHeader.vertexOffset % MESH_CACHE_ALIGNMENT != 0 || fileHeader.indexOffset % MESH_CACHE_ALIGNMENT != 0 ||
+        fileHeader.lodOffset % MESH_CACHE_ALIGNMENT != 0 || fileHeader.lodCount == 0 ||
+        fileHeader.vertexOffset + vertexBytes > mapped.size() || fileHeader.indexOffset + indexBytes > mapped.size() ||
+        fileHeader.lodOffset + lodBytes > mapped.size())
+    {
+        return false;
+    }
+    const MeshLod *lods = reinterpret_cast<const MeshLod *>(mapped.data() + fileHeader.lodOffset);
+    for (uint64_t i = 0; i < fileHeader.lodCount; i++)
+    {
+        if (uint64_t(lods[i].indexOffset) + lods[i].indexCount > fileHeader.indexCount)
+        {
+            return false;
+        }
+    }
+
+    file = std::move(mapped);
+    header = fileHeader;
+    return true;
+}
+
+/**
+ *  将处理完成的顶点/索引数据写入缓存文件
+ * */
+void MeshCache::write(const std::string &cachePath, const MeshSourceKey &key,
+                      const void *vertexData, size_t vertexCount, uint32_t vertexStride,
+                      const uint32_t *indexData, size_t indexCount,
+                      const MeshLod *lodData, size_t lodCount)
+{
+    MeshCacheHeader fileHeader{};
+    std::memcpy(fileHeader.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+    fileHeader.version = MESH_CACHE_VERSION;
+    fileHeader.vertexStride = vertexStride;
+    fileHeader.pathLength = static_cast<uint32_t>(key.path.size());
+    fileHeader.options = key.options;
+    fileHeader.sourceSize = key.size;
+    fileHeader.sourceMtime = key.mtime;
+    fileHeader.sourceHash = key.hash;
+    fileHeader.vertexCount = vertexCount;
+    fileHeader.indexCount = indexCount;
+    fileHeader.vertexOffset = alignUp(sizeof(MeshCacheHeader) + key.path.size(), MESH_CACHE_ALIGNMENT);
+    fileHeader.indexOffset = alignUp(fileHeader.vertexOffset + vertexCount * vertexStride, MESH_CACHE_ALIGNMENT);
+    fileHeader.lodCount = lodCount;
+    fileHeader.lodOffset = alignUp(fileHeader.indexOffset + indexCount * sizeof(uint32_t), MESH_CACHE_ALIGNMENT);
+
+    const std::string tempPath = cachePath + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("failed to create mesh cache: " + tempPath);
+    }
+
+    const char padding[MESH_CACHE_ALIGNMENT] = {};
+    out.write(reinterpret_cast<const char *>(&fileHeader), sizeof(MeshCacheHeader));
+    out.write(key.path.data(), key.path.size());
+    out.write(padding, fileHeader.vertexOffset - sizeof(MeshCacheHeader) - key.path.size());
+    out.write(static_cast<const char *>(vertexData), vertexCount * vertexStride);
+    out.write(padding, fileHeader.indexOffset - fileHeader.vertexOffset - vertexCount * vertexStride);
+    out.write(reinterpret_cast<const char *>(indexData), indexCount * sizeof(uint32_t));
+    out.write(padding, fileHeader.lodOffset - fileHeader.indexOffset - indexCount * sizeof(uint32_t));
+    out.write(reinterpret_cast<const char *>(lodData), lodCount * sizeof(MeshLod));
+    out.close();
+
+    if (!out)
+    {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("failed to write mesh cache: " + tempPath);
+    }
+
+    // rename 在同一文件系统内是原子的，其他进程要么看到旧缓存，要么看到完整的新缓存
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("failed to replace mesh cache: " + cachePath);
+    }
+}
@@ -0,0 +1,197 @@
+#include "model/mesh_optimizer.h"
+
+#include <algorithm>
+
+/**
+ *  使用 FIFO 缓存模拟器统计索引序列的 ACMR/ATVR
+ * */
+VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize)
+{
+    VertexCacheStatistics statistics{};
+    if (indices.empty())
+    {
+        return statistics;
+    }
+
+    // cacheTimestamp[v] 记录顶点 v 进入缓存时的“时间”，当前时间减去它不超过 cacheSize 时仍在 FIFO 缓存中
+    std::vector<size_t> cacheTimestamp(vertexCount, 0);
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    size_t timestamp = cacheSize + 1;
+    size_t referencedCount = 0;
+
+    for (uint32_t index : indices)
+    {
+        if (index >= vertexCount)
+        {
+            throw std::runtime_error("analyzeVertexCache: index out of range!");
+        }
+        if (timestamp - cacheTimestamp[index] > cacheSize)
+        {
+            cacheTimestamp[index] = timestamp++;
+            statistics.transformedVertices++;
+        }
+        if (!referenced[index])
+        {
+            referenced[index] = 1;
+            referencedCount++;
+        }
+    }
+
+    statistics.acmr = static_cast<double>(statistics.transformedVertices) / (indices.size() / 3);
+    statistics.atvr = static_cast<double>(statistics.transformedVertices) / referencedCount;
+    return statistics;
+}
+
+/**
+ *  使用 Tipsify 算法重排三角形顺序
+ * */
+void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    /**
+     *  1、建立顶点 -> 三角形的邻接表（CSR 格式）
+     * */
+    std::vector<uint32_t> liveTriangles(vertexCount, 0); // 每个顶点尚未输出的三角形数量
+    for (uint32_t index : indices)
+    {
+        if (index >= vertexCount)
+        {
+            throw std::runtime_error("optimizeVertexCache: index out of range!");
+        }
+        liveTriangles[index]++;
+    }
+
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+        }
+    }
+
+    /**
+     *  2、Tipsify 主循环：以“扇心”顶点为中心输出其所有未输出的三角形，再从刚输出的顶点中选择下一个扇心
+     * */
+    std::vector<size_t> cacheTimestamp(vertexCount, 0);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> deadEnd; // 最近输出过的顶点，候选集合为空时从这里回溯
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    size_t timestamp = cacheSize + 1;
+    size_t cursor = 0;  // 候选与回溯都失败时，按下标顺序扫描仍有剩余三角形的顶点
+    int64_t fanning = 0;
+
+    while (fanning >= 0)
+    {
+        candidates.clear();
+
+        uint32_t v = static_cast<uint32_t>(fanning);
+        for (uint32_t a = adjacencyOffset[v]; a < adjacencyOffset[v + 1]; a++)
+        {
+            uint32_t t = adjacency[a];
+            if (emitted[t])
+            {
+                continue;
+            }
+            for (int k = 0; k < 3; k++)
+            {
+                uint32_t corner = indices[t * 3 + k];
+                output.push_back(corner);
+                deadEnd.push_back(corner);
+                candidates.push_back(corner);
+                liveTriangles[corner]--;
+                if (timestamp - cacheTimestamp[corner] > cacheSize)
+                {
+                    cacheTimestamp[corner] = timestamp++;
+                }
+            }
+            emitted[t] = 1;
+        }
+
+        /**
+         *  选择下一个扇心：优先选择在下一个扇形输出完之后仍然留在缓存中、且在缓存中停留最久的候选顶点
+         * */
+        fanning = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t candidate : candidates)
+        {
+            if (liveTriangles[candidate] == 0)
+            {
+                continue;
+            }
+            int64_t priority = 0;
+            if (timestamp - cacheTimestamp[candidate] + 2 * liveTriangles[candidate] <= cacheSize)
+            {
+                priority = static_cast<int64_t>(timestamp - cacheTimestamp[candidate]);
+            }
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fanning = candidate;
+            }
+        }
+
+        if (fanning == -1)
+        {
+            // 死路：先回溯最近输出过的顶点，再按下标顺序扫描
+            while (!deadEnd.empty())
+            {
+                uint32_t d = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveTriangles[d] > 0)
+                {
+                    fanning = d;
+                    break;
+                }
+            }
+            while (fanning == -1 && cursor < vertexCount)
+            {
+                if (liveTriangles[cursor] > 0)
+                {
+                    fanning = static_cast<int64_t>(cursor);
+                }
+                cursor++;
+            }
+        }
+    }
+
+    indices.swap(output);
+}
+
+/**
+ *  计算按索引中首次引用顺序重排顶点的映射表，并改写 indices
+ * */
+size_t optimizeVertexFetchRemap(std::vector<uint32_t> &indices, size_t vertexCount, std::vector<uint32_t> &remap)
+{
+    remap.assign(vertexCount, 0xFFFFFFFFu);
+    uint32_t next = 0;
+    for (uint32_t &index : indices)
+    {
+        if (index >= vertexCount)
+        {
+            throw std::runtime_error("optimizeVertexFetch: index out of range!");
+        }
+        if (remap[index] == 0xFFFFFFFFu)
+        {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    return next;
+}
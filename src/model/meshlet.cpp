@@ -0,0 +1,216 @@
+#include "model/meshlet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    inline glm::vec3 loadPosition(const float *positions, size_t positionStride, uint32_t index)
+    {
+        const float *p = reinterpret_cast<const float *>(reinterpret_cast<const char *>(positions) + positionStride * index);
+        return glm::vec3(p[0], p[1], p[2]);
+    }
+
+    /**
+     *  根据簇中的顶点/三角形计算包围球与法线锥
+     * */
+    void computeMeshletBounds(const float *positions, size_t positionStride, const uint32_t *indices,
+                              const std::vector<uint32_t> &meshletVertices, Meshlet &meshlet)
+    {
+        // 包围球：以 AABB 中心为球心，半径取到最远顶点的距离
+        glm::vec3 minimum(std::numeric_limits<float>::max()), maximum(-std::numeric_limits<float>::max());
+        for (uint32_t v : meshletVertices)
+        {
+            glm::vec3 p = loadPosition(positions, positionStride, v);
+            minimum = glm::min(minimum, p);
+            maximum = glm::max(maximum, p);
+        }
+        meshlet.center = (minimum + maximum) * 0.5f;
+        float radiusSquared = 0.0f;
+        for (uint32_t v : meshletVertices)
+        {
+            glm::vec3 d = loadPosition(positions, positionStride, v) - meshlet.center;
+            radiusSquared = std::max(radiusSquared, glm::dot(d, d));
+        }
+        meshlet.radius = std::sqrt(radiusSquared);
+
+        // 法线锥：锥轴取各三角形单位法线的平均方向，截止值由与锥轴夹角最大的法线决定
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.indexCount / 3);
+        glm::vec3 axis(0.0f);
+        for (uint32_t i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.indexCount; i += 3)
+        {
+            glm::vec3 a = loadPosition(positions, positionStride, indices[i + 0]);
+            glm::vec3 b = loadPosition(positions, positionStride, indices[i + 1]);
+            glm::vec3 c = loadPosition(positions, positionStride, indices[i + 2]);
+            glm::vec3 n = glm::cross(b - a, c - a);
+            float length = std::sqrt(glm::dot(n, n));
+            if (length <= 0.0f)
+            {
+                continue; // 退化三角形不影响可见性
+            }
+            n = n / length;
+            normals.push_back(n);
+            axis = axis + n;
+        }
+
+        meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        meshlet.coneCutoff = 1.0f;
+        float axisLength = std::sqrt(glm::dot(axis, axis));
+        if (normals.empty() || axisLength <= 1e-6f)
+        {
+            return;
+        }
+        axis = axis / axisLength;
+
+        float minimumDot = 1.0f;
+        for (const glm::vec3 &n : normals)
+        {
+            minimumDot = std::min(minimumDot, glm::dot(axis, n));
+        }
+        meshlet.coneAxis = axis;
+        // 锥半角超过 90 度时无法保证整个簇同时背对相机
+        meshlet.coneCutoff = minimumDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minimumDot * minimumDot);
+    }
+}
+
+/**
+ *  将索引缓冲划分为簇
+ * */
+void buildMeshlets(const float *positions, size_t positionStride, size_t vertexCount,
+                   const uint32_t *indices, size_t indexCount, std::vector<Meshlet> &meshlets)
+{
+    meshlets.clear();
+    if (indexCount % 3 != 0)
+    {
+        throw std::runtime_error("buildMeshlets: index count must be a multiple of 3!");
+    }
+
+    // vertexStamp[v] 记录顶点 v 最近一次被加入的簇编号，用来 O(1) 判断顶点是否已经在当前簇中
+    std::vector<uint32_t> vertexStamp(vertexCount, 0xFFFFFFFFu);
+    std::vector<uint32_t> meshletVertices;
+    meshletVertices.reserve(MESHLET_MAX_VERTICES);
+
+    Meshlet current{};
+    auto finish = [&]()
+    {
+        if (current.indexCount == 0)
+        {
+            return;
+        }
+        current.vertexCount = static_cast<uint32_t>(meshletVertices.size());
+        computeMeshletBounds(positions, positionStride, indices, meshletVertices, current);
+        meshlets.push_back(current);
+
+        current = Meshlet{};
+        current.indexOffset = static_cast<uint32_t>(meshlets.back().indexOffset + meshlets.back().indexCount);
+        meshletVertices.clear();
+    };
+
+    for (size_t i = 0; i < indexCount; i += 3)
+    {
+        const uint32_t stamp = static_cast<uint32_t>(meshlets.size());
+        uint32_t newVertices = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            uint32_t v = indices[i + k];
+            if (v >= vertexCount)
+            {
+                throw std::runtime_error("buildMeshlets: index out of range!");
+            }
+            // 同一个三角形中重复出现的顶点只计一次
+            bool repeated = (k > 0 && indices[i + k - 1] == v) || (k > 1 && indices[i] == v);
+            if (vertexStamp[v] != stamp && !repeated)
+            {
+                newVertices++;
+            }
+        }
+
+        if (meshletVertices.size() + newVertices > MESHLET_MAX_VERTICES || current.indexCount / 3 + 1 > MESHLET_MAX_TRIANGLES)
+        {
+            finish();
+        }
+
+        const uint32_t currentStamp = static_cast<uint32_t>(meshlets.size());
+        for (int k = 0; k < 3; k++)
+        {
+            uint32_t v = indices[i + k];
+            if (vertexStamp[v] != currentStamp)
+            {
+                vertexStamp[v] = currentStamp;
+                meshletVertices.push_back(v);
+            }
+        }
+        current.indexCount += 3;
+    }
+    finish();
+}
+
+/**
+ *  视锥 + 法线锥剔除
+ * */
+void cullMeshlets(const Meshlet *meshlets, size_t meshletCount, const glm::mat4 &modelViewProj, const glm::vec3 &cameraPosition,
+                  std::vector<MeshletDrawRange> &draws, MeshletCullStatistics &statistics)
+{
+    draws.clear();
+    statistics = MeshletCullStatistics{};
+    statistics.totalMeshlets = static_cast<uint32_t>(meshletCount);
+
+    /**
+     *  从 MVP 矩阵中提取模型空间下的六个视锥平面（Gribb-Hartmann 方法），glm 为列主序，row(i) = (m[0][i], m[1][i], m[2][i], m[3][i])
+     *  Vulkan 的裁剪空间深度范围为 [0, w]，所以近平面为 row2 而不是 row3 + row2
+     * */
+    auto row = [&modelViewProj](int i)
+    { return glm::vec4(modelViewProj[0][i], modelViewProj[1][i], modelViewProj[2][i], modelViewProj[3][i]); };
+    glm::vec4 planes[6] = {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2)};
+    for (glm::vec4 &plane : planes)
+    {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        plane = plane * (1.0f / length);
+    }
+
+    for (size_t m = 0; m < meshletCount; m++)
+    {
+        const Meshlet &meshlet = meshlets[m];
+        bool outside = false;
+        for (const glm::vec4 &plane : planes)
+        {
+            if (plane.x * meshlet.center.x + plane.y * meshlet.center.y + plane.z * meshlet.center.z + plane.w < -meshlet.radius)
+            {
+                outside = true;
+                break;
+            }
+        }
+        if (outside)
+        {
+            statistics.frustumCulled++;
+            continue;
+        }
+
+        // 相机位于法线锥的“背面”时，簇中所有三角形都背对相机（对包围球做了保守处理）
+        if (meshlet.coneCutoff < 1.0f)
+        {
+            glm::vec3 direction = meshlet.center - cameraPosition;
+            float distance = std::sqrt(glm::dot(direction, direction));
+            if (glm::dot(direction, meshlet.coneAxis) >= meshlet.coneCutoff * distance + meshlet.radius)
+            {
+                statistics.backfaceCulled++;
+                continue;
+            }
+        }
+
+        statistics.visibleMeshlets++;
+        statistics.visibleIndices += meshlet.indexCount;
+        // 与上一段区间相邻时直接合并，减少绘制次数
+        if (!draws.empty() && draws.back().indexOffset + draws.back().indexCount == meshlet.indexOffset)
+        {
+            draws.back().indexCount += meshlet.indexCount;
+        }
+        else
+        {
+            draws.push_back({meshlet.indexOffset, meshlet.indexCount});
+        }
+    }
+    statistics.drawCount = static_cast<uint32_t>(draws.size());
+}
@@ -0,0 +1,357 @@
+#include "model/obj_parser.h"
+
+#include <charconv>
+#include <climits>
+#include <cstring>
+
+namespace
+{
+    // 每块至少这么大，避免小文件被切得过碎，调度开销反而超过解析本身
+    const size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+    // 角点某个分量缺省（如 "1//3" 中的 vt）
+    const int MISSING_INDEX = INT_MIN;
+
+    // 以下标记表示对应分量是负数索引换算得到的“块内相对位置”，需要在合并阶段加上全局偏移
+    const uint8_t RELATIVE_VERTEX = 1 << 0;
+    const uint8_t RELATIVE_TEXCOORD = 1 << 1;
+    const uint8_t RELATIVE_NORMAL = 1 << 2;
+
+    /**
+     *  单个块的解析结果
+     * */
+    struct ObjChunk
+    {
+        std::vector<float> vertices;
+        std::vector<float> texcoords;
+        std::vector<float> normals;
+        std::vector<ObjIndex> indices;
+        std::vector<uint8_t> relativeFlags; // 与 indices 一一对应
+    };
+
+    inline bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline const char *skipBlank(const char *p, const char *end)
+    {
+        while (p < end && isBlank(*p))
+        {
+            p++;
+        }
+        return p;
+    }
+
+    inline const char *nextLine(const char *p, const char *end)
+    {
+        const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        return newline ? newline + 1 : end;
+    }
+
+    /**
+     *  解析一个浮点数，std::from_chars 不依赖 locale 且保证正确舍入
+     *  与 tinyobj 一样对格式错误的数值（如 "1.#QNAN"、超出 float 范围的数）保持宽容：记为 0 并跳过整个记号
+     * */
+    inline const char *parseFloat(const char *p, const char *end, float &value)
+    {
+        p = skipBlank(p, end);
+        if (p < end && *p == '+')
+        {
+            p++;
+        }
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc())
+        {
+            value = 0.0f;
+        }
+        const char *q = result.ec == std::errc::invalid_argument ? p : result.ptr;
+        if (q < end && !isBlank(*q) && *q != '\n')
+        {
+            value = 0.0f;
+            while (q < end && !isBlank(*q) && *q != '\n')
+            {
+                q++;
+            }
+        }
+        return q;
+    }
+
+    /**
+     *  尝试解析一个可选的浮点数（例如 vt 的第二个分量），行内没有更多数值时返回 false
+     * */
+    inline bool parseOptionalFloat(const char *&p, const char *end, float &value)
+    {
+        const char *q = skipBlank(p, end);
+        if (q >= end || *q == '\n' || *q == '#')
+        {
+            return false;
+        }
+        p = parseFloat(q, end, value);
+        return true;
+    }
+
+    inline const char *parseInt(const char *p, const char *end, int &value)
+    {
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negative = *p == '-';
+            p++;
+        }
+        if (p >= end || *p < '0' || *p > '9')
+        {
+            throw std::runtime_error("failed to parse OBJ face index!");
+        }
+        int result = 0;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            result = result * 10 + (*p - '0');
+            p++;
+        }
+        value = negative ? -result : result;
+        return p;
+    }
+
+    /**
+     *  将 OBJ 中的 1 基索引/负数索引换算到块内表示
+     *  正数索引是全局的，直接减一；负数索引相对于“当前已出现的数量”，记录为块内相对位置并打上标记
+     * */
+    inline int resolveLocal(int raw, size_t localCount, uint8_t flag, uint8_t &flags)
+    {
+        if (raw > 0)
+        {
+            return raw - 1;
+        }
+        if (raw < 0)
+        {
+            flags |= flag;
+            return static_cast<int>(localCount) + raw;
+        }
+        throw std::runtime_error("OBJ face index 0 is invalid!");
+    }
+
+    /**
+     *  解析 f 行中的一个角点：v、v/vt、v//vn、v/vt/vn
+     * */
+    inline const char *parseCorner(const char *p, const char *end, const ObjChunk &chunk, ObjIndex &index, uint8_t &flags)
+    {
+        int raw;
+        p = parseInt(p, end, raw);
+        index.vertex_index = resolveLocal(raw, chunk.vertices.size() / 3, RELATIVE_VERTEX, flags);
+        index.texcoord_index = MISSING_INDEX;
+        index.normal_index = MISSING_INDEX;
+
+        if (p < end && *p == '/')
+        {
+            p++;
+            if (p < end && *p != '/')
+            {
+                p = parseInt(p, end, raw);
+                index.texcoord_index = resolveLocal(raw, chunk.texcoords.size() / 2, RELATIVE_TEXCOORD, flags);
+            }
+            if (p < end && *p == '/')
+            {
+                p++;
+                p = parseInt(p, end, raw);
+                index.normal_index = resolveLocal(raw, chunk.normals.size() / 3, RELATIVE_NORMAL, flags);
+            }
+        }
+        return p;
+    }
+
+    /**
+     *  解析 [begin, end) 范围内的所有完整行
+     * */
+    void parseChunk(const char *begin, const char *end, ObjChunk &chunk)
+    {
+        // 粗略估计容量，减少 vector 扩容次数（OBJ 中一行通常 20~40 字节）
+        size_t estimatedLines = static_cast<size_t>(end - begin) / 24;
+        chunk.vertices.reserve(estimatedLines * 3 / 2);
+        chunk.indices.reserve(estimatedLines * 3 / 2);
+
+        std::vector<ObjIndex> polygon;
+        std::vector<uint8_t> polygonFlags;
+
+        const char *p = begin;
+        while (p < end)
+        {
+            const char *line = skipBlank(p, end);
+            const char *lineEnd = nextLine(line, end);
+            p = lineEnd;
+
+            if (line + 1 >= lineEnd)
+            {
+                continue;
+            }
+
+            if (line[0] == 'v' && isBlank(line[1]))
+            {
+                float x, y, z;
+                const char *q = parseFloat(line + 2, lineEnd, x);
+                q = parseFloat(q, lineEnd, y);
+                parseFloat(q, lineEnd, z);
+                chunk.vertices.push_back(x);
+                chunk.vertices.push_back(y);
+                chunk.vertices.push_back(z);
+            }
+            else if (line[0] == 'v' && line[1] == 't' && line + 2 < lineEnd && isBlank(line[2]))
+            {
+                float u, v = 0.0f;
+                const char *q = parseFloat(line + 3, lineEnd, u);
+                parseOptionalFloat(q, lineEnd, v);
+                chunk.texcoords.push_back(u);
+                chunk.texcoords.push_back(v);
+            }
+            else if (line[0] == 'v' && line[1] == 'n' && line + 2 < lineEnd && isBlank(line[2]))
+            {
+                float x, y, z;
+                const char *q = parseFloat(line + 3, lineEnd, x);
+                q = parseFloat(q, lineEnd, y);
+                parseFloat(q, lineEnd, z);
+                chunk.normals.push_back(x);
+                chunk.normals.push_back(y);
+                chunk.normals.push_back(z);
+            }
+            else if (line[0] == 'f' && isBlank(line[1]))
+            {
+                polygon.clear();
+                polygonFlags.clear();
+
+                const char *q = line + 2;
+                while (true)
+                {
+                    q = skipBlank(q, lineEnd);
+                    if (q >= lineEnd || *q == '\n' || *q == '#')
+                    {
+                        break;
+                    }
+                    ObjIndex index;
+                    uint8_t flags = 0;
+                    q = parseCorner(q, lineEnd, chunk, index, flags);
+                    polygon.push_back(index);
+                    polygonFlags.push_back(flags);
+                }
+
+                // 多边形按扇形三角化，与 tinyobj 默认的 triangulate 行为一致
+                for (size_t k = 2; k < polygon.size(); k++)
+                {
+                    chunk.indices.push_back(polygon[0]);
+                    chunk.indices.push_back(polygon[k - 1]);
+                    chunk.indices.push_back(polygon[k]);
+                    chunk.relativeFlags.push_back(polygonFlags[0]);
+                    chunk.relativeFlags.push_back(polygonFlags[k - 1]);
+                    chunk.relativeFlags.push_back(polygonFlags[k]);
+                }
+            }
+            // 其余字段（注释/o/g/s/usemtl/mtllib等）直接跳过
+        }
+    }
+
+    /**
+     *  将块内索引换算为全局索引，并做越界检查
+     * */
+    inline int resolveGlobal(int local, bool relative, size_t offset, size_t total)
+    {
+        if (local == MISSING_INDEX)
+        {
+            return -1;
+        }
+        int64_t global = relative ? static_cast<int64_t>(offset) + local : local;
+        if (global < 0 || global >= static_cast<int64_t>(total))
+        {
+            throw std::runtime_error("OBJ face index out of range!");
+        }
+        return static_cast<int>(global);
+    }
+}
+
+/**
+ *  并行解析一段内存中的 OBJ 文本
+ * */
+void parseObjBuffer(const char *data, size_t size, ObjMesh &mesh, size_t chunkCount)
+{
+    ThreadPool &pool = getThreadPool();
+
+    if (chunkCount == 0)
+    {
+        chunkCount = std::max<size_t>(1, std::min(pool.concurrency() * 4, size / MIN_CHUNK_BYTES));
+    }
+
+    /**
+     *  1、在行边界上切块：先按字节均分，再把每个切分点向后移动到下一行的开头
+     * */
+    std::vector<const char *> bounds(chunkCount + 1);
+    const char *end = data + size;
+    bounds[0] = data;
+    bounds[chunkCount] = end;
+    for (size_t i = 1; i < chunkCount; i++)
+    {
+        const char *split = data + size / chunkCount * i;
+        split = std::max(split, bounds[i - 1]);
+        bounds[i] = split < end ? nextLine(split, end) : end;
+    }
+
+    /**
+     *  2、每块独立解析
+     * */
+    std::vector<ObjChunk> chunks(chunkCount);
+    pool.parallelFor(chunkCount, [&](size_t i)
+                     { parseChunk(bounds[i], bounds[i + 1], chunks[i]); });
+
+    /**
+     *  3、前缀和得到每块在最终数组中的偏移
+     * */
+    std::vector<size_t> vertexOffset(chunkCount + 1, 0);
+    std::vector<size_t> texcoordOffset(chunkCount + 1, 0);
+    std::vector<size_t> normalOffset(chunkCount + 1, 0);
+    std::vector<size_t> indexOffset(chunkCount + 1, 0);
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        vertexOffset[i + 1] = vertexOffset[i] + chunks[i].vertices.size() / 3;
+        texcoordOffset[i + 1] = texcoordOffset[i] + chunks[i].texcoords.size() / 2;
+        normalOffset[i + 1] = normalOffset[i] + chunks[i].normals.size() / 3;
+        indexOffset[i + 1] = indexOffset[i] + chunks[i].indices.size();
+    }
+
+    const size_t vertexCount = vertexOffset[chunkCount];
+    const size_t texcoordCount = texcoordOffset[chunkCount];
+    const size_t normalCount = normalOffset[chunkCount];
+
+    mesh.vertices.resize(vertexCount * 3);
+    mesh.texcoords.resize(texcoordCount * 2);
+    mesh.normals.resize(normalCount * 3);
+    mesh.indices.resize(indexOffset[chunkCount]);
+
+    /**
+     *  4、并行合并：拷贝属性数组并修正索引
+     * */
+    pool.parallelFor(chunkCount, [&](size_t i)
+                     {
+        ObjChunk &chunk = chunks[i];
+        std::copy(chunk.vertices.begin(), chunk.vertices.end(), mesh.vertices.begin() + vertexOffset[i] * 3);
+        std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), mesh.texcoords.begin() + texcoordOffset[i] * 2);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), mesh.normals.begin() + normalOffset[i] * 3);
+
+        ObjIndex *out = mesh.indices.data() + indexOffset[i];
+        for (size_t k = 0; k < chunk.indices.size(); k++)
+        {
+            const ObjIndex &local = chunk.indices[k];
+            uint8_t flags = chunk.relativeFlags[k];
+            out[k].vertex_index = resolveGlobal(local.vertex_index, flags & RELATIVE_VERTEX, vertexOffset[i], vertexCount);
+            out[k].texcoord_index = resolveGlobal(local.texcoord_index, flags & RELATIVE_TEXCOORD, texcoordOffset[i], texcoordCount);
+            out[k].normal_index = resolveGlobal(local.normal_index, flags & RELATIVE_NORMAL, normalOffset[i], normalCount);
+        }
+
+        // 块内的临时数据尽早释放
+        chunk = ObjChunk(); });
+}
+
+/**
+ *  使用 mmap + 线程池并行解析 OBJ 文件
+ * */
+void parseObjFile(const std::string &path, ObjMesh &mesh, size_t chunkCount)
+{
+    MappedFile file(path);
+    parseObjBuffer(file.data(), file.size(), mesh, chunkCount);
+}
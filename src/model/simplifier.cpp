@@ -0,0 +1,539 @@
+#include "model/simplifier.h"
+
+#include "model/vertex_dedup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    struct Position
+    {
+        float x, y, z;
+    };
+
+    inline Position loadPosition(const float *positions, size_t positionStride, uint32_t index)
+    {
+        const float *p = reinterpret_cast<const float *>(reinterpret_cast<const char *>(positions) + positionStride * index);
+        return Position{p[0], p[1], p[2]};
+    }
+
+    inline Position sub(const Position &a, const Position &b) { return Position{a.x - b.x, a.y - b.y, a.z - b.z}; }
+    inline Position cross(const Position &a, const Position &b) { return Position{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+    inline double dot(const Position &a, const Position &b) { return double(a.x) * b.x + double(a.y) * b.y + double(a.z) * b.z; }
+
+    /**
+     *  对称 4x4 二次误差矩阵（只保存上三角的 10 个元素），weight 为累积的面积权重
+     * */
+    struct Quadric
+    {
+        double a2, b2, c2, ab, ac, bc, ad, bd, cd, d2;
+        double weight;
+
+        void add(const Quadric &q)
+        {
+            a2 += q.a2, b2 += q.b2, c2 += q.c2, ab += q.ab, ac += q.ac, bc += q.bc;
+            ad += q.ad, bd += q.bd, cd += q.cd, d2 += q.d2, weight += q.weight;
+        }
+
+        /**
+         *  v^T Q v，即点到各平面距离平方的加权和
+         * */
+        double evaluate(const Position &p) const
+        {
+            double x = p.x, y = p.y, z = p.z;
+            double result = a2 * x * x + b2 * y * y + c2 * z * z + d2 +
+                            2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z);
+            return std::max(result, 0.0);
+        }
+    };
+
+    /**
+     *  三角形所在平面的二次误差矩阵，按面积加权
+     * */
+    Quadric planeQuadric(const Position &p0, const Position &p1, const Position &p2)
+    {
+        Position n = cross(sub(p1, p0), sub(p2, p0));
+        double length = std::sqrt(dot(n, n));
+        Quadric q{};
+        if (length <= 0.0)
+        {
+            return q;
+        }
+        double a = n.x / length, b = n.y / length, c = n.z / length;
+        double d = -(a * p0.x + b * p0.y + c * p0.z);
+        double w = length * 0.5; // 三角形面积
+        q.a2 = w * a * a, q.b2 = w * b * b, q.c2 = w * c * c;
+        q.ab = w * a * b, q.ac = w * a * c, q.bc = w * b * c;
+        q.ad = w * a * d, q.bd = w * b * d, q.cd = w * c * d, q.d2 = w * d * d;
+        q.weight = w;
+        return q;
+    }
+
+    struct Collapse
+    {
+        double cost; // 误差的平方
+        uint32_t from;
+        uint32_t to;
+    };
+
+    /**
+     *  点到三角形的最近距离平方（Ericson, Real-Time Collision Detection 5.1.5）
+     * */
+    double pointTriangleDistanceSquared(const Position &p, const Position &a, const Position &b, const Position &c)
+    {
+        Position ab = sub(b, a), ac = sub(c, a), ap = sub(p, a);
+        double d1 = dot(ab, ap), d2 = dot(ac, ap);
+        auto distance2 = [&p](double x, double y, double z)
+        { double dx = p.x - x, dy = p.y - y, dz = p.z - z; return dx * dx + dy * dy + dz * dz; };
+        if (d1 <= 0 && d2 <= 0)
+            return distance2(a.x, a.y, a.z);
+        Position bp = sub(p, b);
+        double d3 = dot(ab, bp), d4 = dot(ac, bp);
+        if (d3 >= 0 && d4 <= d3)
+            return distance2(b.x, b.y, b.z);
+        double vc = d1 * d4 - d3 * d2;
+        if (vc <= 0 && d1 >= 0 && d3 <= 0)
+        {
+            double v = d1 / (d1 - d3);
+            return distance2(a.x + v * ab.x, a.y + v * ab.y, a.z + v * ab.z);
+        }
+        Position cp = sub(p, c);
+        double d5 = dot(ab, cp), d6 = dot(ac, cp);
+        if (d6 >= 0 && d5 <= d6)
+            return distance2(c.x, c.y, c.z);
+        double vb = d5 * d2 - d1 * d6;
+        if (vb <= 0 && d2 >= 0 && d6 <= 0)
+        {
+            double w = d2 / (d2 - d6);
+            return distance2(a.x + w * ac.x, a.y + w * ac.y, a.z + w * ac.z);
+        }
+        double va = d3 * d6 - d5 * d4;
+        if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+        {
+            double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            return distance2(b.x + w * (c.x - b.x), b.y + w * (c.y - b.y), b.z + w * (c.z - b.z));
+        }
+        double denom = 1.0 / (va + vb + vc);
+        double v = vb * denom, w = vc * denom;
+        return distance2(a.x + ab.x * v + ac.x * w, a.y + ab.y * v + ac.y * w, a.z + ab.z * v + ac.z * w);
+    }
+}
+
+/**
+ *  使用 QEM 简化网格
+ * */
+float simplifyMesh(const float *positions, size_t positionStride, size_t vertexCount,
+                   const uint32_t *indices, size_t indexCount,
+                   size_t targetIndexCount, float targetError, std::vector<uint32_t> &result,
+                   std::vector<uint32_t> *remap)
+{
+    if (indexCount % 3 != 0)
+    {
+        throw std::runtime_error("simplifyMesh: index count must be a multiple of 3!");
+    }
+    result.assign(indices, indices + indexCount);
+    for (uint32_t index : result)
+    {
+        if (index >= vertexCount)
+        {
+            throw std::runtime_error("simplifyMesh: index out of range!");
+        }
+    }
+
+    /**
+     *  1、位置焊接：位置相同的顶点（例如 UV 接缝两侧）拓扑上视为同一个顶点，canonical[v] 为其代表编号
+     * */
+    std::vector<uint32_t> canonical(vertexCount);
+    std::vector<uint32_t> wedgeCount; // 每个代表顶点对应的原始顶点数量
+    {
+        std::vector<Position> unique;
+        VertexDedupTable<Position> table(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            canonical[v] = table.findOrInsert(loadPosition(positions, positionStride, static_cast<uint32_t>(v)), unique);
+        }
+        wedgeCount.assign(unique.size(), 0);
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            wedgeCount[canonical[v]]++;
+        }
+    }
+    const size_t canonicalCount = wedgeCount.size();
+    std::vector<Position> canonicalPosition(canonicalCount);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        canonicalPosition[canonical[v]] = loadPosition(positions, positionStride, static_cast<uint32_t>(v));
+    }
+
+    /**
+     *  2、锁定 UV 接缝、网格边界以及非流形边上的顶点：统计每条无向边被多少个三角形使用，
+     *  流形内部的边恰好被使用两次
+     * */
+    std::vector<uint8_t> locked(canonicalCount, 0);
+    for (size_t v = 0; v < canonicalCount; v++)
+    {
+        locked[v] = wedgeCount[v] > 1;
+    }
+    {
+        struct Edge
+        {
+            uint32_t a, b;
+        };
+        std::vector<Edge> edges;
+        edges.reserve(result.size());
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                uint32_t a = canonical[result[i + k]], b = canonical[result[i + (k + 1) % 3]];
+                if (a != b)
+                {
+                    edges.push_back(Edge{std::min(a, b), std::max(a, b)});
+                }
+            }
+        }
+        std::sort(edges.begin(), edges.end(), [](const Edge &l, const Edge &r)
+                  { return l.a < r.a || (l.a == r.a && l.b < r.b); });
+        for (size_t i = 0; i < edges.size();)
+        {
+            size_t j = i;
+            while (j < edges.size() && edges[j].a == edges[i].a && edges[j].b == edges[i].b)
+            {
+                j++;
+            }
+            if (j - i != 2)
+            {
+                locked[edges[i].a] = 1;
+                locked[edges[i].b] = 1;
+            }
+            i = j;
+        }
+    }
+
+    /**
+     *  3、累积每个顶点的二次误差矩阵
+     * */
+    std::vector<Quadric> quadrics(canonicalCount, Quadric{});
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+        uint32_t a = canonical[result[i]], b = canonical[result[i + 1]], c = canonical[result[i + 2]];
+        Quadric q = planeQuadric(canonicalPosition[a], canonicalPosition[b], canonicalPosition[c]);
+        quadrics[a].add(q);
+        quadrics[b].add(q);
+        quadrics[c].add(q);
+    }
+
+    /**
+     *  4、逐轮折叠
+     * */
+    const double targetCost = double(targetError) * double(targetError);
+    double resultCost = 0.0;
+    std::vector<uint32_t> adjacencyOffset(canonicalCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint8_t> touched(canonicalCount);
+    std::vector<Collapse> collapses;
+    if (remap)
+    {
+        remap->resize(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            (*remap)[v] = static_cast<uint32_t>(v);
+        }
+    }
+
+    while (result.size() > targetIndexCount)
+    {
+        const size_t triangleCount = result.size() / 3;
+
+        // 代表顶点 -> 相邻三角形（CSR）
+        std::fill(adjacencyOffset.begin(), adjacencyOffset.end(), 0);
+        for (uint32_t index : result)
+        {
+            adjacencyOffset[canonical[index] + 1]++;
+        }
+        for (size_t v = 0; v < canonicalCount; v++)
+        {
+            adjacencyOffset[v + 1] += adjacencyOffset[v];
+        }
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+            for (size_t i = 0; i < result.size(); i++)
+            {
+                adjacency[fill[canonical[result[i]]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // 枚举候选折叠（未锁定的顶点并入相邻顶点）
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                uint32_t a = canonical[result[i + k]], b = canonical[result[i + (k + 1) % 3]];
+                if (a == b)
+                {
+                    continue;
+                }
+                for (int direction = 0; direction < 2; direction++)
+                {
+                    uint32_t from = direction == 0 ? a : b, to = direction == 0 ? b : a;
+                    if (locked[from])
+                    {
+                        continue;
+                    }
+                    Quadric q = quadrics[from];
+                    q.add(quadrics[to]);
+                    double cost = q.weight > 0.0 ? q.evaluate(canonicalPosition[to]) / q.weight : 0.0;
+                    collapses.push_back(Collapse{cost, from, to});
+                }
+            }
+        }
+        if (collapses.empty())
+        {
+            break;
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse &l, const Collapse &r)
+                  { return l.cost < r.cost; });
+
+        // 每次折叠大约减少两个三角形，本轮最多执行的折叠数量
+        const size_t collapseBudget = (triangleCount - targetIndexCount / 3) / 2 + 1;
+        size_t performed = 0;
+        std::fill(touched.begin(), touched.end(), 0);
+        // 原始顶点的重映射（折叠时被移走的顶点指向目标顶点）
+        std::vector<uint32_t> wedgeTarget(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            wedgeTarget[v] = static_cast<uint32_t>(v);
+        }
+
+        for (const Collapse &collapse : collapses)
+        {
+            if (performed >= collapseBudget || collapse.cost > targetCost)
+            {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to])
+            {
+                continue;
+            }
+
+            // 检查折叠后 from 周围的三角形是否会翻转，同时找到与 from 同侧的 to 顶点（UV 接缝上 to 可能有多个原始顶点）
+            const Position &target = canonicalPosition[collapse.to];
+            bool flipped = false;
+            uint32_t toWedge = 0xFFFFFFFFu;
+            uint32_t fromWedge = 0xFFFFFFFFu;
+            for (uint32_t a = adjacencyOffset[collapse.from]; a < adjacencyOffset[collapse.from + 1] && !flipped; a++)
+            {
+                uint32_t t = adjacency[a];
+                uint32_t corners[3] = {result[t * 3], result[t * 3 + 1], result[t * 3 + 2]};
+                uint32_t c[3] = {canonical[corners[0]], canonical[corners[1]], canonical[corners[2]]};
+                bool hasTo = false;
+                for (int k = 0; k < 3; k++)
+                {
+                    if (c[k] == collapse.from)
+                    {
+                        fromWedge = corners[k];
+                    }
+                    if (c[k] == collapse.to)
+                    {
+                        hasTo = true;
+                        toWedge = corners[k];
+                    }
+                }
+                if (hasTo)
+                {
+                    continue; // 这个三角形折叠后退化，会被删除
+                }
+                Position p[3] = {canonicalPosition[c[0]], canonicalPosition[c[1]], canonicalPosition[c[2]]};
+                Position before = cross(sub(p[1], p[0]), sub(p[2], p[0]));
+                for (int k = 0; k < 3; k++)
+                {
+                    if (c[k] == collapse.from)
+                    {
+                        p[k] = target;
+                    }
+                }
+                Position after = cross(sub(p[1], p[0]), sub(p[2], p[0]));
+                // 法线方向偏转超过 90 度，或者折叠后面积退化为 0，都视为翻转
+                if (dot(before, after) <= 1e-6 * std::sqrt(dot(before, before) * dot(after, after)) || dot(after, after) <= 0.0)
+                {
+                    flipped = true;
+                }
+            }
+            if (flipped || toWedge == 0xFFFFFFFFu || fromWedge == 0xFFFFFFFFu)
+            {
+                continue;
+            }
+
+            // 执行折叠：未锁定的顶点只有一个原始顶点，直接重映射到同侧的目标顶点
+            wedgeTarget[fromWedge] = toWedge;
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            touched[collapse.from] = 1;
+            touched[collapse.to] = 1;
+            resultCost = std::max(resultCost, collapse.cost);
+            performed++;
+        }
+
+        if (performed == 0)
+        {
+            break;
+        }
+        if (remap)
+        {
+            for (uint32_t &target : *remap)
+            {
+                target = wedgeTarget[target];
+            }
+        }
+
+        // 重写索引并删除退化三角形
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            uint32_t v0 = wedgeTarget[result[i]], v1 = wedgeTarget[result[i + 1]], v2 = wedgeTarget[result[i + 2]];
+            uint32_t c0 = canonical[v0], c1 = canonical[v1], c2 = canonical[v2];
+            if (c0 == c1 || c1 == c2 || c0 == c2)
+            {
+                continue;
+            }
+            result[write++] = v0;
+            result[write++] = v1;
+            result[write++] = v2;
+        }
+        result.resize(write);
+    }
+
+    return static_cast<float>(std::sqrt(resultCost));
+}
+
+/**
+ *  计算原始网格中被引用的每个顶点到简化网格表面的最大距离
+ * */
+float measureSimplificationError(const float *positions, size_t positionStride, size_t vertexCount,
+                                 const uint32_t *originalIndices, size_t originalIndexCount,
+                                 const uint32_t *simplifiedIndices, size_t simplifiedIndexCount)
+{
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    for (size_t i = 0; i < originalIndexCount; i++)
+    {
+        referenced[originalIndices[i]] = 1;
+    }
+
+    double maximum = 0.0;
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        if (!referenced[v])
+        {
+            continue;
+        }
+        Position p = loadPosition(positions, positionStride, static_cast<uint32_t>(v));
+        double nearest = std::numeric_limits<double>::max();
+        for (size_t i = 0; i + 2 < simplifiedIndexCount; i += 3)
+        {
+            nearest = std::min(nearest, pointTriangleDistanceSquared(p,
+                                                                     loadPosition(positions, positionStride, simplifiedIndices[i]),
+                                                                     loadPosition(positions, positionStride, simplifiedIndices[i + 1]),
+                                                                     loadPosition(positions, positionStride, simplifiedIndices[i + 2])));
+        }
+        maximum = std::max(maximum, nearest);
+    }
+    return static_cast<float>(std::sqrt(maximum));
+}
+
+/**
+ *  由折叠关系计算误差上界：原始顶点到代替它的顶点周围三角形的最近距离
+ * */
+float boundSimplificationError(const float *positions, size_t positionStride, size_t vertexCount,
+                               const uint32_t *originalIndices, size_t originalIndexCount,
+                               const uint32_t *simplifiedIndices, size_t simplifiedIndexCount,
+                               const std::vector<uint32_t> &remap)
+{
+    if (remap.size() != vertexCount)
+    {
+        throw std::runtime_error("boundSimplificationError: remap size does not match the vertex count!");
+    }
+
+    // 简化网格中每个顶点所在的三角形（CSR）
+    std::vector<uint32_t> fanOffset(vertexCount + 1, 0);
+    for (size_t i = 0; i < simplifiedIndexCount; i++)
+    {
+        fanOffset[simplifiedIndices[i] + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        fanOffset[v + 1] += fanOffset[v];
+    }
+    std::vector<uint32_t> fans(simplifiedIndexCount);
+    {
+        std::vector<uint32_t> fill(fanOffset.begin(), fanOffset.end() - 1);
+        for (size_t i = 0; i < simplifiedIndexCount; i++)
+        {
+            fans[fill[simplifiedIndices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+    auto triangleDistanceSquared = [&](const Position &p, uint32_t t)
+    {
+        return pointTriangleDistanceSquared(p,
+                                            loadPosition(positions, positionStride, simplifiedIndices[t * 3]),
+                                            loadPosition(positions, positionStride, simplifiedIndices[t * 3 + 1]),
+                                            loadPosition(positions, positionStride, simplifiedIndices[t * 3 + 2]));
+    };
+
+    std::vector<uint8_t> visited(vertexCount, 0);
+    double maximum = 0.0;
+    for (size_t i = 0; i < originalIndexCount; i++)
+    {
+        uint32_t v = originalIndices[i];
+        if (visited[v])
+        {
+            continue;
+        }
+        visited[v] = 1;
+
+        // 仍然存在的顶点就在简化网格表面上；被移走的顶点到目标顶点周围三角形的距离不小于它到整个表面的距离
+        uint32_t target = remap[v];
+        if (target == v && fanOffset[v + 1] > fanOffset[v])
+        {
+            continue;
+        }
+        Position p = loadPosition(positions, positionStride, v);
+        double nearest = std::numeric_limits<double>::max();
+        for (uint32_t f = fanOffset[target]; f < fanOffset[target + 1]; f++)
+        {
+            nearest = std::min(nearest, triangleDistanceSquared(p, fans[f]));
+        }
+        // 目标顶点不在简化网格中（不应出现），退回逐个三角形计算
+        if (fanOffset[target + 1] == fanOffset[target])
+        {
+            for (uint32_t t = 0; t < simplifiedIndexCount / 3; t++)
+            {
+                nearest = std::min(nearest, triangleDistanceSquared(p, t));
+            }
+        }
+        if (nearest != std::numeric_limits<double>::max())
+        {
+            maximum = std::max(maximum, nearest);
+        }
+    }
+    return static_cast<float>(std::sqrt(maximum));
+}
+
+/**
+ *  根据投影到屏幕上的误差选择 LOD
+ * */
+uint32_t selectMeshLod(const MeshLod *lods, size_t lodCount, float distance, float pixelsPerUnit, float pixelThreshold)
+{
+    distance = std::max(distance, 1e-4f);
+    uint32_t selected = 0;
+    for (size_t i = 1; i < lodCount; i++)
+    {
+        if (lods[i].error * pixelsPerUnit / distance <= pixelThreshold)
+        {
+            selected = static_cast<uint32_t>(i);
+        }
+    }
+    return selected;
+}
@@ -130,6 +130,23 @@ QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device)
         }
         i++;
     }
+
+    /**
+     *  专用传输队列：只支持 VK_QUEUE_TRANSFER_BIT、不支持图形与计算的队列族一般对应独立的 DMA 引擎，上传在它上面执行时
+     * 不占用图形队列。minImageTransferGranularity 为 (0, 0, 0) 的队列族只能整级拷贝图像，无法按块行拆分上传，不使用
+     * */
+    for (uint32_t family = 0; family < queueFamilyCount; family++)
+    {
+        const VkQueueFamilyProperties &properties = queueFamilies[family];
+        const VkExtent3D &granularity = properties.minImageTransferGranularity;
+        if ((properties.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+            !(properties.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) &&
+            granularity.width != 0 && granularity.height != 0 && granularity.depth != 0)
+        {
+            indices.transferFamily = family;
+            break;
+        }
+    }
     return indices;
 }
 
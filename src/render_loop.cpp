@@ -1,11 +1,17 @@
 #include "render_loop.h"
 
+#include "scene.h"
+#include "asset_streaming.h"
+#include "gpu_culling.h"
+
 std::vector<VkSemaphore> imageAvailableSemaphores; // 流程控制信号1：用来指示图像已经从 swapchain 中获取到，准备渲染
 std::vector<VkSemaphore> renderFinishedSemaphores; // 流程控制信号2：用来指示图像渲染已经完成并可以进行展示
 std::vector<VkFence> inFlightFences;               // 流程控制信号3：用于确保每帧只渲染一次，在渲染完成前阻塞后续的操作
 
 uint32_t currentFrame = 0; // 当前帧 index
 
+double frameCpuMilliseconds = 0.0; // 上一帧 CPU 端准备一帧（uniform buffer、绘制列表、命令录制）的耗时
+
 /**
  *  主渲染函数 Render Loop
  * */
@@ -44,26 +50,58 @@ void drawFrame()
         throw std::runtime_error("failed to acquire swap chain image!");
     }
 
+    // 后台加载完成的资源在这里上传并替换占位资源
+    pollAssetStreaming();
+
+    auto prepareStart = std::chrono::high_resolution_clock::now();
+
     // 更新uniform buffer，通过对MVP变换阵的赋值，达到让场景中物体“动起来”的效果
     updateUniformBuffer(currentFrame);
 
+    if (gpuCullingActive)
+    {
+        // GPU 剔除：只写入本帧的视锥平面与 LOD 参数，剔除与 LOD 选择在录制的 compute pass 中完成
+        updateGpuCulling(currentFrame);
+    }
+    else
+    {
+        // 根据本帧的变换阵为每个网格选择 LOD 并做簇剔除，recordCommandBuffer() 中按生成的绘制列表发出绘制
+        updateSceneDraws();
+    }
+
     // fences 不同于 semaphore，它需要我们进行手动重置，否则下一帧会卡住
     vkResetFences(device, 1, &inFlightFences[currentFrame]);
 
-    // 重置并填充command buffer，用于提交到 graphic queue 对场景中的物体进行渲染
-    vkResetCommandBuffer(commandBuffers[currentFrame], 0);
-    recordCommandBuffer(commandBuffers[currentFrame], imageIndex, currentFrame);
+    // 取得本帧的command buffer：复用预录制的命令缓冲区，或者重置并重新填充
+    UploadWait uploadWait;
+    VkCommandBuffer frameCommandBuffer = prepareFrameCommandBuffer(imageIndex, currentFrame, uploadWait);
+    frameCpuMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - prepareStart).count();
 
     // 向“图形渲染指令集队列”提交指令集合
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]}; // 通过哪个semaphore控制“放行”
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame], getUploadTimelineSemaphore()}; // 通过哪个semaphore控制“放行”
+    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, uploadWait.stages};
     submitInfo.waitSemaphoreCount = 1;           // 等几个信号灯
     submitInfo.pWaitSemaphores = waitSemaphores; // 等哪个信号灯（信号灯序列，因为可能要等待多个）
     submitInfo.pWaitDstStageMask = waitStages;   // 我们希望在哪个状态进入等待，这里配置为着色阶段
+
+    /**
+     *  本帧 acquire 了传输队列上传的资源时，额外等待上传的 timeline semaphore（只在使用这些资源的阶段等待，CPU 不阻塞）。
+     *  二元信号量对应的等待值会被忽略
+     * */
+    uint64_t waitValues[] = {0, uploadWait.value};
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = 2;
+    timelineInfo.pWaitSemaphoreValues = waitValues;
+    if (uploadWait.value != 0)
+    {
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.waitSemaphoreCount = 2;
+    }
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
+    submitInfo.pCommandBuffers = &frameCommandBuffer;
     // 控流用的信号灯，当前执行完成后，要置位哪个信号灯？也就是说，当前执行完成后，会通过这个信号灯放行哪些后续的操作。
     VkSemaphore signalSemaphores[] = {renderFinishedSemaphores[currentFrame]};
     submitInfo.signalSemaphoreCount = 1;
@@ -101,6 +139,9 @@ void drawFrame()
         throw std::runtime_error("failed to present swap chain image!");
     }
 
+    // 统计首帧时间与完整画质时间
+    onFramePresented();
+
     // 更新当前帧的索引
     currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
@@ -191,6 +232,9 @@ void recreateSwapChain()
     createColorResources();
     createDepthResources();
     createFramebuffers();
+
+    // 预录制的命令缓冲区引用了旧的 framebuffer，交换链图像数量也可能变化
+    freePrerecordedCommandBuffers();
     /*
         以上的方法虽然可以正确的重建交换链，但该方法的缺点是，我们不得不在需要创建新的交换链时停掉所有正在
     运行的渲染。如果想要在运行时更改交换链且不影响旧的渲染进行，可以考虑使用将之前的交换链传递到
@@ -0,0 +1,248 @@
+#include "render_queue.h"
+
+#include "gpu_culling.h"
+#include "bindless_textures.h"
+
+const bool enableRenderQueueSort = true;
+
+RenderBindStatistics renderBindStatistics{};
+
+static const uint32_t SORT_KEY_PIPELINE_BITS = 8;
+static const uint32_t SORT_KEY_MATERIAL_BITS = 16;
+static const uint32_t SORT_KEY_MESH_BITS = 16;
+static const uint32_t SORT_KEY_DEPTH_BITS = 24;
+
+static std::vector<RenderQueueItem> renderQueue;        // 每帧复用，避免重复分配
+static std::vector<RenderQueueItem> renderQueueScratch; // 基数排序的临时空间
+static std::vector<SceneDraw> sortedDraws;
+
+RenderBindStatistics &RenderBindStatistics::operator+=(const RenderBindStatistics &other)
+{
+    pipelineBinds += other.pipelineBinds;
+    pipelineBindsElided += other.pipelineBindsElided;
+    descriptorBinds += other.descriptorBinds;
+    descriptorBindsElided += other.descriptorBindsElided;
+    pushConstants += other.pushConstants;
+    pushConstantsElided += other.pushConstantsElided;
+    geometryBinds += other.geometryBinds;
+    geometryBindsElided += other.geometryBindsElided;
+    return *this;
+}
+
+/**
+ *  打包排序键
+ * */
+uint64_t makeRenderSortKey(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth)
+{
+    /*
+        非负 float 的位模式按整数比较与按浮点数比较的顺序相同，去掉符号位后取高 24 位即为单调的深度量化
+    （保留 8 位指数与 16 位尾数，相对精度约 1.5e-5）。
+    */
+    uint32_t depthBits = 0;
+    if (depth > 0.0f)
+    {
+        std::memcpy(&depthBits, &depth, sizeof(float));
+        depthBits >>= 31 - SORT_KEY_DEPTH_BITS;
+    }
+
+    uint64_t key = std::min<uint64_t>(pipeline, (1u << SORT_KEY_PIPELINE_BITS) - 1);
+    key = (key << SORT_KEY_MATERIAL_BITS) | std::min<uint64_t>(material, (1u << SORT_KEY_MATERIAL_BITS) - 1);
+    key = (key << SORT_KEY_MESH_BITS) | std::min<uint64_t>(mesh, (1u << SORT_KEY_MESH_BITS) - 1);
+    key = (key << SORT_KEY_DEPTH_BITS) | depthBits;
+    return key;
+}
+
+/**
+ *  LSD 基数排序：每趟按 8 位分桶，共 8 趟
+ * */
+void radixSortRenderQueue(std::vector<RenderQueueItem> &items, std::vector<RenderQueueItem> &scratch)
+{
+    scratch.resize(items.size());
+    for (uint32_t shift = 0; shift < 64; shift += 8)
+    {
+        std::array<size_t, 256> counts{};
+        for (const RenderQueueItem &item : items)
+        {
+            counts[(item.key >> shift) & 0xFF]++;
+        }
+        // 所有键的这 8 位都相同（例如只有一条管线时的高位），这一趟不改变顺序
+        if (counts[(items.empty() ? 0 : items[0].key >> shift) & 0xFF] == items.size())
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t &count : counts)
+        {
+            size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for (const RenderQueueItem &item : items)
+        {
+            scratch[counts[(item.key >> shift) & 0xFF]++] = item;
+        }
+        items.swap(scratch);
+    }
+}
+
+/**
+ *  按排序键重排本帧的绘制列表
+ * */
+void sortSceneDraws()
+{
+    if (sceneDraws.size() <= 1)
+    {
+        return;
+    }
+
+    renderQueue.resize(sceneDraws.size());
+    for (uint32_t i = 0; i < sceneDraws.size(); i++)
+    {
+        const SceneDraw &draw = sceneDraws[i];
+        const ModelMesh &mesh = modelMeshes[draw.mesh];
+        renderQueue[i] = RenderQueueItem{makeRenderSortKey(mesh.pipeline, mesh.material, draw.mesh, draw.depth), i};
+    }
+    radixSortRenderQueue(renderQueue, renderQueueScratch);
+
+    sortedDraws.resize(sceneDraws.size());
+    for (size_t i = 0; i < renderQueue.size(); i++)
+    {
+        sortedDraws[i] = sceneDraws[renderQueue[i].draw];
+    }
+    sceneDraws.swap(sortedDraws);
+}
+
+/**
+ *  管线编号对应的管线（编号即管线使用的顶点格式）
+ * */
+static VkPipeline getRenderPipeline(uint32_t pipeline)
+{
+    if (pipeline >= graphicsPipelines.size())
+    {
+        throw std::runtime_error("unknown render pipeline!");
+    }
+    return graphicsPipelines[pipeline];
+}
+
+/**
+ *  材质编号对应的描述符集（每帧一份）。bindless 模式下所有材质共用同一个描述符集，材质只决定纹理下标
+ * */
+static VkDescriptorSet getRenderMaterial(uint32_t material, uint32_t currentFrame)
+{
+    if (bindlessTexturesActive)
+    {
+        getMaterialTextureIndex(material);
+    }
+    else if (material != 0)
+    {
+        throw std::runtime_error("unknown render material!");
+    }
+    return descriptorSets[currentFrame];
+}
+
+/**
+ *  绘制的 push constants：CPU 端绘制时为网格的位置反量化（GPU 剔除时已经合并进实例变换阵），以及材质的纹理下标
+ * */
+static DrawPushConstants getDrawPushConstants(uint32_t material, uint32_t object)
+{
+    DrawPushConstants constants{};
+    constants.meshTransform = gpuCullingActive ? glm::mat4(1.0f) : modelMeshes[object].quantization.getPositionTransform();
+    constants.textureIndex = bindlessTexturesActive ? getMaterialTextureIndex(material) : 0;
+    return constants;
+}
+
+/**
+ *  绑定管线、材质、物体与几何数据，跳过与当前状态相同的绑定
+ * */
+void bindRenderState(RenderStateCache &cache, uint32_t pipeline, uint32_t material, uint32_t object, uint32_t geometry)
+{
+    if (cache.pipeline != pipeline)
+    {
+        vkCmdBindPipeline(cache.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getRenderPipeline(pipeline));
+        cache.pipeline = pipeline;
+        cache.statistics.pipelineBinds++;
+    }
+    else
+    {
+        cache.statistics.pipelineBindsElided++;
+    }
+
+    // bindless 模式下纹理数组（set 1）在每个命令缓冲区中只绑定一次
+    if (bindlessTexturesActive && !cache.bindlessBound)
+    {
+        vkCmdBindDescriptorSets(cache.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &bindlessDescriptorSet, 0, nullptr);
+        cache.bindlessBound = true;
+        cache.statistics.descriptorBinds++;
+    }
+
+    // 所有管线共用 pipelineLayout，切换管线后已绑定的描述符集与 push constants 仍然有效
+    // 物体的数据块通过动态偏移选择，换物体只需要用新的偏移重新绑定同一个描述符集；bindless 模式下换材质不需要重新绑定
+    const bool materialChanged = cache.material != material;
+    const bool objectChanged = cache.object != object;
+    if (objectChanged || (materialChanged && !bindlessTexturesActive))
+    {
+        VkDescriptorSet descriptorSet = getRenderMaterial(material, cache.currentFrame);
+        uint32_t dynamicOffset = getObjectUniformOffset(object);
+        vkCmdBindDescriptorSets(cache.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &dynamicOffset);
+        cache.statistics.descriptorBinds++;
+    }
+    else
+    {
+        cache.statistics.descriptorBindsElided++;
+    }
+
+    // push constants 包含网格局部变换与材质的纹理下标
+    if (objectChanged || (materialChanged && bindlessTexturesActive))
+    {
+        DrawPushConstants constants = getDrawPushConstants(material, object);
+        vkCmdPushConstants(cache.commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(DrawPushConstants), &constants);
+        cache.statistics.pushConstants++;
+    }
+    else
+    {
+        cache.statistics.pushConstantsElided++;
+    }
+    cache.material = material;
+    cache.object = object;
+
+    if (cache.geometry != geometry)
+    {
+        if (geometry != 0)
+        {
+            throw std::runtime_error("unknown render geometry!");
+        }
+        // binding 0 为所有模型网格的顶点数据，binding 1 为按实例前进的 instance buffer
+        VkBuffer vertexBuffers[] = {vertexBuffer, instanceBuffer};
+        VkDeviceSize offsets[] = {0, 0};
+        vkCmdBindVertexBuffers(cache.commandBuffer, 0, 2, vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(cache.commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        cache.geometry = geometry;
+        cache.statistics.geometryBinds++;
+    }
+    else
+    {
+        cache.statistics.geometryBindsElided++;
+    }
+}
+
+/**
+ *  按绘制所属的网格绑定状态（每个网格是一个物体；所有网格存放在同一组顶点/索引缓冲中，几何数据编号为 0）
+ * */
+void bindSceneDrawState(RenderStateCache &cache, const SceneDraw &draw)
+{
+    const ModelMesh &mesh = modelMeshes[draw.mesh];
+    bindRenderState(cache, mesh.pipeline, mesh.material, draw.mesh, 0);
+}
+
+/**
+ *  输出绑定统计
+ * */
+void printRenderBindStatistics(const RenderBindStatistics &statistics)
+{
+    std::cout << "render queue: " << statistics.issued() << " binds issued, " << statistics.elided() << " elided (pipeline "
+              << statistics.pipelineBinds << "/" << statistics.pipelineBindsElided << ", descriptor "
+              << statistics.descriptorBinds << "/" << statistics.descriptorBindsElided << ", push constant "
+              << statistics.pushConstants << "/" << statistics.pushConstantsElided << ", geometry "
+              << statistics.geometryBinds << "/" << statistics.geometryBindsElided << ")" << std::endl;
+}
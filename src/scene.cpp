@@ -0,0 +1,353 @@
+#include "scene.h"
+
+#include "render_loop.h"
+#include "gpu_culling.h"
+#include "render_queue.h"
+
+#include <cmath>
+
+// 是否使用多模型实例化场景（关闭时只导入 MODEL_PATH，放置一个实例）
+const bool enableInstancedScene = false;
+
+// 实例化场景中使用的模型，实例依次轮流使用这些模型
+const std::vector<std::string> SCENE_MODEL_PATHS = {"../models/bird.obj", "../models/fish.obj", "../models/bunny.obj"};
+
+// 实例化场景中的实例数量
+const uint32_t SCENE_INSTANCE_COUNT = 3000;
+
+// 是否在进入主循环前运行实例数量逐级增加的帧耗时测试
+const bool enableSceneBenchmark = false;
+const std::vector<uint32_t> SCENE_BENCHMARK_INSTANCE_COUNTS = {1, 10, 100, 1000, 10000, 100000};
+const uint32_t SCENE_BENCHMARK_FRAMES = 300;
+
+// 实例化场景在 XY 平面上占据的边长，以及每个实例相对格子的大小
+const float SCENE_GRID_EXTENT = 2.0f;
+const float SCENE_INSTANCE_FILL = 0.8f;
+
+std::vector<SceneInstance> sceneInstances;
+std::vector<SceneMeshInstances> sceneMeshInstances;
+std::vector<uint32_t> sceneMeshLods;
+std::vector<SceneDraw> sceneDraws;
+MeshletCullStatistics meshletCullStatistics{};
+
+VkBuffer instanceBuffer;             // instance buffer 实例
+MemoryAllocation instanceBufferMemory; // instance buffer 对应在 GPU device 上的内存
+
+/**
+ *  场景中使用的模型文件路径
+ * */
+std::vector<std::string> getSceneModelPaths()
+{
+    return enableInstancedScene ? SCENE_MODEL_PATHS : std::vector<std::string>{MODEL_PATH};
+}
+
+/**
+ *  导入场景中的所有模型网格并摆放实例
+ * */
+void loadScene()
+{
+    const std::vector<std::string> paths = getSceneModelPaths();
+
+    // ModelMesh 中的 MeshCache 只能移动，这里一次性分配好，避免扩容时搬移
+    modelMeshes.clear();
+    modelMeshes.resize(paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        loadModelMesh(paths[i], modelMeshes[i]);
+    }
+
+    layoutSceneInstances(enableInstancedScene ? SCENE_INSTANCE_COUNT : 0);
+}
+
+/**
+ *  使用一个立方体作为占位网格
+ * */
+void loadPlaceholderScene()
+{
+    modelMeshes.clear();
+    modelMeshes.resize(1);
+    ModelMesh &mesh = modelMeshes[0];
+    mesh.path = "<placeholder>";
+
+    const float h = 0.25f;
+    for (int i = 0; i < 8; i++)
+    {
+        glm::vec3 position((i & 1) ? h : -h, (i & 2) ? h : -h, (i & 4) ? h : -h);
+        mesh.vertices.push_back(Vertex{position, glm::vec3(0.5f), glm::vec2(0.0f)});
+    }
+    // 六个面，每个面两个三角形，从外侧看为逆时针
+    mesh.indices = {0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6,
+                    0, 1, 5, 0, 5, 4, 2, 6, 7, 2, 7, 3,
+                    0, 4, 6, 0, 6, 2, 1, 3, 7, 1, 7, 5};
+    mesh.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    mesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    mesh.lods.assign(1, MeshLod{0, mesh.indexCount, 0.0f, 0});
+    computeMeshBounds(mesh);
+    buildMeshMeshlets(mesh);
+
+    layoutSceneInstances(0);
+}
+
+/**
+ *  摆放实例
+ * */
+void layoutSceneInstances(uint32_t instanceCount)
+{
+    sceneInstances.clear();
+    sceneMeshInstances.assign(modelMeshes.size(), SceneMeshInstances{0, 0});
+    sceneMeshLods.assign(modelMeshes.size(), 0);
+    if (modelMeshes.empty())
+    {
+        return;
+    }
+
+    if (instanceCount == 0)
+    {
+        for (uint32_t m = 0; m < modelMeshes.size(); m++)
+        {
+            sceneMeshInstances[m] = SceneMeshInstances{m, 1};
+            sceneInstances.push_back(SceneInstance{m, glm::mat4(1.0f), 1.0f});
+        }
+        return;
+    }
+
+    // 第 i 个实例使用第 i % 网格数 个网格，放在第 i 个格子里；实例按网格分组存放，同一网格的实例在 instance buffer 中连续
+    const uint32_t meshCount = static_cast<uint32_t>(modelMeshes.size());
+    const uint32_t gridSize = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(instanceCount))));
+    const float cellSize = SCENE_GRID_EXTENT / gridSize;
+    sceneInstances.reserve(instanceCount);
+    for (uint32_t m = 0; m < meshCount; m++)
+    {
+        const glm::vec4 &sphere = modelMeshes[m].boundingSphere;
+        const float scale = sphere.w > 0.0f ? cellSize * 0.5f * SCENE_INSTANCE_FILL / sphere.w : 1.0f;
+
+        sceneMeshInstances[m].firstInstance = static_cast<uint32_t>(sceneInstances.size());
+        for (uint32_t i = m; i < instanceCount; i += meshCount)
+        {
+            glm::vec3 cellCenter((i % gridSize + 0.5f) * cellSize - SCENE_GRID_EXTENT * 0.5f,
+                                 (i / gridSize + 0.5f) * cellSize - SCENE_GRID_EXTENT * 0.5f,
+                                 0.0f);
+            // 用黄金角给每个实例一个不同的朝向
+            float angle = static_cast<float>(i) * 2.39996323f;
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), cellCenter);
+            transform = glm::rotate(transform, angle, glm::vec3(0.0f, 0.0f, 1.0f));
+            transform = glm::scale(transform, glm::vec3(scale));
+            transform = glm::translate(transform, -glm::vec3(sphere));
+            sceneInstances.push_back(SceneInstance{m, transform, scale});
+        }
+        sceneMeshInstances[m].instanceCount = static_cast<uint32_t>(sceneInstances.size()) - sceneMeshInstances[m].firstInstance;
+    }
+}
+
+/**
+ *  GPU上创建 Instance Buffer，并导入实例数据
+ * */
+void createInstanceBuffer()
+{
+    // 每个网格是一个物体，在物体环形缓冲中占一个槽位；网格在初始化与替换时都会重建实例缓冲，在这里统一检查
+    if (modelMeshes.size() > OBJECT_UNIFORM_CAPACITY)
+    {
+        throw std::runtime_error("too many objects for the object uniform ring: " + std::to_string(modelMeshes.size()) +
+                                 " meshes, capacity " + std::to_string(OBJECT_UNIFORM_CAPACITY));
+    }
+
+    // 实例数为 0 时仍然创建一个最小的缓冲区，保证绑定的 VkBuffer 始终有效
+    VkDeviceSize bufferSize = sizeof(InstanceData) * std::max<size_t>(sceneInstances.size(), 1);
+
+    createBuffer(bufferSize,
+                 VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                 instanceBuffer,
+                 instanceBufferMemory);
+
+    /*
+        紧凑顶点格式的位置反量化按网格不同，CPU 端的绘制通过每个绘制的 push constants 传入；GPU 剔除时所有网格
+    共用一次间接绘制，只能合并进每个实例的变换阵（直接写入暂存空间）。
+    */
+    uploadElementsToBuffer(instanceBuffer, 0, sceneInstances.size(), sizeof(InstanceData),
+                           [](void *destination, size_t first, size_t count)
+                           {
+                               InstanceData *instances = static_cast<InstanceData *>(destination);
+                               for (size_t i = 0; i < count; i++)
+                               {
+                                   const SceneInstance &instance = sceneInstances[first + i];
+                                   const ModelMesh &mesh = modelMeshes[instance.mesh];
+                                   instances[i].model = gpuCullingActive ? instance.transform * mesh.quantization.getPositionTransform() : instance.transform;
+                                   instances[i].texCoordTransform = mesh.quantization.getTexCoordTransform();
+                               }
+                           });
+
+    // GPU 剔除使用的物体数据与实例一一对应，随 instance buffer 一起重建
+    createGpuCullingBuffers();
+    submitStagingCommands();
+}
+
+/**
+ *  注销 Instance Buffer，释放其对应的内存
+ * */
+void cleanupInstanceBuffer()
+{
+    cleanupGpuCullingBuffers();
+    vkDestroyBuffer(device, instanceBuffer, nullptr);
+    freeMemoryAllocation(instanceBufferMemory);
+}
+
+/**
+ *  根据当前帧的变换阵为每个网格选择 LOD，并生成本帧的绘制列表
+ * */
+void updateSceneDraws()
+{
+    sceneDraws.clear();
+    meshletCullStatistics = MeshletCullStatistics{};
+
+    const glm::mat4 sceneView = frameViewMatrix * frameModelMatrix;
+    // proj[1][1] = 1 / tan(fovy / 2)，乘以半个屏幕高度即为单位距离处一个单位长度对应的像素数
+    const float pixelsPerUnit = std::abs(frameProjMatrix[1][1]) * swapChainExtent.height * 0.5f;
+
+    std::vector<MeshletDrawRange> ranges;
+    for (uint32_t m = 0; m < modelMeshes.size(); m++)
+    {
+        const ModelMesh &mesh = modelMeshes[m];
+        const SceneMeshInstances &instances = sceneMeshInstances[m];
+        if (instances.instanceCount == 0)
+        {
+            continue;
+        }
+
+        /*
+            同一网格的所有实例共用一次绘制，所以只能选择一个 LOD：取离相机最近（按实例缩放换算到模型空间）的实例，
+        保证任何实例的投影误差都不超过阈值。相机在某个实例的包围球内部时 selectMeshLod() 会选择 LOD0。
+        */
+        const bool selectLod = enableMeshLod && mesh.lods.size() > 1;
+        float nearest = std::numeric_limits<float>::max();      // 模型空间下的最近距离，用于选择 LOD
+        float nearestDepth = std::numeric_limits<float>::max(); // 观察空间下的最近距离，用于渲染队列排序
+        if (selectLod || enableRenderQueueSort)
+        {
+            for (uint32_t i = instances.firstInstance; i < instances.firstInstance + instances.instanceCount; i++)
+            {
+                const SceneInstance &instance = sceneInstances[i];
+                glm::vec3 center = glm::vec3(sceneView * instance.transform * glm::vec4(glm::vec3(mesh.boundingSphere), 1.0f));
+                float depth = std::sqrt(glm::dot(center, center)) - mesh.boundingSphere.w * instance.scale;
+                nearestDepth = std::min(nearestDepth, depth);
+                nearest = std::min(nearest, depth / instance.scale);
+            }
+        }
+
+        uint32_t lod = 0;
+        if (selectLod)
+        {
+            lod = selectMeshLod(mesh.lods.data(), mesh.lods.size(), nearest, pixelsPerUnit, LOD_PIXEL_ERROR_THRESHOLD);
+        }
+        sceneMeshLods[m] = lod;
+
+        // 只有一个实例时在模型空间中做簇剔除，只绘制可见的索引区间
+        if (enableMeshletCulling && instances.instanceCount == 1 && !mesh.meshlets.empty())
+        {
+            glm::mat4 modelView = sceneView * sceneInstances[instances.firstInstance].transform;
+            // 相机在模型空间中的位置
+            glm::vec3 cameraPosition = glm::vec3(glm::inverse(modelView) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+            const uint32_t first = mesh.lodMeshletOffsets[lod];
+            const uint32_t count = mesh.lodMeshletOffsets[lod + 1] - first;
+            MeshletCullStatistics statistics;
+            cullMeshlets(mesh.meshlets.data() + first, count, frameProjMatrix * modelView, cameraPosition, ranges, statistics);
+
+            meshletCullStatistics.totalMeshlets += statistics.totalMeshlets;
+            meshletCullStatistics.visibleMeshlets += statistics.visibleMeshlets;
+            meshletCullStatistics.frustumCulled += statistics.frustumCulled;
+            meshletCullStatistics.backfaceCulled += statistics.backfaceCulled;
+            meshletCullStatistics.drawCount += statistics.drawCount;
+            meshletCullStatistics.visibleIndices += statistics.visibleIndices;
+            for (const MeshletDrawRange &range : ranges)
+            {
+                sceneDraws.push_back(SceneDraw{range.indexCount, 1, mesh.firstIndex + range.indexOffset,
+                                               static_cast<int32_t>(mesh.baseVertex), instances.firstInstance, m, nearestDepth});
+            }
+            continue;
+        }
+
+        const MeshLod &selected = mesh.lods[lod];
+        sceneDraws.push_back(SceneDraw{selected.indexCount, instances.instanceCount, mesh.firstIndex + selected.indexOffset,
+                                       static_cast<int32_t>(mesh.baseVertex), instances.firstInstance, m, nearestDepth});
+    }
+
+    if (enableRenderQueueSort)
+    {
+        sortSceneDraws();
+    }
+}
+
+/**
+ *  实例数量逐级增加，统计每一级的平均帧耗时
+ * */
+void benchmarkScene()
+{
+    /*
+        帧耗时包含 CPU 端 LOD 选择与命令录制，以及 GPU 端的绘制。FIFO 呈现模式下帧率会被限制在屏幕刷新率，
+    所以这里同时输出当前的呈现模式，测试时应使用 MAILBOX/IMMEDIATE。cpu 一项为 drawFrame() 中 CPU 端准备一帧
+    （更新 uniform buffer、生成绘制列表、录制命令）的耗时，不包括等待 fence 与交换链图像的时间。
+    */
+    std::cout << "scene benchmark: " << modelMeshes.size() << " meshes, present mode " << swapChainPresentMode
+              << (swapChainPresentMode == VK_PRESENT_MODE_FIFO_KHR ? " (FIFO, frame rate is capped by vsync)" : "") << std::endl;
+
+    const uint32_t warmupFrames = 30;
+    for (uint32_t instanceCount : SCENE_BENCHMARK_INSTANCE_COUNTS)
+    {
+        if (glfwWindowShouldClose(window))
+        {
+            break;
+        }
+
+        // 重建实例缓冲前需要等待 GPU 不再使用旧的缓冲
+        vkDeviceWaitIdle(device);
+        cleanupInstanceBuffer();
+        layoutSceneInstances(instanceCount);
+        createInstanceBuffer();
+        invalidateCommandBuffers();
+
+        for (uint32_t frame = 0; frame < warmupFrames; frame++)
+        {
+            glfwPollEvents();
+            drawFrame();
+        }
+        vkDeviceWaitIdle(device);
+
+        double frameCpuMillisecondsSum = 0.0;
+        uint32_t frameCpuSamples = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < SCENE_BENCHMARK_FRAMES; frame++)
+        {
+            glfwPollEvents();
+            drawFrame();
+            frameCpuMillisecondsSum += frameCpuMilliseconds;
+            frameCpuSamples++;
+        }
+        vkDeviceWaitIdle(device);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double frameTime = std::chrono::duration<double, std::milli>(end - start).count() / SCENE_BENCHMARK_FRAMES;
+        double cpuTime = frameCpuMillisecondsSum / frameCpuSamples;
+        std::cout << "  " << instanceCount << " instances: " << frameTime << " ms/frame (" << 1000.0 / frameTime << " fps), cpu "
+                  << cpuTime << " ms/frame, ";
+        if (gpuCullingActive)
+        {
+            // 剔除后的绘制数量只存在于 GPU 上，这里只输出参与剔除的物体数量
+            std::cout << getGpuCullObjectCount() << " objects tested by gpu culling" << std::endl;
+            continue;
+        }
+        uint64_t triangles = 0;
+        for (const SceneDraw &draw : sceneDraws)
+        {
+            triangles += static_cast<uint64_t>(draw.indexCount / 3) * draw.instanceCount;
+        }
+        std::cout << sceneDraws.size() << " draws, " << triangles << " triangles" << std::endl;
+        std::cout << "    ";
+        printRenderBindStatistics(renderBindStatistics);
+    }
+
+    // 恢复默认场景
+    vkDeviceWaitIdle(device);
+    cleanupInstanceBuffer();
+    layoutSceneInstances(enableInstancedScene ? SCENE_INSTANCE_COUNT : 0);
+    createInstanceBuffer();
+    invalidateCommandBuffers();
+}
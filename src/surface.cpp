@@ -5,6 +5,7 @@ VkSurfaceKHR surface; // surface 界面实例
 
 VkQueue graphicsQueue; // 用于处理 “图形绘制指令” 的队列（将在之后的 logical device 部分进行初始化）
 VkQueue presentQueue;  // 用于处理 “图形展示指令” 的队列（将在之后的 logical device 部分进行初始化）
+VkQueue transferQueue = VK_NULL_HANDLE; // 专用于数据传输的队列（设备没有独立的传输队列族时为空，上传走图形队列）
 
 /**
  *  创建界面实例
@@ -6,102 +6,491 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <sys/stat.h>
+
+const std::string TEXTURE_PATH = "../textures/viking_room.png";
+const std::string TEXTURE_KTX2_PATH = "../textures/viking_room.ktx2";
+
 uint32_t mipLevels; // 指定mipmap等级
 
+VkFormat textureFormat = VK_FORMAT_R8G8B8A8_SRGB; // 纹理图像当前使用的格式
+
 VkImage textureImage;              // 纹理贴图实例
-VkDeviceMemory textureImageMemory; // 纹理贴图设备内存
+MemoryAllocation textureImageMemory; // 纹理贴图设备内存
 VkImageView textureImageView;      // 纹理图的 ImageView 实例
 VkSampler textureSampler;          // 纹理图采样器实例
 
+const bool enableCpuMipmaps = true;       // 在 CPU 上生成 mip 链（关闭后使用 vkCmdBlitImage 逐级生成）
+const bool enableMipmapBenchmark = false; // 启动时对比 CPU 与 blit 两种 mipmap 生成方式的耗时
+const int MIPMAP_BENCHMARK_RUNS = 10;     // 性能测试中每种方式的重复次数
+
+const bool enableTextureCompression = true;           // 把纹理压缩为 BC 格式（设备不支持时在 CPU 上解码回 RGBA8）
+const bool enableTextureCache = true;                 // 把压缩结果缓存到 .vtex 文件
+const bool preferBc7ForAlpha = true;                  // 带 alpha 的纹理使用 BC7（关闭时使用 BC3）
+const bool enableTextureCompressionBenchmark = false; // 启动时测试各 BC 格式的压缩速度与质量（只使用 CPU）
+
+const bool enableKtx2Textures = true; // TEXTURE_KTX2_PATH 存在时优先从 KTX2 文件导入纹理
+const bool enableKtx2Export = false;  // 启动时把 TEXTURE_PATH 转换为 KTX2 文件（TEXTURE_KTX2_PATH）
+
+/**
+ *  释放 stb_image 解码得到的像素数据
+ * */
+void freeImagePixels(void *pixels)
+{
+    stbi_image_free(pixels);
+}
+
+/**
+ *  解码图片文件
+ * */
+DecodedImage decodeTextureImage(const std::string &path)
+{
+    DecodedImage image;
+    int texChannels;
+    // 借助 stb_image 库加载图片，并获取其尺寸/通道数等附加信息
+    image.pixels.reset(stbi_load(path.c_str(), &image.width, &image.height, &texChannels, STBI_rgb_alpha));
+    // 验证是否加载成功
+    if (!image.pixels)
+    {
+        throw std::runtime_error("failed to load texture image!");
+    }
+    return image;
+}
+
+/**
+ *  BC 格式对应的 Vulkan 格式（纹理内容均为 sRGB 编码）
+ * */
+VkFormat getBlockCompressedVkFormat(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::BC1:
+        return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+    case BlockFormat::BC3:
+        return VK_FORMAT_BC3_SRGB_BLOCK;
+    case BlockFormat::BC7:
+        return VK_FORMAT_BC7_SRGB_BLOCK;
+    }
+    throw std::invalid_argument("unknown block format!");
+}
+
+/**
+ *  Vulkan 格式对应的 BC 格式，不是块压缩格式时返回 false
+ * */
+bool getBlockFormat(VkFormat format, BlockFormat &blockFormat)
+{
+    switch (format)
+    {
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        blockFormat = BlockFormat::BC1;
+        return true;
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+        blockFormat = BlockFormat::BC3;
+        return true;
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+        blockFormat = BlockFormat::BC7;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ *  由 RGBA8 像素构造未压缩的纹理数据
+ * */
+TextureData makeTextureData(const unsigned char *pixels, int texWidth, int texHeight, bool cpuMipmaps)
+{
+    TextureData texture;
+    texture.format = VK_FORMAT_R8G8B8A8_SRGB;
+    texture.width = static_cast<uint32_t>(texWidth);
+    texture.height = static_cast<uint32_t>(texHeight);
+    texture.mipLevels = computeMipLevelCount(texture.width, texture.height);
+    if (cpuMipmaps)
+    {
+        MipChain chain;
+        buildMipChain(pixels, texture.width, texture.height, chain);
+        texture.data = std::move(chain.data);
+        texture.levels = std::move(chain.levels);
+    }
+    else
+    {
+        // 只有第 0 级，其余级别上传后由 generateMipmaps 生成
+        texture.data.assign(pixels, pixels + size_t(texWidth) * texHeight * 4);
+        texture.levels.assign(1, MipLevel{0, texture.width, texture.height});
+    }
+    return texture;
+}
+
+/**
+ *  由压缩完成的 mip 链构造纹理数据
+ * */
+static TextureData makeCompressedTextureData(CompressedMipChain chain)
+{
+    TextureData texture;
+    texture.format = getBlockCompressedVkFormat(chain.format);
+    texture.width = chain.levels[0].width;
+    texture.height = chain.levels[0].height;
+    texture.mipLevels = static_cast<uint32_t>(chain.levels.size());
+    texture.data = std::move(chain.data);
+    texture.levels = std::move(chain.levels);
+    return texture;
+}
+
+/**
+ *  准备纹理数据：解码、生成 mip 链、块压缩（或读取 .vtex 缓存）
+ * */
+TextureData prepareTextureData(const std::string &path)
+{
+    if (isKtx2Path(path))
+    {
+        return loadKtx2TextureData(path);
+    }
+    if (!enableTextureCompression)
+    {
+        DecodedImage image = decodeTextureImage(path);
+        return makeTextureData(image.pixels.get(), image.width, image.height, enableCpuMipmaps);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // 优先尝试 .vtex 缓存，缓存有效时不需要解码图片
+    MeshSourceKey key;
+    const std::string cachePath = getTextureCachePath(path);
+    if (enableTextureCache)
+    {
+        key = makeMeshSourceKey(path);
+        key.options = preferBc7ForAlpha ? TEXTURE_CACHE_OPTION_BC7 : 0;
+        CompressedMipChain cached;
+        if (readTextureCache(cachePath, key, cached))
+        {
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << "load texture " << path << " from cache " << cachePath << ": "
+                      << getBlockFormatName(cached.format) << " " << cached.levels[0].width << "x" << cached.levels[0].height << ", "
+                      << cached.levels.size() << " levels, " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+            return makeCompressedTextureData(std::move(cached));
+        }
+    }
+
+    // 块压缩作用于每一级，所以 mip 链总是在 CPU 上生成
+    DecodedImage image = decodeTextureImage(path);
+    uint32_t width = static_cast<uint32_t>(image.width);
+    uint32_t height = static_cast<uint32_t>(image.height);
+    MipChain chain;
+    buildMipChain(image.pixels.get(), width, height, chain);
+
+    BlockFormat format = selectBlockFormat(imageHasAlpha(image.pixels.get(), width, height), preferBc7ForAlpha);
+    CompressedMipChain compressed;
+    compressMipChain(format, chain, compressed);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "compress texture " << path << ": " << getBlockFormatName(format) << " " << width << "x" << height << ", "
+              << compressed.levels.size() << " levels, " << chain.data.size() << " -> " << compressed.data.size() << " bytes, "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+    if (enableTextureCache)
+    {
+        // 缓存只是加速手段，写入失败（例如纹理目录只读）不应该影响程序运行
+        try
+        {
+            writeTextureCache(cachePath, key, compressed);
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << e.what() << std::endl;
+        }
+    }
+
+    return makeCompressedTextureData(std::move(compressed));
+}
+
+/**
+ *  映射并校验 KTX2 文件
+ * */
+TextureData loadKtx2TextureData(const std::string &path)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Ktx2Texture ktx2;
+    loadKtx2(path, ktx2);
+
+    TextureData texture;
+    texture.format = ktx2.format;
+    texture.width = ktx2.width;
+    texture.height = ktx2.height;
+    texture.mipLevels = ktx2.mipLevels;
+    texture.levels = std::move(ktx2.levels);
+    texture.fileDataOffset = ktx2.dataOffset;
+    texture.fileDataSize = ktx2.dataSize;
+    texture.file = std::move(ktx2.file);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "load texture " << path << " (KTX2): format " << texture.format << ", " << texture.width << "x" << texture.height << ", "
+              << texture.levels.size() << " levels, " << texture.fileDataSize << " bytes, "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    return texture;
+}
+
+/**
+ *  实际使用的纹理路径
+ * */
+std::string resolveTexturePath()
+{
+    struct stat fileStat;
+    if (enableKtx2Textures && ::stat(TEXTURE_KTX2_PATH.c_str(), &fileStat) == 0)
+    {
+        return TEXTURE_KTX2_PATH;
+    }
+    return TEXTURE_PATH;
+}
+
+/**
+ *  把图片转换为带完整 mip 链的 KTX2 文件
+ * */
+void exportTextureToKtx2(const std::string &sourcePath, const std::string &ktx2Path)
+{
+    TextureData texture = prepareTextureData(sourcePath);
+
+    // KTX2 中保存预先生成的全部级别，加载时不再需要 generateMipmaps()（块压缩数据只能保存已有的级别）
+    BlockFormat sourceBlockFormat;
+    if (texture.levels.size() < texture.mipLevels && getBlockFormat(texture.format, sourceBlockFormat))
+    {
+        texture.mipLevels = static_cast<uint32_t>(texture.levels.size());
+    }
+    if (texture.levels.size() < texture.mipLevels)
+    {
+        MipChain chain;
+        buildMipChain(texture.levelData(), texture.width, texture.height, chain);
+        texture.file.close();
+        texture.data = std::move(chain.data);
+        texture.levels = std::move(chain.levels);
+    }
+
+    writeKtx2(ktx2Path, texture.format, texture.width, texture.height, texture.levelData(), texture.levels);
+    std::cout << "export texture " << sourcePath << " -> " << ktx2Path << ": " << texture.levels.size() << " levels, "
+              << texture.levelDataSize() << " bytes" << std::endl;
+}
+
 /**
  *  创建纹理贴图实例
  * */
 void createTextureImage()
 {
-    int texWidth, texHeight, texChannels;
-    // 借助 stb_image 库加载图片，并获取其尺寸/通道数等附加信息
-    stbi_uc *pixels = stbi_load("../textures/viking_room.png", &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+    uploadTextureData(prepareTextureData(resolveTexturePath()));
+}
 
-    // 初始化 mipmap level
-    mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+/**
+ *  创建 1x1 白色的占位纹理贴图
+ * */
+void createPlaceholderTextureImage()
+{
+    const unsigned char white[4] = {255, 255, 255, 255};
+    uploadTextureImage(white, 1, 1);
+}
 
-    /**
-     *  图像占用内存空间计算
-     * */
-    // 这里的 channel 获取可能有问题，必须默认给4通道才行，而以上获取的channel数总为3，不知为何
-    VkDeviceSize imageSize = texWidth * texHeight * 4;
-    // 验证是否加载成功
-    if (!pixels)
+/**
+ *  使用解码好的 RGBA8 像素创建纹理贴图实例
+ * */
+void uploadTextureImage(const unsigned char *pixels, int texWidth, int texHeight)
+{
+    uploadTextureData(makeTextureData(pixels, texWidth, texHeight, enableCpuMipmaps));
+}
+
+/**
+ *  使用准备好的纹理数据创建纹理贴图实例
+ * */
+void uploadTextureData(TextureData texture)
+{
+    adaptTextureDataToDevice(texture);
+    createTextureImageFromData(texture, textureImage, textureImageMemory);
+
+    // 初始化 mipmap level 与纹理格式（ImageView/采样器使用）
+    mipLevels = texture.mipLevels;
+    textureFormat = texture.format;
+}
+
+/**
+ *  检查图像格式是否支持 vkCmdBlitImage 的线性过滤
+ * */
+bool supportsLinearBlit(VkFormat imageFormat)
+{
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, imageFormat, &formatProperties);
+    return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0;
+}
+
+/**
+ *  检查设备是否支持以某种 BC 格式采样（需要 textureCompressionBC 特性）
+ * */
+bool supportsBlockCompressedFormat(VkFormat imageFormat)
+{
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+    if (!supportedFeatures.textureCompressionBC)
     {
-        throw std::runtime_error("failed to load texture image!");
+        return false;
+    }
+
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, imageFormat, &formatProperties);
+    return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
+/**
+ *  按设备能力调整纹理数据
+ * */
+void adaptTextureDataToDevice(TextureData &texture)
+{
+    // 设备不支持对应的 BC 格式（例如部分移动端 GPU）：在 CPU 上解码回 RGBA8
+    BlockFormat blockFormat;
+    if (getBlockFormat(texture.format, blockFormat) && !supportsBlockCompressedFormat(texture.format))
+    {
+        CompressedMipChain compressed;
+        compressed.format = blockFormat;
+        compressed.data.assign(texture.levelData(), texture.levelData() + texture.levelDataSize());
+        compressed.levels = std::move(texture.levels);
+
+        MipChain chain;
+        decompressMipChain(compressed, chain);
+        texture.file.close();
+        texture.format = VK_FORMAT_R8G8B8A8_SRGB;
+        texture.data = std::move(chain.data);
+        texture.levels = std::move(chain.levels);
+        std::cout << getBlockFormatName(blockFormat) << " textures are not supported by the device, falling back to RGBA8" << std::endl;
+    }
+
+    // 块压缩格式既不能 blit，也不能用 buildMipChain() 在 CPU 上生成，只使用已有的级别
+    if (texture.levels.size() < texture.mipLevels && getBlockFormat(texture.format, blockFormat))
+    {
+        std::cout << "block-compressed texture has " << texture.levels.size() << " of " << texture.mipLevels
+                  << " mip levels, using the stored levels only" << std::endl;
+        texture.mipLevels = static_cast<uint32_t>(texture.levels.size());
+    }
+
+    // 格式不支持线性 blit 时 GPU 路径无法生成 mipmap，此时在 CPU 上生成剩余的级别
+    if (texture.levels.size() < texture.mipLevels && !supportsLinearBlit(texture.format))
+    {
+        MipChain chain;
+        buildMipChain(texture.levelData(), texture.width, texture.height, chain);
+        texture.file.close();
+        texture.data = std::move(chain.data);
+        texture.levels = std::move(chain.levels);
+    }
+}
+
+/**
+ *  由纹理数据创建设备端图像，最终处于 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL 布局
+ * */
+void createTextureImageFromData(const TextureData &texture, VkImage &image, MemoryAllocation &imageMemory)
+{
+    // 缺少的级别需要以第 0 级为源用 vkCmdBlitImage 生成
+    bool blitMipmaps = texture.levels.size() < texture.mipLevels;
+    BlockFormat blockFormat;
+    if (blitMipmaps && getBlockFormat(texture.format, blockFormat))
+    {
+        throw std::runtime_error("cannot generate mipmaps for a block-compressed texture!");
     }
-    /**
-     *  与vertex buffer同样的流程，由于在仅GPU可见内存上访问速度更快，所以我们还是需要借助 staging buffer，先将数据导入
-     * 到CPU可访问的GPU内存区域，再进行 device to device 的数据拷贝。
-     * */
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
-    createBuffer(imageSize,
-                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer,
-                 stagingBufferMemory);
-
-    void *data;
-    vkMapMemory(device, stagingBufferMemory, 0, imageSize, 0, &data);
-    memcpy(data, pixels, static_cast<size_t>(imageSize));
-    vkUnmapMemory(device, stagingBufferMemory);
-    // 将图片数据拷贝到GPU内存上之后就可以直接释放CPU上对图片存储的信息了。
-    stbi_image_free(pixels);
 
     /**
      *  创建图像实例，并为其分配设备内存空间，注意这里我们使用的是 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT，这意味着图像对应
      * 的内存空间将不可被CPU访问，且对于GPU的访问有更高的效率。
+     *  所有级别都从暂存空间拷贝时，图像不需要作为 blit 的源（不需要 VK_IMAGE_USAGE_TRANSFER_SRC_BIT）
      * */
-    createImage(texWidth,
-                texHeight,
-                mipLevels,
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (blitMipmaps)
+    {
+        usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+    createImage(texture.width,
+                texture.height,
+                texture.mipLevels,
                 VK_SAMPLE_COUNT_1_BIT,
-                VK_FORMAT_R8G8B8A8_SRGB,
+                texture.format,
                 VK_IMAGE_TILING_OPTIMAL,
-                VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                usage,
                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                textureImage,
-                textureImageMemory);
+                image,
+                imageMemory);
 
     /**
-     *  由于纹理图像相对较大，拷贝需要花费的时间不可忽略，我们有必要为该部分的拷贝做优化。以下函数将image纹理变换为最适合进行文件
-     * 传输的格式（进行了格式优化）。
+     *  与vertex buffer同样的流程，由于在仅GPU可见内存上访问速度更快，所以我们还是需要借助暂存空间，先将数据导入到CPU可访问
+     * 的环形暂存缓冲区，再进行 device to device 的数据拷贝。从 KTX2 导入时这里直接从映射的文件内容拷贝到暂存空间。
      * */
-    // 将纹理图像转换为VK_image_LAYOUT_TRANSFER_DST_OPTIMAL
-    transitionImageLayout(textureImage,
-                          VK_FORMAT_R8G8B8A8_SRGB,
-                          VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
-    /**
-     *  device to device memory copy
-     * */
-    copyBufferToImage(stagingBuffer,
-                      textureImage,
-                      static_cast<uint32_t>(texWidth),
-                      static_cast<uint32_t>(texHeight));
-
-    // /**
-    //  *  拷贝完成后，将设备端的texture image再转换回最适合GPU读写的形式（之前被转换为了最适合传输的形式）。
-    //  * */
-    // transitionImageLayout(textureImage,
-    //                       VK_FORMAT_R8G8B8A8_SRGB,
-    //                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-    //                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
+    copyMipChainToImage(texture, image);
+
+    if (blitMipmaps)
+    {
+        // generateMipmaps 会把所有级别转换为 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL（录制在拷贝之后，或在暂存批次之后提交）
+        generateMipmaps(image, texture.format, static_cast<int32_t>(texture.width), static_cast<int32_t>(texture.height), texture.mipLevels);
+    }
+}
+
+/**
+ *  经由环形暂存缓冲区把纹理数据中已有的级别拷贝到图像，布局转换与拷贝录制在同一个暂存批次中
+ * */
+void copyMipChainToImage(const TextureData &texture, VkImage image)
+{
+    FormatBlockInfo blockInfo;
+    if (!getFormatBlockInfo(texture.format, blockInfo))
+    {
+        throw std::runtime_error("unsupported texture format for upload!");
+    }
+    // 已有的级别都拷贝完成后直接转换为着色器只读；否则留在 TRANSFER_DST，由 generateMipmaps 继续处理
+    bool complete = texture.levels.size() >= texture.mipLevels;
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = image;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = texture.mipLevels;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    // 所有级别：UNDEFINED -> TRANSFER_DST
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(getStagingCommandBuffer(),
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         0, nullptr,
+                         0, nullptr,
+                         1, &barrier);
 
     /**
-     *  CPU可访问的staging buffer可以直接注销了，连同释放其对应的设备内存
+     *  块压缩格式的 bufferOffset 需要是块大小的整数倍，每一级都由完整的块组成，这里自然满足；
+     * 不足 4x4 的末尾几级 imageExtent 仍然填写实际尺寸（到达图像边缘时允许不是块的整数倍）。
+     *  能放进一次分配的级别合并为一次多 region 的拷贝，超过单次分配上限的级别按块行拆分，可能跨多次提交
      * */
-    vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
+    uploadMipLevelsToImage(image, texture.levelData(), texture.levels,
+                           blockInfo.blockWidth, blockInfo.blockHeight, blockInfo.blockBytes);
+
+    // 拆分时前面的批次已经先提交，按提交顺序在这之前完成；最后把所有级别交给图形队列
+    if (complete)
+    {
+        // 所有级别：TRANSFER_DST -> SHADER_READ_ONLY
+        releaseImageToGraphics(image, barrier.subresourceRange,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    }
+    else if (usesTransferQueue())
+    {
+        /**
+         *  布局不变，只转移所有权，generateMipmaps 在图形队列上读取已有的级别并写入其余级别。
+         *  上传走图形队列时 generateMipmaps 自己的屏障已经覆盖拷贝的写入（release 屏障推迟到批次提交前录制，那时各级别已经
+         * 不在 TRANSFER_DST 布局，不能再录制）
+         * */
+        releaseImageToGraphics(image, barrier.subresourceRange,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+    }
 
-    generateMipmaps(textureImage, VK_FORMAT_R8G8B8A8_SRGB, texWidth, texHeight, mipLevels);
+    // 不等待完成，暂存空间在批次的 fence 触发后回收
+    submitStagingCommands();
 }
 
 /**
@@ -109,7 +498,7 @@ void createTextureImage()
  * */
 void createTextureImageView()
 {
-    textureImageView = createImageView(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
+    textureImageView = createImageView(textureImage, textureFormat, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
 }
 
 /**
@@ -188,15 +577,17 @@ void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int3
 {
 
     // Check if image format supports linear blitting
-    VkFormatProperties formatProperties;
-    vkGetPhysicalDeviceFormatProperties(physicalDevice, imageFormat, &formatProperties);
-
-    if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+    if (!supportsLinearBlit(imageFormat))
     {
         throw std::runtime_error("texture image format does not support linear blitting!");
     }
 
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    /**
+     *  上传走图形队列时 blit 直接录制在当前的上传批次中，与拷贝一起提交；使用传输队列时 blit 只能在图形队列上执行，
+     * 用单次指令提交（开始时会 acquire 刚上传的级别）
+     * */
+    bool batched = !usesTransferQueue();
+    VkCommandBuffer commandBuffer = batched ? getStagingCommandBuffer() : beginSingleTimeCommands();
 
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -278,7 +669,96 @@ void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int3
                          0, nullptr,
                          1, &barrier);
 
-    endSingleTimeCommands(commandBuffer);
+    if (batched)
+    {
+        submitStagingCommands();
+    }
+    else
+    {
+        endSingleTimeCommands(commandBuffer);
+    }
+}
+
+/**
+ *  性能测试：对比 CPU 生成 mip 链 + 一次拷贝上传与 vkCmdBlitImage 逐级生成两种方式
+ * */
+void benchmarkMipmapGeneration()
+{
+    DecodedImage source = decodeTextureImage(TEXTURE_PATH);
+    const unsigned char *pixels = source.pixels.get();
+
+    std::cout << "---------- mipmap generation benchmark (" << TEXTURE_PATH << ", "
+              << source.width << "x" << source.height << ") ----------" << std::endl;
+
+    // 只统计 CPU 端生成 mip 链的耗时
+    MipChain chain;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < MIPMAP_BENCHMARK_RUNS; i++)
+    {
+        buildMipChain(pixels, static_cast<uint32_t>(source.width), static_cast<uint32_t>(source.height), chain);
+    }
+    double buildTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / MIPMAP_BENCHMARK_RUNS;
+
+    // 完整流程：创建图像 + 上传 + 生成 mipmap，每次都等待暂存批次与单次指令完成，所以计时包含 GPU 执行时间
+    auto measure = [&](bool cpuMipmaps)
+    {
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < MIPMAP_BENCHMARK_RUNS; i++)
+        {
+            VkImage image;
+            MemoryAllocation imageMemory;
+            createTextureImageFromData(makeTextureData(pixels, source.width, source.height, cpuMipmaps), image, imageMemory);
+            flushUploadAcquires();
+            waitStagingRingIdle();
+            waitSingleTimeCommandsIdle();
+            vkDestroyImage(device, image, nullptr);
+            freeMemoryAllocation(imageMemory);
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count() / MIPMAP_BENCHMARK_RUNS;
+    };
+
+    double cpuTime = measure(true);
+    std::cout << "    cpu (" << getMipmapKernelName() << ", " << getThreadPool().concurrency() << " threads): "
+              << cpuTime << " ms (mip chain build " << buildTime << " ms)" << std::endl;
+    if (supportsLinearBlit(VK_FORMAT_R8G8B8A8_SRGB))
+    {
+        double blitTime = measure(false);
+        std::cout << "    gpu blit chain: " << blitTime << " ms" << std::endl;
+    }
+    else
+    {
+        std::cout << "    gpu blit chain: unsupported (no linear filtering for VK_FORMAT_R8G8B8A8_SRGB)" << std::endl;
+    }
+}
+
+/**
+ *  性能测试：各 BC 格式压缩整条 mip 链的速度（MPix/s）与质量（PSNR），只使用 CPU
+ * */
+void benchmarkTextureCompression()
+{
+    DecodedImage source = decodeTextureImage(TEXTURE_PATH);
+    MipChain chain;
+    buildMipChain(source.pixels.get(), static_cast<uint32_t>(source.width), static_cast<uint32_t>(source.height), chain);
+    size_t pixelCount = chain.data.size() / 4;
+
+    std::cout << "---------- texture compression benchmark (" << TEXTURE_PATH << ", " << source.width << "x" << source.height
+              << ", " << chain.levels.size() << " levels, " << getThreadPool().concurrency() << " threads) ----------" << std::endl;
+
+    for (BlockFormat format : {BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC7})
+    {
+        CompressedMipChain compressed;
+        auto start = std::chrono::high_resolution_clock::now();
+        compressMipChain(format, chain, compressed);
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        MipChain decoded;
+        decompressMipChain(compressed, decoded);
+
+        std::cout << "    " << getBlockFormatName(format) << ": " << pixelCount / seconds / 1e6 << " MPix/s, PSNR rgb "
+                  << computePsnr(chain.data.data(), decoded.data.data(), pixelCount, 3) << " dB / rgba "
+                  << computePsnr(chain.data.data(), decoded.data.data(), pixelCount, 4) << " dB, "
+                  << chain.data.size() << " -> " << compressed.data.size() << " bytes" << std::endl;
+    }
 }
 
 /**
@@ -292,4 +772,5 @@ void cleanupTextureRelated()
     vkDestroyImageView(device, textureImageView, nullptr);
     // 将 textureImage 释放内存
     vkDestroyImage(device, textureImage, nullptr);
+    freeMemoryAllocation(textureImageMemory);
 }
@@ -1,5 +1,10 @@
 #include "uniform_buffer.h"
 
+#include "vertex_buffer.h"
+#include "bindless_textures.h"
+
+const uint32_t OBJECT_UNIFORM_CAPACITY = 4096;
+
 /**
  * 定义描述符接口，将uniform buffer中mvp变换阵应用到vertex buffer上的接口
  * */
@@ -8,9 +13,17 @@ VkDescriptorPool descriptorPool;             // 创建 descriptorPool
 std::vector<VkDescriptorSet> descriptorSets; // render loop中每帧图片都要有一个 descriptorSet
 
 std::vector<VkBuffer> uniformBuffers;             // render loop 中每一帧图都应该对应一个操作 vertex buffer 的 uniform buffer
-std::vector<VkDeviceMemory> uniformBuffersMemory; // uniform buffer 对应的GPU内存分配
+std::vector<MemoryAllocation> uniformBuffersMemory; // uniform buffer 对应的GPU内存分配
 std::vector<void *> uniformBuffersMapped;         // 这个是做什么的？没有看懂
 
+VkBuffer objectUniformBuffer;             // 物体环形缓冲
+MemoryAllocation objectUniformBufferMemory; // 物体环形缓冲对应的常驻映射内存
+VkDeviceSize objectUniformStride = 0;       // 每个物体槽位的大小
+
+glm::mat4 frameModelMatrix(1.0f); // 当前帧的场景变换阵（不含实例变换）
+glm::mat4 frameViewMatrix(1.0f);  // 当前帧的视口变换阵
+glm::mat4 frameProjMatrix(1.0f);  // 当前帧的投影变换阵
+
 /**
  *  descriptorSetLayout 作为运行时接口，在 draw time 更改变换阵并应用到 graphic pipeline 中。
  * */
@@ -33,8 +46,16 @@ void createDescriptorSetLayout()
     samplerLayoutBinding.pImmutableSamplers = nullptr;
     samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    // 将以上二者整合
-    std::array<VkDescriptorSetLayoutBinding, 2> bindings = {uboLayoutBinding, samplerLayoutBinding};
+    // 配置物体环形缓冲，绑定时通过动态偏移选择物体
+    VkDescriptorSetLayoutBinding objectLayoutBinding{};
+    objectLayoutBinding.binding = 2;
+    objectLayoutBinding.descriptorCount = 1;
+    objectLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    objectLayoutBinding.pImmutableSamplers = nullptr;
+    objectLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    // 将以上三者整合
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings = {uboLayoutBinding, samplerLayoutBinding, objectLayoutBinding};
 
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -66,7 +87,7 @@ void createUniformBuffers()
 
     /**
      *  逐个创建uniform buffer：
-     *  1、注意这里将uniform直接创建在了CPU可访问的内存上，并将其映射到uniformBuffersMapped，没有使用staging buffer
+     *  1、注意这里将uniform直接创建在了CPU可访问的内存上，并将其映射地址记录到uniformBuffersMapped，没有使用staging buffer
      * 作二次映射以及device to device的数据拷贝。
      *  2、注意这里只进行了映射，却没有急着进行数据拷贝，因为真正要拷贝的数据是mvp变换阵，需要等到运行时才能确定。
      * */
@@ -78,8 +99,33 @@ void createUniformBuffers()
                      uniformBuffers[i],
                      uniformBuffersMemory[i]);
 
-        vkMapMemory(device, uniformBuffersMemory[i], 0, bufferSize, 0, &uniformBuffersMapped[i]);
+        // HOST_VISIBLE 的内存块由分配器常驻映射（同一块内存不能映射两次），这里直接取子分配对应的地址
+        uniformBuffersMapped[i] = uniformBuffersMemory[i].mapped;
     }
+
+    /**
+     *  物体环形缓冲：MAX_FRAMES_IN_FLIGHT 段，每段 OBJECT_UNIFORM_CAPACITY 个槽位，同样常驻映射在 CPU 可见的内存上。
+     *  动态偏移必须是 minUniformBufferOffsetAlignment 的整数倍，所以每个槽位按它对齐
+     * */
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    const VkDeviceSize alignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 1);
+    objectUniformStride = (sizeof(ObjectUniforms) + alignment - 1) / alignment * alignment;
+
+    createBuffer(objectUniformStride * OBJECT_UNIFORM_CAPACITY * MAX_FRAMES_IN_FLIGHT,
+                 VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 objectUniformBuffer,
+                 objectUniformBufferMemory);
+    std::cout << "object uniforms: " << OBJECT_UNIFORM_CAPACITY << " objects per frame, " << objectUniformStride << " bytes per object" << std::endl;
+}
+
+/**
+ *  物体在本帧物体环形缓冲段中的动态偏移（每帧的描述符集已经指向各自的一段）
+ * */
+uint32_t getObjectUniformOffset(uint32_t object)
+{
+    return static_cast<uint32_t>(object * objectUniformStride);
 }
 
 /**
@@ -103,9 +149,9 @@ void updateUniformBuffer(uint32_t currentImage)
         使用glm::rotate函数对图形进行“旋转”操作，time * glm::radians(90.0f)保证每秒旋转90度（这里
     应该对应的是沿图形的 y 轴坐标进行旋转），注意这里进行的是 M -> 模型变换阵
     */
-    // ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    // model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
     // 如果想让模型转动稍微缓慢一点可以对这里的角度进行修改
-    ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(45.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    glm::mat4 model = glm::rotate(glm::mat4(1.0f), time * glm::radians(45.0f), glm::vec3(0.0f, 0.0f, 1.0f));
 
     /*
         视口变换阵相关操作：以下的操作使得我们并非沿着正冲着表面的方向观察，而是在其斜上方45度的位置进行观察，
@@ -130,10 +176,28 @@ void updateUniformBuffer(uint32_t currentImage)
     */
     ubo.proj[1][1] *= -1;
 
+    // 记录本帧的变换阵，供 CPU 端的 LOD 选择与簇剔除使用（CPU 端剔除在模型空间中进行，不涉及紧凑顶点格式的反量化）
+    frameModelMatrix = model;
+    frameViewMatrix = ubo.view;
+    frameProjMatrix = ubo.proj;
+
     /*
         因为没有使用staging buffer，这里省略掉一步映射，可以直接将数据拷贝到开辟好的CPU可访问的GPU内存地址，如下：
     */
     memcpy(uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+
+    /*
+        每个物体的模型变换写入物体环形缓冲中本帧的一段（该帧的 fence 已经等待过，GPU 不再读取这一段）。
+    目前所有物体共用同一个场景变换，各物体需要独立运动时只需要在这里写入不同的变换。物体数量在
+    createInstanceBuffer() 中已经检查过不超过 OBJECT_UNIFORM_CAPACITY。
+    */
+    uint8_t *objectUniforms = static_cast<uint8_t *>(objectUniformBufferMemory.mapped) + objectUniformStride * OBJECT_UNIFORM_CAPACITY * currentImage;
+    for (size_t object = 0; object < modelMeshes.size(); object++)
+    {
+        ObjectUniforms uniforms{};
+        uniforms.model = model;
+        memcpy(objectUniforms + objectUniformStride * object, &uniforms, sizeof(ObjectUniforms));
+    }
 }
 
 /**
@@ -143,11 +207,13 @@ void updateUniformBuffer(uint32_t currentImage)
  * */
 void createDescriptorPool()
 {
-    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    std::array<VkDescriptorPoolSize, 3> poolSizes{};
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     poolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     poolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    poolSizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[2].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -193,8 +259,13 @@ void createDescriptorSets()
         imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         imageInfo.imageView = textureImageView;
         imageInfo.sampler = textureSampler;
+        // 动态 uniform buffer 指向物体环形缓冲中本帧的一段，range 为单个物体的数据块
+        VkDescriptorBufferInfo objectBufferInfo{};
+        objectBufferInfo.buffer = objectUniformBuffer;
+        objectBufferInfo.offset = objectUniformStride * OBJECT_UNIFORM_CAPACITY * i;
+        objectBufferInfo.range = sizeof(ObjectUniforms);
 
-        std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+        std::array<VkWriteDescriptorSet, 3> descriptorWrites{};
 
         descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         descriptorWrites[0].dstSet = descriptorSets[i];
@@ -212,6 +283,14 @@ void createDescriptorSets()
         descriptorWrites[1].descriptorCount = 1;
         descriptorWrites[1].pImageInfo = &imageInfo;
 
+        descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[2].dstSet = descriptorSets[i];
+        descriptorWrites[2].dstBinding = 2;
+        descriptorWrites[2].dstArrayElement = 0;
+        descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrites[2].descriptorCount = 1;
+        descriptorWrites[2].pBufferInfo = &objectBufferInfo;
+
         vkUpdateDescriptorSets(device,
                                static_cast<uint32_t>(descriptorWrites.size()),
                                descriptorWrites.data(),
@@ -220,6 +299,37 @@ void createDescriptorSets()
     }
 }
 
+/**
+ *  纹理贴图被替换后（例如后台加载完成），让所有描述符集指向新的 textureImageView/textureSampler
+ *  调用前需要保证 GPU 不再使用这些描述符集
+ * */
+void updateTextureDescriptors()
+{
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = textureImageView;
+        imageInfo.sampler = textureSampler;
+
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = descriptorSets[i];
+        descriptorWrite.dstBinding = 1;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+    }
+
+    if (bindlessTexturesActive)
+    {
+        writeBindlessTexture(BINDLESS_MAIN_TEXTURE, textureImageView, textureSampler);
+    }
+}
+
 /**
  *  注销 uniform buffer 并释放其对应的GPU内存
  * */
@@ -228,8 +338,10 @@ void cleanupUniformBuffer()
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
     {
         vkDestroyBuffer(device, uniformBuffers[i], nullptr);
-        vkFreeMemory(device, uniformBuffersMemory[i], nullptr);
+        freeMemoryAllocation(uniformBuffersMemory[i]);
     }
+    vkDestroyBuffer(device, objectUniformBuffer, nullptr);
+    freeMemoryAllocation(objectUniformBufferMemory);
 }
 
 /**
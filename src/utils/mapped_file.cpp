@@ -0,0 +1,88 @@
+#include "utils/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ *  以只读方式映射整个文件
+ * */
+MappedFile::MappedFile(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("failed to open file: " + path);
+    }
+
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("failed to stat file: " + path);
+    }
+
+    mappedSize = static_cast<size_t>(fileStat.st_size);
+    opened = true;
+
+    // 空文件无法映射，直接当作长度为 0 的数据处理
+    if (mappedSize > 0)
+    {
+        void *address = ::mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("failed to map file: " + path);
+        }
+        mapped = address;
+        // 解析基本上是顺序读取，提示内核提前预读
+        ::madvise(mapped, mappedSize, MADV_SEQUENTIAL);
+        ::madvise(mapped, mappedSize, MADV_WILLNEED);
+    }
+
+    // 映射建立后文件描述符就可以关闭了，映射本身仍然有效
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : mapped(other.mapped), mappedSize(other.mappedSize), opened(other.opened)
+{
+    other.mapped = nullptr;
+    other.mappedSize = 0;
+    other.opened = false;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        mapped = other.mapped;
+        mappedSize = other.mappedSize;
+        opened = other.opened;
+        other.mapped = nullptr;
+        other.mappedSize = 0;
+        other.opened = false;
+    }
+    return *this;
+}
+
+/**
+ *  解除映射
+ * */
+void MappedFile::close()
+{
+    if (mapped != nullptr)
+    {
+        ::munmap(mapped, mappedSize);
+    }
+    mapped = nullptr;
+    mappedSize = 0;
+    opened = false;
+}
@@ -0,0 +1,167 @@
+#include "utils/thread_pool.h"
+
+/**
+ *  创建工作线程
+ * */
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        size_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ *  通知所有工作线程退出，并等待其结束
+ * */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        stopping = true;
+    }
+    jobsCondition.notify_all();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ *  工作线程主循环：不断从任务队列中取出任务执行
+ * */
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobsMutex);
+            jobsCondition.wait(lock, [this]
+                               { return stopping || !jobs.empty(); });
+            if (stopping && jobs.empty())
+            {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+/**
+ *  投递一个异步任务，没有工作线程时直接在调用线程执行
+ * */
+void ThreadPool::enqueue(std::function<void()> job)
+{
+    if (workers.empty())
+    {
+        job();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        jobs.push_back(std::move(job));
+    }
+    jobsCondition.notify_one();
+}
+
+/**
+ *  对 [0, taskCount) 中的每个下标执行一次 task
+ *  所有参与的线程（包括调用线程）通过一个原子计数器领取下标，完成后由调用线程统一等待。
+ * */
+void ThreadPool::parallelFor(size_t taskCount, const std::function<void(size_t)> &task)
+{
+    if (taskCount == 0)
+    {
+        return;
+    }
+    if (taskCount == 1 || workers.empty())
+    {
+        for (size_t i = 0; i < taskCount; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    // 共享状态放在堆上：迟到的工作线程即使在调用返回后才被调度，也只会看到“已经没有下标可领取”
+    struct SharedState
+    {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> finished{0};
+        size_t count = 0;
+        const std::function<void(size_t)> *task = nullptr;
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<SharedState>();
+    state->count = taskCount;
+    state->task = &task;
+
+    auto run = [state]()
+    {
+        size_t index;
+        while ((index = state->next.fetch_add(1)) < state->count)
+        {
+            try
+            {
+                (*state->task)(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(state->doneMutex);
+                if (!state->error)
+                {
+                    state->error = std::current_exception();
+                }
+            }
+            if (state->finished.fetch_add(1) + 1 == state->count)
+            {
+                std::lock_guard<std::mutex> lock(state->doneMutex);
+                state->doneCondition.notify_all();
+            }
+        }
+    };
+
+    size_t helperCount = std::min(workers.size(), taskCount - 1);
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        for (size_t i = 0; i < helperCount; i++)
+        {
+            jobs.push_back(run);
+        }
+    }
+    jobsCondition.notify_all();
+
+    // 调用线程同样参与计算
+    run();
+
+    std::unique_lock<std::mutex> lock(state->doneMutex);
+    state->doneCondition.wait(lock, [&state]
+                              { return state->finished.load() == state->count; });
+
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+}
+
+/**
+ *  获取全局共享的线程池（首次调用时创建）
+ * */
+ThreadPool &getThreadPool()
+{
+    static ThreadPool pool;
+    return pool;
+}
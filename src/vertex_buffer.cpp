@@ -23,61 +23,198 @@ const std::string MODEL_PATH = "../models/viking_room.obj";
 
 // const std::vector<uint16_t> indices = {0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4};
 
-// 我们从 model 中导入顶点相关的数据，而非写死在内存中
-std::vector<Vertex> vertices;
-std::vector<uint32_t> indices;
+// 是否在导入模型前运行 tinyobj 与多线程解析器的对比测试
+const bool enableModelLoadBenchmark = false;
+
+// 是否在导入模型前运行顶点去重的微基准测试
+const bool enableDedupBenchmark = false;
+
+// 是否对大模型使用并行分片去重，以及启用并行去重的最小角点数量（小模型上线程调度的开销得不偿失）
+const bool enableParallelDedup = true;
+const size_t PARALLEL_DEDUP_MIN_CORNERS = 1 << 18;
+
+// 是否在模型导入后做顶点缓存/顶点获取顺序优化
+const bool enableMeshOptimization = true;
+
+// 是否对模型做簇划分，并在每帧绘制前进行视锥/背面剔除
+const bool enableMeshletCulling = true;
+
+// 是否为模型生成 LOD 链，并在每帧根据投影到屏幕上的误差选择 LOD
+const bool enableMeshLod = true;
+
+// 是否在生成 LOD 后逐级计算实际误差（原始顶点到简化表面的最大距离，暴力计算，大模型上很慢）
+const bool enableLodErrorValidation = false;
+
+// LOD1、LOD2... 相对 LOD0 的目标三角形比例
+const std::vector<float> LOD_TRIANGLE_RATIOS = {0.5f, 0.25f, 0.125f};
+
+// 每一级简化允许的最大误差（相对模型包围盒对角线的一半）
+const float LOD_MAX_RELATIVE_ERROR = 0.02f;
+
+// 投影到屏幕上的误差不超过这么多像素时才会使用更粗糙的 LOD
+const float LOD_PIXEL_ERROR_THRESHOLD = 1.0f;
+
+// 模型使用的顶点格式，修改后构建时会嵌入对应的顶点着色器
+const VertexFormat MODEL_VERTEX_FORMAT = VERTEX_FORMAT_PACKED;
+
+// 是否使用 .vmesh 二进制缓存（命中时跳过 OBJ 解析与顶点去重）
+const bool enableMeshCache = true;
+
+// 我们从 model 中导入顶点相关的数据，而非写死在内存中；场景中的每个模型对应一个网格，共用同一个 vertex/index buffer
+std::vector<ModelMesh> modelMeshes;
 
 VkBuffer vertexBuffer;             // vertex buffer 实例
-VkDeviceMemory vertexBufferMemory; // vertex buffer 对应在 GPU device 上的内存
+MemoryAllocation vertexBufferMemory; // vertex buffer 对应在 GPU device 上的内存
 
 VkBuffer indexBuffer;             // index buffer 实例
-VkDeviceMemory indexBufferMemory; // index buffer 对应在 GPU device 上的内存
+MemoryAllocation indexBufferMemory; // index buffer 对应在 GPU device 上的内存
+
+/**
+ *  各顶点格式对应的顶点大小
+ * */
+uint32_t getVertexStride(VertexFormat format)
+{
+    return format == VERTEX_FORMAT_FLOAT ? sizeof(Vertex) : PackedVertex::getStride(format);
+}
+
+/**
+ *  计算一组顶点的量化参数（位置与 UV 的包围盒）
+ * */
+MeshQuantization computeMeshQuantization(const Vertex *source, size_t count, VertexFormat format)
+{
+    MeshQuantization quantization{};
+    if (format == VERTEX_FORMAT_FLOAT)
+    {
+        return quantization;
+    }
+
+    // 计算位置与 UV 的包围盒
+    glm::vec3 positionMin(std::numeric_limits<float>::max()), positionMax(-std::numeric_limits<float>::max());
+    glm::vec2 texCoordMin(std::numeric_limits<float>::max()), texCoordMax(-std::numeric_limits<float>::max());
+    for (size_t i = 0; i < count; i++)
+    {
+        positionMin = glm::min(positionMin, source[i].pos);
+        positionMax = glm::max(positionMax, source[i].pos);
+        texCoordMin = glm::min(texCoordMin, source[i].texCoord);
+        texCoordMax = glm::max(texCoordMax, source[i].texCoord);
+    }
+    if (count == 0)
+    {
+        positionMin = positionMax = glm::vec3(0.0f);
+        texCoordMin = texCoordMax = glm::vec2(0.0f);
+    }
+
+    // 包围盒某个方向厚度为 0（例如平面）时缩放取 1，避免除零
+    quantization.positionOffset = positionMin;
+    quantization.positionScale = positionMax - positionMin;
+    quantization.texCoordOffset = texCoordMin;
+    quantization.texCoordScale = texCoordMax - texCoordMin;
+    for (int k = 0; k < 3; k++)
+    {
+        quantization.positionScale[k] = quantization.positionScale[k] > 0.0f ? quantization.positionScale[k] : 1.0f;
+    }
+    for (int k = 0; k < 2; k++)
+    {
+        quantization.texCoordScale[k] = quantization.texCoordScale[k] > 0.0f ? quantization.texCoordScale[k] : 1.0f;
+    }
+    return quantization;
+}
+
+/**
+ *  按给定的量化参数把 Vertex 写为紧凑格式
+ * */
+void packVertices(const Vertex *source, size_t count, VertexFormat format, const MeshQuantization &quantization, void *destination)
+{
+    if (format == VERTEX_FORMAT_FLOAT)
+    {
+        memcpy(destination, source, sizeof(Vertex) * count);
+        return;
+    }
+
+    const glm::vec3 positionInvScale = 1.0f / quantization.positionScale;
+    const glm::vec2 texCoordInvScale = 1.0f / quantization.texCoordScale;
+    const uint32_t stride = PackedVertex::getStride(format);
+    char *out = static_cast<char *>(destination);
+    for (size_t i = 0; i < count; i++)
+    {
+        PackedVertex packed{};
+        glm::vec3 position = (source[i].pos - quantization.positionOffset) * positionInvScale;
+        glm::vec2 texCoord = (source[i].texCoord - quantization.texCoordOffset) * texCoordInvScale;
+        packed.pos[0] = quantizeUnorm16(position.x);
+        packed.pos[1] = quantizeUnorm16(position.y);
+        packed.pos[2] = quantizeUnorm16(position.z);
+        packed.pos[3] = 0;
+        packed.texCoord[0] = quantizeUnorm16(texCoord.x);
+        packed.texCoord[1] = quantizeUnorm16(texCoord.y);
+        packed.color[0] = quantizeUnorm8(source[i].color.x);
+        packed.color[1] = quantizeUnorm8(source[i].color.y);
+        packed.color[2] = quantizeUnorm8(source[i].color.z);
+        packed.color[3] = 255;
+        memcpy(out + i * stride, &packed, stride);
+    }
+}
+
+/**
+ *  将 Vertex 量化为紧凑格式
+ * */
+void quantizeVertices(const Vertex *source, size_t count, VertexFormat format, void *destination, MeshQuantization &quantization)
+{
+    // 1、计算位置与 UV 的包围盒
+    quantization = computeMeshQuantization(source, count, format);
+    // 2、量化并按对应步长写出
+    packVertices(source, count, format, quantization, destination);
+}
 
 /**
  *  GPU上创建 Vertex Buffer，并导入顶点数据
  * */
 void createVertexBuffer()
 {
-    VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
+    /*
+        每种顶点格式对应一条图形管线，网格按各自的格式选择管线；所有网格共用一个 vertex buffer（绑定偏移为 0），
+    vertexOffset 以管线的顶点大小为单位，所以每个网格的起始字节偏移需要按自己的顶点大小向上对齐。
+    */
+    VkDeviceSize bufferSize = 0;
+    for (ModelMesh &mesh : modelMeshes)
+    {
+        if (mesh.vertexFormat >= VERTEX_FORMAT_COUNT)
+        {
+            throw std::runtime_error("unknown mesh vertex format: " + mesh.path);
+        }
+        const VkDeviceSize stride = getVertexStride(mesh.vertexFormat);
+        VkDeviceSize baseVertex = (bufferSize + stride - 1) / stride;
+        mesh.baseVertex = static_cast<uint32_t>(baseVertex);
+        mesh.pipeline = static_cast<uint32_t>(mesh.vertexFormat);
+        bufferSize = (baseVertex + mesh.vertexCount) * stride;
+    }
     /**
      *  GPU上访问较快的内存类型CPU无法直接访问到，所以这里我们不能“一步到位”的方式去从CPU直接将数据拷贝到这块GPU
      * 内存。合理的方式是：
-     *  1、先在GPU上创建一个Buffer，并为其分配一块CPU可访问的内存空间作为“中间桥”。
-     *  2、将源数据从CPU拷贝到以上Buffer对应的中。
-     *  3、在GPU上创建一个Buffer,并为其分配一块CPU无法访问的内存（最终数据存储的位置，方便GPU快速访问，但CPU无法访问）。
-     *  4、将1、中创建的内存中的数据以 device to device 的方式拷贝到3、创建的内存区域。
-     *  5、注销1、创建的Buffer，并释放其对应的内存区域。
+     *  1、在GPU上创建一个Buffer,并为其分配一块CPU无法访问的内存（最终数据存储的位置，方便GPU快速访问，但CPU无法访问）。
+     *  2、从常驻映射的环形暂存缓冲区中分配CPU可访问的空间作为“中间桥”，把源数据写入其中。
+     *  3、以 device to device 的方式把暂存空间中的数据拷贝到1、创建的内存区域（不等待完成，暂存空间由 fence 回收）。
      * */
-
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
-    // 1、在GPU上创建一个Buffer，并为其分配一块CPU可访问的内存空间作为“中间桥”。
-    createBuffer(bufferSize,
-                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer,
-                 stagingBufferMemory);
-
-    // 2、将源数据从CPU拷贝到以上Buffer对应的中。
-    void *data;
-    vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, vertices.data(), (size_t)bufferSize);
-    vkUnmapMemory(device, stagingBufferMemory);
-
-    // 3、在GPU上创建一个Buffer,并为其分配一块CPU无法访问的内存（最终数据存储的位置，方便GPU快速访问，但CPU无法访问）。
     createBuffer(bufferSize,
                  VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                  vertexBuffer,
                  vertexBufferMemory);
 
-    // 4、将1、中创建的内存中的数据以 device to device 的方式拷贝到3、创建的内存区域。
-    copyBuffer(stagingBuffer, vertexBuffer, bufferSize);
-
-    // 5、注销1、创建的Buffer，并释放其对应的内存区域。
-    vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
+    for (ModelMesh &mesh : modelMeshes)
+    {
+        // 紧凑格式：量化结果直接写入暂存空间，不需要中间数组；每个网格使用各自的量化参数（按整个网格计算，分段写入时保持一致）
+        const Vertex *source = mesh.vertexData();
+        const VertexFormat format = mesh.vertexFormat;
+        mesh.quantization = computeMeshQuantization(source, mesh.vertexCount, format);
+        const MeshQuantization &quantization = mesh.quantization;
+        const uint32_t stride = getVertexStride(format);
+        uploadElementsToBuffer(vertexBuffer, static_cast<VkDeviceSize>(stride) * mesh.baseVertex, mesh.vertexCount, stride,
+                               [source, format, &quantization](void *destination, size_t first, size_t count)
+                               {
+                                   packVertices(source + first, count, format, quantization, destination);
+                               });
+    }
+    submitStagingCommands();
 }
 
 /**
@@ -85,20 +222,13 @@ void createVertexBuffer()
  * */
 void createIndexBuffer()
 {
-    VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(bufferSize,
-                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                 stagingBuffer,
-                 stagingBufferMemory);
-
-    void *data;
-    vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, indices.data(), (size_t)bufferSize);
-    vkUnmapMemory(device, stagingBufferMemory);
+    uint32_t totalIndexCount = 0;
+    for (ModelMesh &mesh : modelMeshes)
+    {
+        mesh.firstIndex = totalIndexCount;
+        totalIndexCount += mesh.indexCount;
+    }
+    VkDeviceSize bufferSize = sizeof(uint32_t) * totalIndexCount;
 
     createBuffer(bufferSize,
                  VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
@@ -106,10 +236,11 @@ void createIndexBuffer()
                  indexBuffer,
                  indexBufferMemory);
 
-    copyBuffer(stagingBuffer, indexBuffer, bufferSize);
-
-    vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
+    for (const ModelMesh &mesh : modelMeshes)
+    {
+        uploadToBuffer(indexBuffer, sizeof(uint32_t) * mesh.firstIndex, mesh.indexData(), sizeof(uint32_t) * mesh.indexCount);
+    }
+    submitStagingCommands();
 }
 
 /**
@@ -118,7 +249,7 @@ void createIndexBuffer()
 void cleanupVertexBuffer()
 {
     vkDestroyBuffer(device, vertexBuffer, nullptr);
-    vkFreeMemory(device, vertexBufferMemory, nullptr);
+    freeMemoryAllocation(vertexBufferMemory);
 }
 
 /**
@@ -127,15 +258,15 @@ void cleanupVertexBuffer()
 void cleanupIndexBuffer()
 {
     vkDestroyBuffer(device, indexBuffer, nullptr);
-    vkFreeMemory(device, indexBufferMemory, nullptr);
+    freeMemoryAllocation(indexBufferMemory);
 }
 
 /******************************************** 以下是模型导入部分 ********************************************/
 
 /**
- *  模型文件导入
+ *  使用 tinyobj 导入模型文件（原始实现，现在仅作为基准测试的参照）
  * */
-void loadModel()
+void loadModelWithTinyObj(const std::string &path, std::vector<Vertex> &outVertices, std::vector<uint32_t> &outIndices)
 {
 
     tinyobj::attrib_t attrib;
@@ -148,7 +279,7 @@ void loadModel()
         以下使用 attrib 字段作为v/vn/vt三者的存储器，并使用attrib中的vertices/normals/texcoords
     几个字段分别指示；使用 shapes 字段作为f的存储器。
     */
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, MODEL_PATH.c_str()))
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str()))
     {
         // 内置报错信息，如果有错误会自动抛出对应提示信息
         throw std::runtime_error(warn + err);
@@ -225,21 +356,485 @@ void loadModel()
                 attrib.vertices[3 * index.vertex_index + 1],
                 attrib.vertices[3 * index.vertex_index + 2]};
 
-            // UV贴图坐标
-            vertex.texCoord = {
-                attrib.texcoords[2 * index.texcoord_index + 0],
-                1.0f - attrib.texcoords[2 * index.texcoord_index + 1]};
+            // UV贴图坐标（bunny.obj 之类的模型没有 vt 字段，此时 texcoord_index 为 -1）
+            if (index.texcoord_index >= 0)
+            {
+                vertex.texCoord = {
+                    attrib.texcoords[2 * index.texcoord_index + 0],
+                    1.0f - attrib.texcoords[2 * index.texcoord_index + 1]};
+            }
 
             // 顶点对应颜色（预设为常量）
             vertex.color = {1.0f, 1.0f, 1.0f};
 
             if (uniqueVertices.count(vertex) == 0)
             {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.push_back(vertex);
+                uniqueVertices[vertex] = static_cast<uint32_t>(outVertices.size());
+                outVertices.push_back(vertex);
             }
 
-            indices.push_back(uniqueVertices[vertex]);
+            outIndices.push_back(uniqueVertices[vertex]);
+        }
+    }
+}
+
+/**
+ *  由 OBJ 中的一个角点构造 Vertex
+ * */
+static inline Vertex makeObjVertex(const ObjMesh &mesh, const ObjIndex &index)
+{
+    Vertex vertex{};
+
+    vertex.pos = {
+        mesh.vertices[3 * index.vertex_index + 0],
+        mesh.vertices[3 * index.vertex_index + 1],
+        mesh.vertices[3 * index.vertex_index + 2]};
+
+    // 没有 vt 字段的模型纹理坐标保持为 0
+    if (index.texcoord_index >= 0)
+    {
+        vertex.texCoord = {
+            mesh.texcoords[2 * index.texcoord_index + 0],
+            1.0f - mesh.texcoords[2 * index.texcoord_index + 1]};
+    }
+
+    vertex.color = {1.0f, 1.0f, 1.0f};
+
+    return vertex;
+}
+
+/**
+ *  使用 mmap + 多线程 OBJ 解析器导入模型文件
+ * */
+void loadModelFromFile(const std::string &path, std::vector<Vertex> &outVertices, std::vector<uint32_t> &outIndices)
+{
+    ObjMesh mesh;
+    parseObjFile(path, mesh);
+
+    /*
+        解析器输出的 ObjIndex 与 tinyobj::index_t 含义相同，且所有面已按文件顺序拼接，所以这里的去重逻辑与
+    上面 tinyobj 版本一致（新顶点按首次出现的顺序编号），得到的 vertices/indices 也完全相同。
+        去重使用开放寻址表代替 std::unordered_map，表容量按角点数量预先分配，每个角点只做一次哈希与一次探测。
+    */
+    if (enableParallelDedup && mesh.indices.size() >= PARALLEL_DEDUP_MIN_CORNERS)
+    {
+        // 大模型使用并行分片去重，输出与下面的串行版本完全一致
+        parallelDeduplicateVertices<Vertex>(
+            mesh.indices.size(), [&mesh](size_t i)
+            { return makeObjVertex(mesh, mesh.indices[i]); },
+            outVertices, outIndices);
+        return;
+    }
+
+    VertexDedupTable<Vertex> uniqueVertices(mesh.indices.size());
+    outIndices.reserve(outIndices.size() + mesh.indices.size());
+
+    for (const auto &index : mesh.indices)
+    {
+        outIndices.push_back(uniqueVertices.findOrInsert(makeObjVertex(mesh, index), outVertices));
+    }
+}
+
+/**
+ *  导入一个模型网格
+ * */
+void loadModelMesh(const std::string &path, ModelMesh &mesh)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    mesh.path = path;
+
+    /*
+        优先尝试 .vmesh 缓存：缓存有效时只需要 mmap 缓存文件，顶点/索引数据在 createVertexBuffer()/createIndexBuffer()
+    中直接从映射内存拷贝到暂存缓冲区。
+    */
+    MeshSourceKey key;
+    const std::string cachePath = getMeshCachePath(path);
+    if (enableMeshCache)
+    {
+        key = makeMeshSourceKey(path);
+        key.options = (enableMeshOptimization ? MESH_CACHE_OPTION_OPTIMIZED : 0) | (enableMeshLod ? MESH_CACHE_OPTION_LOD : 0);
+        if (mesh.cache.open(cachePath, key, sizeof(Vertex)))
+        {
+            mesh.vertexCount = static_cast<uint32_t>(mesh.cache.vertexCount());
+            mesh.indexCount = static_cast<uint32_t>(mesh.cache.indexCount());
+            mesh.lods.assign(mesh.cache.lodData(), mesh.cache.lodData() + mesh.cache.lodCount());
+
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << "load model " << path << " from cache " << cachePath << ": "
+                      << mesh.vertexCount << " vertices, " << mesh.indexCount << " indices, " << mesh.lods.size() << " LODs, "
+                      << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+            computeMeshBounds(mesh);
+            buildMeshMeshlets(mesh);
+            return;
+        }
+    }
+
+    loadModelFromFile(path, mesh.vertices, mesh.indices);
+    if (enableMeshOptimization)
+    {
+        optimizeModelMesh(mesh.vertices, mesh.indices);
+    }
+    if (enableMeshLod)
+    {
+        generateModelLods(mesh.vertices, mesh.indices, mesh.lods);
+    }
+    else
+    {
+        mesh.lods.assign(1, MeshLod{0, static_cast<uint32_t>(mesh.indices.size()), 0.0f, 0});
+    }
+    mesh.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    mesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "load model " << path << ": "
+              << mesh.vertexCount << " vertices, " << mesh.indexCount << " indices, " << mesh.lods.size() << " LODs, "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+    if (enableMeshCache)
+    {
+        // 缓存只是加速手段，写入失败（例如模型目录只读）不应该影响程序运行
+        try
+        {
+            MeshCache::write(cachePath, key, mesh.vertices.data(), mesh.vertices.size(), sizeof(Vertex),
+                             mesh.indices.data(), mesh.indices.size(), mesh.lods.data(), mesh.lods.size());
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << e.what() << std::endl;
+        }
+    }
+
+    computeMeshBounds(mesh);
+    buildMeshMeshlets(mesh);
+}
+
+/**
+ *  计算网格在模型空间下的包围球
+ * */
+void computeMeshBounds(ModelMesh &mesh)
+{
+    const Vertex *vertexData = mesh.vertexData();
+    if (mesh.vertexCount == 0)
+    {
+        mesh.boundingSphere = glm::vec4(0.0f);
+        return;
+    }
+    glm::vec3 minimum(std::numeric_limits<float>::max()), maximum(-std::numeric_limits<float>::max());
+    for (uint32_t v = 0; v < mesh.vertexCount; v++)
+    {
+        minimum = glm::min(minimum, vertexData[v].pos);
+        maximum = glm::max(maximum, vertexData[v].pos);
+    }
+    glm::vec3 center = (minimum + maximum) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (uint32_t v = 0; v < mesh.vertexCount; v++)
+    {
+        glm::vec3 d = vertexData[v].pos - center;
+        radiusSquared = std::max(radiusSquared, glm::dot(d, d));
+    }
+    mesh.boundingSphere = glm::vec4(center, std::sqrt(radiusSquared));
+}
+
+/**
+ *  由 LOD0 逐级简化生成 LOD 链
+ * */
+void generateModelLods(const std::vector<Vertex> &meshVertices, std::vector<uint32_t> &meshIndices, std::vector<MeshLod> &lods)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const size_t lod0IndexCount = meshIndices.size();
+    lods.assign(1, MeshLod{0, static_cast<uint32_t>(lod0IndexCount), 0.0f, 0});
+    if (meshVertices.empty() || lod0IndexCount == 0)
+    {
+        return;
+    }
+
+    glm::vec3 minimum(std::numeric_limits<float>::max()), maximum(-std::numeric_limits<float>::max());
+    for (const Vertex &vertex : meshVertices)
+    {
+        minimum = glm::min(minimum, vertex.pos);
+        maximum = glm::max(maximum, vertex.pos);
+    }
+    glm::vec3 diagonal = maximum - minimum;
+    const float maxError = LOD_MAX_RELATIVE_ERROR * 0.5f * std::sqrt(glm::dot(diagonal, diagonal));
+
+    /*
+        每一级都从上一级简化而来，代价远小于每次都从 LOD0 开始。各级的折叠关系逐级复合为 LOD0 顶点 -> 当前级别
+    顶点的映射，每一级的误差上界都直接相对 LOD0 计算（折叠代价只是均方根估计，逐级相加也不是上界）。
+    */
+    std::vector<uint32_t> previous(meshIndices.begin(), meshIndices.end());
+    std::vector<uint32_t> simplified;
+    std::vector<uint32_t> lodRemap(meshVertices.size()), levelRemap;
+    for (size_t v = 0; v < lodRemap.size(); v++)
+    {
+        lodRemap[v] = static_cast<uint32_t>(v);
+    }
+    for (float ratio : LOD_TRIANGLE_RATIOS)
+    {
+        const size_t targetIndexCount = static_cast<size_t>(lod0IndexCount / 3 * ratio) * 3;
+        simplifyMesh(&meshVertices[0].pos.x, sizeof(Vertex), meshVertices.size(),
+                     previous.data(), previous.size(), targetIndexCount, maxError, simplified, &levelRemap);
+
+        // 误差上限或被锁定的接缝/边界顶点使得网格无法继续明显简化时，LOD 链到此为止
+        if (simplified.empty() || simplified.size() * 10 > previous.size() * 9)
+        {
+            break;
+        }
+
+        for (uint32_t &target : lodRemap)
+        {
+            target = levelRemap[target];
+        }
+        float error = boundSimplificationError(&meshVertices[0].pos.x, sizeof(Vertex), meshVertices.size(),
+                                               meshIndices.data(), lod0IndexCount, simplified.data(), simplified.size(), lodRemap);
+
+        optimizeVertexCache(simplified, meshVertices.size());
+        lods.push_back(MeshLod{static_cast<uint32_t>(meshIndices.size()), static_cast<uint32_t>(simplified.size()),
+                               std::max(lods.back().error, error), 0});
+        meshIndices.insert(meshIndices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "generate LODs: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    for (size_t i = 0; i < lods.size(); i++)
+    {
+        std::cout << "  LOD" << i << ": " << lods[i].indexCount / 3 << " triangles, error " << lods[i].error;
+        if (enableLodErrorValidation && i > 0)
+        {
+            float measured = measureSimplificationError(&meshVertices[0].pos.x, sizeof(Vertex), meshVertices.size(),
+                                                        meshIndices.data(), lod0IndexCount,
+                                                        meshIndices.data() + lods[i].indexOffset, lods[i].indexCount);
+            std::cout << " (measured " << measured << ")" << std::endl;
+            // LOD 选择把 error 当作上界使用，实测误差超过它说明上界的计算有误
+            if (measured > lods[i].error * 1.0001f + 1e-6f)
+            {
+                throw std::runtime_error("LOD" + std::to_string(i) + " error exceeds its stored bound!");
+            }
+            continue;
+        }
+        std::cout << std::endl;
+    }
+}
+
+/**
+ *  对网格的每个 LOD 级别做簇划分
+ * */
+void buildMeshMeshlets(ModelMesh &mesh)
+{
+    mesh.meshlets.clear();
+    mesh.lodMeshletOffsets.clear();
+    if (!enableMeshletCulling)
+    {
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // 每个 LOD 级别单独划分，簇的索引区间换算为网格索引数据中的位置
+    const Vertex *vertexData = mesh.vertexData();
+    const uint32_t *indexData = mesh.indexData();
+    std::vector<Meshlet> lodMeshlets;
+    for (const MeshLod &lod : mesh.lods)
+    {
+        mesh.lodMeshletOffsets.push_back(static_cast<uint32_t>(mesh.meshlets.size()));
+        buildMeshlets(&vertexData[0].pos.x, sizeof(Vertex), mesh.vertexCount, indexData + lod.indexOffset, lod.indexCount, lodMeshlets);
+        for (Meshlet &meshlet : lodMeshlets)
+        {
+            meshlet.indexOffset += lod.indexOffset;
+            mesh.meshlets.push_back(meshlet);
+        }
+    }
+    mesh.lodMeshletOffsets.push_back(static_cast<uint32_t>(mesh.meshlets.size()));
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "build meshlets: " << mesh.meshlets.size() << " meshlets (max " << MESHLET_MAX_VERTICES << " vertices / "
+              << MESHLET_MAX_TRIANGLES << " triangles), "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+}
+
+/**
+ *  顶点缓存/顶点获取顺序优化，并输出优化前后的 ACMR/ATVR
+ * */
+void optimizeModelMesh(std::vector<Vertex> &meshVertices, std::vector<uint32_t> &meshIndices)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    VertexCacheStatistics before = analyzeVertexCache(meshIndices, meshVertices.size());
+
+    // 先重排三角形，再按新的三角形顺序重排顶点（顶点重排不会改变缓存命中情况）
+    optimizeVertexCache(meshIndices, meshVertices.size());
+    optimizeVertexFetch(meshVertices, meshIndices);
+
+    VertexCacheStatistics after = analyzeVertexCache(meshIndices, meshVertices.size());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "mesh optimization (cache size " << VERTEX_CACHE_SIZE << "): "
+              << "ACMR " << before.acmr << " -> " << after.acmr << ", "
+              << "ATVR " << before.atvr << " -> " << after.atvr << ", "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+}
+
+/**
+ *  对比 tinyobj 与 mmap + 多线程解析器的模型导入耗时
+ * */
+void benchmarkModelLoading()
+{
+    const std::vector<std::string> paths = {"../models/bunny.obj", "../models/viking_room.obj"};
+    const int runs = 5;
+
+    std::cout << "---------- model loading benchmark (" << getThreadPool().concurrency() << " threads) ----------" << std::endl;
+    for (const auto &path : paths)
+    {
+        double tinyobjTime = 0.0, parserTime = 0.0;
+        std::vector<Vertex> tinyobjVertices, parserVertices;
+        std::vector<uint32_t> tinyobjIndices, parserIndices;
+
+        for (int i = 0; i < runs; i++)
+        {
+            tinyobjVertices.clear();
+            tinyobjIndices.clear();
+            auto start = std::chrono::high_resolution_clock::now();
+            loadModelWithTinyObj(path, tinyobjVertices, tinyobjIndices);
+            auto end = std::chrono::high_resolution_clock::now();
+            tinyobjTime += std::chrono::duration<double, std::milli>(end - start).count();
+
+            parserVertices.clear();
+            parserIndices.clear();
+            start = std::chrono::high_resolution_clock::now();
+            loadModelFromFile(path, parserVertices, parserIndices);
+            end = std::chrono::high_resolution_clock::now();
+            parserTime += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        if (tinyobjVertices.size() != parserVertices.size() || tinyobjIndices != parserIndices)
+        {
+            throw std::runtime_error("model loading benchmark: results mismatch for " + path);
+        }
+
+        std::cout << path << ": "
+                  << parserVertices.size() << " vertices, " << parserIndices.size() << " indices" << std::endl
+                  << "    tinyobj: " << tinyobjTime / runs << " ms" << std::endl
+                  << "    parser:  " << parserTime / runs << " ms" << std::endl
+                  << "    speedup: " << tinyobjTime / parserTime << "x" << std::endl;
+    }
+}
+
+/**
+ *  分别使用 std::unordered_map、VertexDedupTable 与并行分片去重对 corners 去重，输出吞吐量（顶点/秒）并校验结果一致
+ * */
+static void benchmarkDedupOn(const std::string &name, const std::vector<Vertex> &corners)
+{
+    const int runs = 5;
+    double mapTime = 0.0, tableTime = 0.0;
+    std::vector<Vertex> mapVertices, tableVertices;
+    std::vector<uint32_t> mapIndices, tableIndices;
+
+    for (int i = 0; i < runs; i++)
+    {
+        mapVertices.clear();
+        mapIndices.clear();
+        auto start = std::chrono::high_resolution_clock::now();
+        std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+        for (const auto &vertex : corners)
+        {
+            if (uniqueVertices.count(vertex) == 0)
+            {
+                uniqueVertices[vertex] = static_cast<uint32_t>(mapVertices.size());
+                mapVertices.push_back(vertex);
+            }
+            mapIndices.push_back(uniqueVertices[vertex]);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        mapTime += std::chrono::duration<double>(end - start).count();
+
+        tableVertices.clear();
+        tableIndices.clear();
+        start = std::chrono::high_resolution_clock::now();
+        VertexDedupTable<Vertex> table(corners.size());
+        tableIndices.reserve(corners.size());
+        for (const auto &vertex : corners)
+        {
+            tableIndices.push_back(table.findOrInsert(vertex, tableVertices));
+        }
+        end = std::chrono::high_resolution_clock::now();
+        tableTime += std::chrono::duration<double>(end - start).count();
+    }
+
+    double parallelTime = 0.0;
+    std::vector<Vertex> parallelVertices;
+    std::vector<uint32_t> parallelIndices;
+    for (int i = 0; i < runs; i++)
+    {
+        parallelVertices.clear();
+        parallelIndices.clear();
+        auto start = std::chrono::high_resolution_clock::now();
+        parallelDeduplicateVertices<Vertex>(
+            corners.size(), [&corners](size_t k)
+            { return corners[k]; },
+            parallelVertices, parallelIndices);
+        auto end = std::chrono::high_resolution_clock::now();
+        parallelTime += std::chrono::duration<double>(end - start).count();
+    }
+
+    if (mapIndices != tableIndices || mapVertices.size() != tableVertices.size() ||
+        parallelIndices != tableIndices || std::memcmp(parallelVertices.data(), tableVertices.data(), sizeof(Vertex) * tableVertices.size()) != 0)
+    {
+        throw std::runtime_error("vertex dedup benchmark: results mismatch for " + name);
+    }
+
+    double vertexCount = static_cast<double>(corners.size()) * runs;
+    std::cout << name << ": " << corners.size() << " corners -> " << tableVertices.size() << " vertices" << std::endl
+              << "    unordered_map:    " << vertexCount / mapTime / 1e6 << " M vertices/s" << std::endl
+              << "    VertexDedupTable: " << vertexCount / tableTime / 1e6 << " M vertices/s" << std::endl
+              << "    parallel (" << getThreadPool().concurrency() << " threads): " << vertexCount / parallelTime / 1e6 << " M vertices/s" << std::endl
+              << "    speedup: " << mapTime / tableTime << "x (table), " << mapTime / parallelTime << "x (parallel)" << std::endl;
+}
+
+/**
+ *  顶点去重微基准测试
+ * */
+void benchmarkVertexDedup()
+{
+    std::cout << "---------- vertex dedup benchmark ----------" << std::endl;
+
+    // 真实模型：每个角点展开成一个 Vertex
+    const std::vector<std::string> paths = {"../models/bunny.obj", "../models/viking_room.obj", "../models/fish.obj"};
+    for (const auto &path : paths)
+    {
+        ObjMesh mesh;
+        parseObjFile(path, mesh);
+        std::vector<Vertex> corners;
+        corners.reserve(mesh.indices.size());
+        for (const auto &index : mesh.indices)
+        {
+            corners.push_back(makeObjVertex(mesh, index));
+        }
+        benchmarkDedupOn(path, corners);
+    }
+
+    // 规则网格：整数坐标的平面网格，std::hash<Vertex> 在这类数据上冲突最严重；尺寸取到千万级角点以观察并行扩展性
+    const int gridSize = 1536;
+    std::vector<Vertex> corners;
+    corners.reserve(static_cast<size_t>(gridSize) * gridSize * 6);
+    auto gridVertex = [](int x, int y)
+    {
+        Vertex vertex{};
+        vertex.pos = {static_cast<float>(x), static_cast<float>(y), 0.0f};
+        vertex.color = {1.0f, 1.0f, 1.0f};
+        vertex.texCoord = {static_cast<float>(x) / gridSize, static_cast<float>(y) / gridSize};
+        return vertex;
+    };
+    for (int y = 0; y < gridSize; y++)
+    {
+        for (int x = 0; x < gridSize; x++)
+        {
+            corners.push_back(gridVertex(x, y));
+            corners.push_back(gridVertex(x + 1, y));
+            corners.push_back(gridVertex(x + 1, y + 1));
+            corners.push_back(gridVertex(x + 1, y + 1));
+            corners.push_back(gridVertex(x, y + 1));
+            corners.push_back(gridVertex(x, y));
         }
     }
+    benchmarkDedupOn("grid " + std::to_string(gridSize) + "x" + std::to_string(gridSize), corners);
 }
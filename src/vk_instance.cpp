@@ -42,7 +42,8 @@ void createInstance()
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "No Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    // 1.2 起 timeline semaphore 成为核心功能（专用传输队列的上传需要它），设备不支持 1.2 时上传退回图形队列
+    appInfo.apiVersion = VK_API_VERSION_1_2;
 
     // 自定义 vulkan instance 相关信息
     VkInstanceCreateInfo createInfo{};
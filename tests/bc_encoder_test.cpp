@@ -0,0 +1,129 @@
+#include "image/bc_encoder.h"
+#include "utils/thread_pool.h"
+
+#include "test_utils.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+/*
+    只使用 CPU 验证 BC1/BC3/BC7 编码器：合成图像的压缩速度（MPix/s）与质量（PSNR），以及常量块的往返误差。
+*/
+
+// 合成图像上各格式 RGB PSNR 的下限（dB）
+const double BC1_MIN_PSNR = 40.0;
+const double BC3_MIN_PSNR = 40.0;
+const double BC7_MIN_PSNR = 46.0;
+
+const uint32_t TEST_IMAGE_SIZE = 256;
+
+/**
+ *  合成的测试图像：RGB 为平滑的二维渐变叠加低频的正弦起伏，alpha 沿对角线渐变
+ * */
+static std::vector<uint8_t> makeGradientImage(uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> pixels(size_t(width) * height * 4);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            float u = float(x) / float(width - 1), v = float(y) / float(height - 1);
+            float wave = 0.5f + 0.5f * std::sin(6.2831853f * (u * 2.0f + v));
+            uint8_t *p = &pixels[(size_t(y) * width + x) * 4];
+            p[0] = static_cast<uint8_t>(std::lround(255.0f * u));
+            p[1] = static_cast<uint8_t>(std::lround(255.0f * v));
+            p[2] = static_cast<uint8_t>(std::lround(255.0f * (0.25f + 0.5f * wave)));
+            p[3] = static_cast<uint8_t>(std::lround(255.0f * 0.5f * (u + v)));
+        }
+    }
+    return pixels;
+}
+
+/**
+ *  压缩整幅图像，输出速度与 PSNR，并检查 PSNR 不低于下限
+ * */
+static void testImageQuality(BlockFormat format, double minPsnr)
+{
+    const uint32_t size = TEST_IMAGE_SIZE;
+    std::vector<uint8_t> pixels = makeGradientImage(size, size);
+    std::vector<uint8_t> blocks(getCompressedSize(format, size, size));
+    std::vector<uint8_t> decoded(pixels.size());
+
+    // 第一次压缩用于预热线程池，计时取后几次的平均值
+    compressImage(format, pixels.data(), size, size, blocks.data());
+    const int runs = 4;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < runs; i++)
+    {
+        compressImage(format, pixels.data(), size, size, blocks.data());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / runs;
+
+    decompressImage(format, blocks.data(), size, size, decoded.data());
+    const size_t pixelCount = size_t(size) * size;
+    double rgbPsnr = computePsnr(pixels.data(), decoded.data(), pixelCount, 3);
+    double rgbaPsnr = computePsnr(pixels.data(), decoded.data(), pixelCount, 4);
+
+    std::cout << "    " << getBlockFormatName(format) << ": " << pixelCount / seconds / 1e6 << " MPix/s, PSNR rgb "
+              << rgbPsnr << " dB / rgba " << rgbaPsnr << " dB (" << getThreadPool().concurrency() << " threads)" << std::endl;
+    EXPECT(rgbPsnr >= minPsnr);
+}
+
+/**
+ *  常量颜色块编码再解码后，每个通道与原值相差不超过 1（BC1 不保存 alpha，只比较 RGB）
+ * */
+static void testConstantBlocks(BlockFormat format)
+{
+    const uint8_t colors[][4] = {
+        {0, 0, 0, 255},
+        {255, 255, 255, 255},
+        {128, 128, 128, 255},
+        {1, 254, 127, 255},
+        {37, 201, 99, 255},
+        {200, 13, 250, 128},
+        {91, 92, 93, 17},
+    };
+    const uint32_t channels = format == BlockFormat::BC1 ? 3 : 4;
+    for (const uint8_t *color : colors)
+    {
+        uint8_t pixels[64], decoded[64];
+        for (int i = 0; i < 16; i++)
+        {
+            std::memcpy(&pixels[i * 4], color, 4);
+        }
+        uint8_t block[16];
+        encodeBlock(format, pixels, block);
+        decodeBlock(format, block, decoded);
+
+        int maxDifference = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            for (uint32_t c = 0; c < channels; c++)
+            {
+                maxDifference = std::max(maxDifference, std::abs(int(decoded[i * 4 + c]) - int(color[c])));
+            }
+        }
+        if (maxDifference > 1)
+        {
+            std::cout << "    " << getBlockFormatName(format) << ": constant block (" << int(color[0]) << ", " << int(color[1]) << ", "
+                      << int(color[2]) << ", " << int(color[3]) << ") decoded with error " << maxDifference << std::endl;
+        }
+        EXPECT(maxDifference <= 1);
+    }
+}
+
+int main()
+{
+    std::cout << "bc encoder (" << TEST_IMAGE_SIZE << "x" << TEST_IMAGE_SIZE << " gradient):" << std::endl;
+    testImageQuality(BlockFormat::BC1, BC1_MIN_PSNR);
+    testImageQuality(BlockFormat::BC3, BC3_MIN_PSNR);
+    testImageQuality(BlockFormat::BC7, BC7_MIN_PSNR);
+
+    for (BlockFormat format : {BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC7})
+    {
+        testConstantBlocks(format);
+    }
+
+    return finishTests("bc encoder");
+}
@@ -0,0 +1,219 @@
+#include "buffers/memory_allocator.h"
+
+#include "test_utils.h"
+
+#include <map>
+
+/*
+    用伪造的内存属性表与回调单独验证 TlsfBlock 与 DeviceMemoryAllocator，不需要 Vulkan 设备。
+    memory_allocator.cpp 中渲染器使用的全局函数引用了下面两个对象，这里只提供定义，测试中不会用到。
+*/
+VkDevice device = VK_NULL_HANDLE;
+VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+
+/**
+ *  伪造的设备内存：按计数生成句柄，映射时用 malloc 的内存代替
+ * */
+struct FakeDeviceMemory
+{
+    uint64_t nextHandle = 1;
+    std::map<uint64_t, std::vector<uint8_t>> blocks;
+    uint32_t allocateCalls = 0;
+    VkDeviceSize failAbove = ~VkDeviceSize(0); // 大于这个大小的申请返回 VK_ERROR_OUT_OF_DEVICE_MEMORY
+
+    DeviceMemoryCallbacks callbacks()
+    {
+        DeviceMemoryCallbacks result;
+        result.allocate = [this](uint32_t, VkDeviceSize size, VkDeviceMemory &memory)
+        {
+            allocateCalls++;
+            if (size > failAbove)
+            {
+                return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+            }
+            uint64_t handle = nextHandle++;
+            blocks[handle].resize(static_cast<size_t>(std::min<VkDeviceSize>(size, 4096)));
+            memory = reinterpret_cast<VkDeviceMemory>(handle);
+            return VK_SUCCESS;
+        };
+        result.free = [this](VkDeviceMemory memory)
+        {
+            blocks.erase(reinterpret_cast<uint64_t>(memory));
+        };
+        // 只映射前 4KB，测试只比较返回的地址
+        result.map = [this](VkDeviceMemory memory, VkDeviceSize) -> void *
+        {
+            return blocks[reinterpret_cast<uint64_t>(memory)].data();
+        };
+        return result;
+    }
+};
+
+/**
+ *  类型 0 为 DEVICE_LOCAL（8GB 堆），类型 1 为 HOST_VISIBLE（256MB 堆，块大小为堆的 1/8）
+ * */
+static VkPhysicalDeviceMemoryProperties makeMemoryProperties()
+{
+    VkPhysicalDeviceMemoryProperties properties{};
+    properties.memoryHeapCount = 2;
+    properties.memoryHeaps[0].size = 8ull * 1024 * 1024 * 1024;
+    properties.memoryHeaps[1].size = 256ull * 1024 * 1024;
+    properties.memoryTypeCount = 2;
+    properties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    properties.memoryTypes[0].heapIndex = 0;
+    properties.memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    properties.memoryTypes[1].heapIndex = 1;
+    return properties;
+}
+
+static VkMemoryRequirements makeRequirements(VkDeviceSize size, VkDeviceSize alignment)
+{
+    VkMemoryRequirements requirements{};
+    requirements.size = size;
+    requirements.alignment = alignment;
+    requirements.memoryTypeBits = 0x3;
+    return requirements;
+}
+
+/**
+ *  整块恰好放下一个请求：大小不在类别边界上时 findFree() 的向上取整会跳过唯一的空闲区间
+ * */
+static void testTlsfExactFit()
+{
+    const VkDeviceSize sizes[] = {1000, 1024, 900000, 1048576, 3000000, 134217729, 265420800};
+    for (VkDeviceSize size : sizes)
+    {
+        TlsfBlock block(size);
+        VkDeviceSize offset = 1;
+        uint32_t node = UINT32_MAX;
+        EXPECT(block.allocate(size, 1, offset, node));
+        EXPECT(offset == 0);
+        EXPECT(node != UINT32_MAX);
+        EXPECT(block.usedBytes() == size);
+
+        VkDeviceSize otherOffset;
+        uint32_t otherNode;
+        EXPECT(!block.allocate(1, 1, otherOffset, otherNode));
+
+        block.free(node);
+        EXPECT(block.empty());
+        EXPECT(block.allocate(size, 1, offset, node));
+    }
+}
+
+/**
+ *  分配、对齐与释放后的合并
+ * */
+static void testTlsfAllocateFree()
+{
+    TlsfBlock block(1024 * 1024);
+    std::vector<uint32_t> nodes;
+    std::vector<VkDeviceSize> offsets;
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        VkDeviceSize offset;
+        uint32_t node;
+        EXPECT(block.allocate(1000 + i * 37, 256, offset, node));
+        EXPECT(offset % 256 == 0);
+        for (size_t j = 0; j < offsets.size(); j++)
+        {
+            EXPECT(offset != offsets[j]);
+        }
+        nodes.push_back(node);
+        offsets.push_back(offset);
+    }
+
+    // 隔一个释放一个，再全部释放，最后整块应该重新合并为一个空闲区间
+    for (size_t i = 0; i < nodes.size(); i += 2)
+    {
+        block.free(nodes[i]);
+    }
+    for (size_t i = 1; i < nodes.size(); i += 2)
+    {
+        block.free(nodes[i]);
+    }
+    EXPECT(block.empty());
+
+    MemoryStats stats;
+    block.addStats(stats);
+    EXPECT(stats.freeRangeCount == 1);
+    EXPECT(stats.largestFreeRange == 1024 * 1024);
+}
+
+/**
+ *  超过块大小一半的资源使用 dedicated 块，释放后立即归还
+ * */
+static void testDedicatedAllocations()
+{
+    FakeDeviceMemory memory;
+    DeviceMemoryAllocator allocator(makeMemoryProperties(), 1, memory.callbacks());
+
+    const VkDeviceSize sizes[] = {134217729, 265420800, 3000000000ull};
+    for (VkDeviceSize size : sizes)
+    {
+        MemoryAllocation allocation = allocator.allocate(makeRequirements(size, 256), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceTiling::Linear);
+        EXPECT(allocation.offset == 0);
+        EXPECT(allocation.node != UINT32_MAX);
+        EXPECT(allocator.getStats().dedicatedCount == 1);
+        allocator.free(allocation);
+        EXPECT(allocation.pool == UINT32_MAX);
+        EXPECT(allocator.getStats().blockCount == 0);
+    }
+
+    // HOST_VISIBLE 类型的块大小为 32MB，超过 16MB 的资源单独分配并直接给出映射地址
+    MemoryAllocation mapped = allocator.allocate(makeRequirements(20000000, 64), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, ResourceTiling::Linear);
+    EXPECT(mapped.mapped != nullptr);
+    EXPECT(allocator.getStats(1).dedicatedCount == 1);
+    allocator.free(mapped);
+    EXPECT(memory.blocks.empty());
+}
+
+/**
+ *  普通分配共用内存块；显存不足时退回更小的块，新块大小恰好等于请求时也要能放下
+ * */
+static void testBlockAllocations()
+{
+    FakeDeviceMemory memory;
+    DeviceMemoryAllocator allocator(makeMemoryProperties(), 1, memory.callbacks());
+
+    std::vector<MemoryAllocation> allocations;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        allocations.push_back(allocator.allocate(makeRequirements(900000, 256), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, ResourceTiling::Linear));
+        EXPECT(allocations.back().offset % 256 == 0);
+        EXPECT(allocations.back().mapped != nullptr);
+    }
+    MemoryStats stats = allocator.getStats(1);
+    EXPECT(stats.allocationCount == 100);
+    EXPECT(stats.dedicatedCount == 0);
+    EXPECT(stats.blockCount == 3);
+    for (MemoryAllocation &allocation : allocations)
+    {
+        allocator.free(allocation);
+    }
+    // 释放后保留一个空块作为缓冲
+    EXPECT(allocator.getStats(1).blockCount == 1);
+    EXPECT(allocator.getStats(1).allocationCount == 0);
+
+    // 只能申请 64MB 的块时，64MB 的请求（不在类别边界上时同样）应该放在恰好等大的块中
+    FakeDeviceMemory limited;
+    limited.failAbove = 64ull * 1024 * 1024;
+    DeviceMemoryAllocator limitedAllocator(makeMemoryProperties(), 1, limited.callbacks());
+    const VkDeviceSize sizes[] = {64ull * 1024 * 1024, 64ull * 1024 * 1024 - 1000};
+    for (VkDeviceSize size : sizes)
+    {
+        MemoryAllocation allocation = limitedAllocator.allocate(makeRequirements(size, 4096), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceTiling::Optimal);
+        EXPECT(allocation.offset == 0);
+        limitedAllocator.free(allocation);
+    }
+}
+
+int main()
+{
+    testTlsfExactFit();
+    testTlsfAllocateFree();
+    testDedicatedAllocations();
+    testBlockAllocations();
+
+    return finishTests("memory allocator");
+}
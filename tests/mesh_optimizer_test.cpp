@@ -0,0 +1,134 @@
+#include "model/mesh_optimizer.h"
+
+#include "test_utils.h"
+#include "test_models.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+/*
+    验证顶点缓存/顶点获取优化：
+    1、analyzeVertexCache 在手工计算过的小例子上给出准确的 ACMR/ATVR；
+    2、optimizeVertexCache（Tipsify）只改变三角形的顺序，并在真实模型上降低 ACMR；
+    3、optimizeVertexFetchRemap 按首次引用的顺序给顶点编号，未被引用的顶点映射为 0xFFFFFFFF。
+*/
+
+// 优化后 bunny_low_resolution.obj 的 ACMR 上限（缓存大小为 VERTEX_CACHE_SIZE，优化前约为 2.26）
+const double OPTIMIZED_BUNNY_MAX_ACMR = 0.75;
+
+static bool nearlyEqual(double a, double b)
+{
+    return std::abs(a - b) < 1e-9;
+}
+
+/**
+ *  4 个三角形的条带加上一个回头引用已被挤出的顶点的三角形，缓存大小为 3
+ * */
+static void testAnalyzeVertexCache()
+{
+    /*
+        FIFO 缓存（大小 3）的变化：
+        (0, 1, 2)：0/1/2 未命中                      [0 1 2]  3 次
+        (2, 1, 3)：3 未命中，挤出 0                   [1 2 3]  4 次
+        (2, 3, 4)：4 未命中，挤出 1                   [2 3 4]  5 次
+        (4, 3, 5)：5 未命中，挤出 2                   [3 4 5]  6 次
+        条带部分 ACMR = 6 / 4 = 1.5，ATVR = 6 / 6 = 1.0
+        (0, 1, 5)：0 挤出 3，1 挤出 4，5 命中          [5 0 1]  8 次
+        整体 ACMR = 8 / 5 = 1.6，ATVR = 8 / 6（顶点 6、7 未被引用，不计入）
+    */
+    std::vector<uint32_t> strip = {0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5};
+    VertexCacheStatistics statistics = analyzeVertexCache(strip, 8, 3);
+    EXPECT(statistics.transformedVertices == 6);
+    EXPECT(nearlyEqual(statistics.acmr, 1.5));
+    EXPECT(nearlyEqual(statistics.atvr, 1.0));
+
+    std::vector<uint32_t> indices = strip;
+    indices.insert(indices.end(), {0, 1, 5});
+    statistics = analyzeVertexCache(indices, 8, 3);
+    EXPECT(statistics.transformedVertices == 8);
+    EXPECT(nearlyEqual(statistics.acmr, 8.0 / 5.0));
+    EXPECT(nearlyEqual(statistics.atvr, 8.0 / 6.0));
+
+    // 缓存足够大时每个顶点只变换一次
+    statistics = analyzeVertexCache(indices, 8, 16);
+    EXPECT(statistics.transformedVertices == 6);
+    EXPECT(nearlyEqual(statistics.atvr, 1.0));
+}
+
+/**
+ *  三角形按旋转到最小下标在前的形式（保持环绕方向）排序，用于比较两组索引是否包含相同的三角形
+ * */
+static std::vector<std::array<uint32_t, 3>> sortedTriangles(const std::vector<uint32_t> &indices)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        std::array<uint32_t, 3> triangle = {indices[i], indices[i + 1], indices[i + 2]};
+        while (triangle[0] > triangle[1] || triangle[0] > triangle[2])
+        {
+            std::rotate(triangle.begin(), triangle.begin() + 1, triangle.end());
+        }
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+/**
+ *  Tipsify 在真实模型上只重排三角形，并降低 ACMR
+ * */
+static void testOptimizeVertexCache()
+{
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    loadTestModel("bunny_low_resolution.obj", positions, indices);
+    const size_t vertexCount = positions.size() / 3;
+
+    std::vector<uint32_t> optimized = indices;
+    optimizeVertexCache(optimized, vertexCount);
+    EXPECT(optimized.size() == indices.size());
+    EXPECT(sortedTriangles(optimized) == sortedTriangles(indices));
+
+    VertexCacheStatistics before = analyzeVertexCache(indices, vertexCount);
+    VertexCacheStatistics after = analyzeVertexCache(optimized, vertexCount);
+    std::cout << "    bunny_low_resolution.obj: ACMR " << before.acmr << " -> " << after.acmr
+              << ", ATVR " << before.atvr << " -> " << after.atvr << std::endl;
+    EXPECT(after.acmr < before.acmr);
+    EXPECT(after.acmr <= OPTIMIZED_BUNNY_MAX_ACMR);
+}
+
+/**
+ *  顶点按首次被引用的顺序编号，未被引用的顶点映射为 0xFFFFFFFF
+ * */
+static void testOptimizeVertexFetchRemap()
+{
+    std::vector<uint32_t> indices = {5, 2, 5, 7, 2, 0};
+    std::vector<uint32_t> remap;
+    size_t referenced = optimizeVertexFetchRemap(indices, 9, remap);
+    EXPECT(referenced == 4);
+    EXPECT(remap.size() == 9);
+
+    const uint32_t expected[9] = {3, 0xFFFFFFFFu, 1, 0xFFFFFFFFu, 0xFFFFFFFFu, 0, 0xFFFFFFFFu, 2, 0xFFFFFFFFu};
+    for (size_t v = 0; v < remap.size() && v < 9; v++)
+    {
+        EXPECT(remap[v] == expected[v]);
+    }
+    EXPECT((indices == std::vector<uint32_t>{0, 1, 0, 2, 1, 3}));
+
+    // optimizeVertexFetch 按同样的映射搬移顶点并删除未被引用的顶点
+    std::vector<int> vertices = {10, 11, 12, 13, 14, 15, 16, 17, 18};
+    indices = {5, 2, 5, 7, 2, 0};
+    optimizeVertexFetch(vertices, indices);
+    EXPECT((vertices == std::vector<int>{15, 12, 17, 10}));
+}
+
+int main()
+{
+    std::cout << "mesh optimizer:" << std::endl;
+    testAnalyzeVertexCache();
+    testOptimizeVertexCache();
+    testOptimizeVertexFetchRemap();
+
+    return finishTests("mesh optimizer");
+}
@@ -0,0 +1,97 @@
+#include "model/simplifier.h"
+
+#include "test_utils.h"
+#include "test_models.h"
+
+#include <cmath>
+#include <limits>
+
+/*
+    在真实模型上逐级简化（与 generateModelLods() 相同，每一级从上一级简化，折叠关系逐级复合），验证：
+    1、每一级的三角形数量不超过目标；
+    2、boundSimplificationError 给出的误差确实是上界，不小于暴力计算的 measureSimplificationError；
+    3、selectMeshLod 选择的级别随距离单调不减。
+*/
+
+const float LOD_CHAIN_RATIOS[] = {0.5f, 0.25f, 0.125f};
+
+/**
+ *  生成 LOD 链并检查每一级的三角形数量与误差上界，返回包含 LOD0 的各级 MeshLod（只有 error 有意义）
+ * */
+static std::vector<MeshLod> testLodChain(const std::string &name)
+{
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    loadTestModel(name, positions, indices);
+    const size_t vertexCount = positions.size() / 3;
+    const size_t stride = 3 * sizeof(float);
+    std::cout << "    " << name << ": " << vertexCount << " vertices, " << indices.size() / 3 << " triangles" << std::endl;
+
+    std::vector<MeshLod> lods(1, MeshLod{0, static_cast<uint32_t>(indices.size()), 0.0f, 0});
+    std::vector<uint32_t> previous = indices, simplified, levelRemap;
+    std::vector<uint32_t> lodRemap(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        lodRemap[v] = static_cast<uint32_t>(v);
+    }
+    for (float ratio : LOD_CHAIN_RATIOS)
+    {
+        // 不限制误差，只按三角形数量停止
+        const size_t targetIndexCount = static_cast<size_t>(indices.size() / 3 * ratio) * 3;
+        simplifyMesh(positions.data(), stride, vertexCount, previous.data(), previous.size(),
+                     targetIndexCount, std::numeric_limits<float>::max(), simplified, &levelRemap);
+        EXPECT(!simplified.empty());
+        EXPECT(simplified.size() % 3 == 0);
+        EXPECT(simplified.size() <= targetIndexCount);
+
+        for (uint32_t &target : lodRemap)
+        {
+            target = levelRemap[target];
+        }
+        float bound = boundSimplificationError(positions.data(), stride, vertexCount, indices.data(), indices.size(),
+                                               simplified.data(), simplified.size(), lodRemap);
+        float measured = measureSimplificationError(positions.data(), stride, vertexCount, indices.data(), indices.size(),
+                                                    simplified.data(), simplified.size());
+        std::cout << "      " << ratio * 100.0f << "%: " << simplified.size() / 3 << " triangles (target " << targetIndexCount / 3
+                  << "), bound " << bound << ", measured " << measured << std::endl;
+        // 与 enableLodErrorValidation 相同，只容忍浮点舍入
+        EXPECT(bound * 1.0001f + 1e-6f >= measured);
+
+        // 与 generateModelLods() 一致，存储的误差取各级上界的最大值
+        lods.push_back(MeshLod{0, static_cast<uint32_t>(simplified.size()), std::max(lods.back().error, bound), 0});
+        previous.swap(simplified);
+    }
+    return lods;
+}
+
+/**
+ *  距离从近到远扫描，选择的 LOD 级别不能变细
+ * */
+static void testLodSelection(const std::vector<MeshLod> &lods)
+{
+    const float pixelsPerUnit = 1000.0f;
+    const float pixelThreshold = 1.0f;
+    uint32_t previous = 0;
+    for (float distance = 1e-3f; distance < 1e5f; distance *= 1.05f)
+    {
+        uint32_t selected = selectMeshLod(lods.data(), lods.size(), distance, pixelsPerUnit, pixelThreshold);
+        EXPECT(selected < lods.size());
+        EXPECT(selected >= previous);
+        previous = selected;
+    }
+    // 足够近时使用原始网格，足够远时使用最粗的级别
+    EXPECT(selectMeshLod(lods.data(), lods.size(), 1e-3f, pixelsPerUnit, pixelThreshold) == 0);
+    EXPECT(previous == lods.size() - 1);
+}
+
+int main()
+{
+    std::cout << "simplifier:" << std::endl;
+    for (const char *name : {"bunny_low_resolution.obj", "bird.obj"})
+    {
+        std::vector<MeshLod> lods = testLodChain(name);
+        testLodSelection(lods);
+    }
+
+    return finishTests("simplifier");
+}
@@ -0,0 +1,36 @@
+#ifndef TEST_MODELS_H
+#define TEST_MODELS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "model/obj_parser.h"
+
+/*
+    Introduction：
+    需要真实模型的测试直接读取 models 目录下的 OBJ 文件（目录由 CMake 通过 MODEL_DIR 传入），只使用顶点位置：
+    每个 v 字段是一个顶点，索引为各面角点的 v 下标，不经过 Vertex 与去重。
+*/
+
+#ifndef MODEL_DIR
+#define MODEL_DIR "../models"
+#endif
+
+/**
+ *  读取 models 目录下的模型，positions 每个顶点 3 个 float，indices 每 3 个为一个三角形
+ * */
+inline void loadTestModel(const std::string &name, std::vector<float> &positions, std::vector<uint32_t> &indices)
+{
+    ObjMesh mesh;
+    parseObjFile(std::string(MODEL_DIR) + "/" + name, mesh);
+    positions = mesh.vertices;
+    indices.clear();
+    indices.reserve(mesh.indices.size());
+    for (const ObjIndex &index : mesh.indices)
+    {
+        indices.push_back(static_cast<uint32_t>(index.vertex_index));
+    }
+}
+
+#endif
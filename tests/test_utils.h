@@ -0,0 +1,43 @@
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+#include <iostream>
+#include <cstdint>
+
+/*
+    Introduction：
+    tests 目录下的测试都是不依赖 Vulkan 设备的独立可执行文件，由 ctest 运行，返回值非 0 表示失败。
+    EXPECT 失败时只输出位置与条件并计数，不中断测试，最后由 finishTests() 汇总。
+*/
+
+inline uint32_t &testFailureCount()
+{
+    static uint32_t failures = 0;
+    return failures;
+}
+
+#define EXPECT(condition)                                                                        \
+    do                                                                                           \
+    {                                                                                            \
+        if (!(condition))                                                                        \
+        {                                                                                        \
+            std::cout << __FILE__ << ":" << __LINE__ << ": expected " << #condition << std::endl; \
+            testFailureCount()++;                                                                \
+        }                                                                                        \
+    } while (0)
+
+/**
+ *  输出测试结果，返回 main() 的返回值
+ * */
+inline int finishTests(const char *name)
+{
+    if (testFailureCount() > 0)
+    {
+        std::cout << name << ": " << testFailureCount() << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << name << ": all tests passed" << std::endl;
+    return 0;
+}
+
+#endif